@@ -0,0 +1,711 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========================
+#include "Benchmark.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include "Core/Engine.h"
+#include "Core/Context.h"
+#include "Core/Timer.h"
+#include "Core/FileSystem.h"
+#include "Core/Stopwatch.h"
+#include "Core/TickGraph.h"
+#include "Input/Input.h"
+#include "Physics/Physics.h"
+#include "Profiling/Profiler.h"
+#include "RHI/RHI_SwapChain.h"
+#include "Rendering/Renderer.h"
+#include "Resource/ResourceCache.h"
+#include "Threading/Threading.h"
+#include "World/World.h"
+#include "World/Entity.h"
+#include "World/Components/Camera.h"
+#include "World/Components/Transform.h"
+//=====================================
+
+//= NAMESPACES ==============
+using namespace std;
+using namespace Genome;
+using namespace Genome::Math;
+//===========================
+
+namespace _Benchmark
+{
+    // The camera path is played back at a fixed rate, so every run renders the same frames no matter how fast they are
+    const float camera_path_step_sec = 1.0f / 60.0f;
+
+    inline float lerp(const float a, const float b, const float t) { return a + (b - a) * t; }
+
+    // Keeps the optimizer from removing the work a micro benchmark measures
+    volatile uint64_t sink = 0;
+
+    template <typename T>
+    double measure_lookup_ns(Context* context, const uint32_t count)
+    {
+        uint64_t sum = 0;
+        const auto start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            sum += reinterpret_cast<uint64_t>(context->GetSubsystem<T>());
+        }
+        const auto end = chrono::steady_clock::now();
+        sink = sink + sum;
+
+        return chrono::duration<double, nano>(end - start).count() / count;
+    }
+
+    void wait_for_world(World* world)
+    {
+        while (world->IsLoading())
+        {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+}
+
+Benchmark::~Benchmark()
+{
+    // The engine has to go before the window it renders to
+    m_engine.reset();
+}
+
+void Benchmark::OnWindowMessage(WindowData& window_data)
+{
+    // The first message creates the engine, the window is what the renderer presents to
+    if (!m_engine)
+    {
+        m_engine    = make_unique<Engine>(window_data);
+        m_context   = m_engine->GetContext();
+        m_renderer  = m_context->GetSubsystem<Renderer>();
+        m_profiler  = m_context->GetSubsystem<Profiler>();
+        return;
+    }
+
+    // Passing zero dimensions will cause the swapchain to not present at all.
+    // The window size doesn't affect the measurements, the render and output resolution are fixed in Start().
+    RHI_SwapChain* swapchain = m_renderer->GetSwapChain();
+    const uint32_t width     = static_cast<uint32_t>(window_data.minimise ? 0 : window_data.width);
+    const uint32_t height    = static_cast<uint32_t>(window_data.minimise ? 0 : window_data.height);
+    if (swapchain && (!swapchain->PresentEnabled() || swapchain->GetWidth() != width || swapchain->GetHeight() != height))
+    {
+        swapchain->Resize(width, height);
+    }
+
+    m_engine->SetWindowData(window_data);
+}
+
+bool Benchmark::OnTick()
+{
+    if (m_failed)
+        return false;
+
+    // Wait for the window to create the engine
+    if (!m_engine || !m_renderer || !m_renderer->IsInitialized())
+        return true;
+
+    if (!m_started)
+    {
+        m_started = true;
+        if (!Start())
+        {
+            m_failed = true;
+            return false;
+        }
+    }
+
+    if (m_options.mode == "world")
+        return TickWorld();
+
+    // The remaining modes run to completion in one go
+    if (m_options.mode == "load")
+    {
+        RunWorldLoad();
+    }
+    else if (m_options.mode == "jobs")
+    {
+        RunJobs();
+    }
+    else if (m_options.mode == "lookup")
+    {
+        RunLookup();
+    }
+    else if (m_options.mode == "entities")
+    {
+        RunEntities();
+    }
+
+    return false;
+}
+
+BenchmarkResult Benchmark::Finish()
+{
+    if (m_failed || m_results.GetFrameCount() == 0)
+    {
+        fprintf(stderr, "Benchmark failed, nothing was measured (see log.txt)\n");
+        return BenchmarkResult::Failed;
+    }
+
+    const string path_json          = m_options.output_path + ".json";
+    const string path_csv           = m_options.output_path + ".csv";
+    const string path_frames_csv    = m_options.output_path + "_frames.csv";
+    if (!m_results.SaveSummaryJson(path_json) || !m_results.SaveSummaryCsv(path_csv) || !m_results.SaveFramesCsv(path_frames_csv))
+    {
+        fprintf(stderr, "Failed to write the results to \"%s\"\n", m_options.output_path.c_str());
+        return BenchmarkResult::Failed;
+    }
+
+    // Summary
+    printf("%-48s %10s %10s %10s %10s\n", "metric", "mean", "p50", "p95", "p99");
+    for (const string& metric : m_results.GetMetrics())
+    {
+        const BenchmarkResults::Statistics statistics = m_results.GetStatistics(metric);
+        printf("%-48s %10.3f %10.3f %10.3f %10.3f\n", metric.c_str(), statistics.mean, statistics.p50, statistics.p95, statistics.p99);
+    }
+    printf("%u frames, results written to %s, %s and %s\n", m_results.GetFrameCount(), path_json.c_str(), path_csv.c_str(), path_frames_csv.c_str());
+
+    BenchmarkResult result = BenchmarkResult::Pass;
+
+    // Baseline
+    if (!m_options.baseline_path.empty())
+    {
+        map<string, BenchmarkResults::Statistics> baseline;
+        if (!BenchmarkResults::LoadBaseline(m_options.baseline_path, &baseline))
+        {
+            fprintf(stderr, "Failed to load the baseline \"%s\"\n", m_options.baseline_path.c_str());
+            return BenchmarkResult::Failed;
+        }
+
+        const vector<string> regressions = m_results.Compare(baseline, m_options.threshold_percent, m_options.noise_floor);
+        if (regressions.empty())
+        {
+            printf("No regressions against %s (threshold %.1f%%)\n", m_options.baseline_path.c_str(), m_options.threshold_percent);
+        }
+        else
+        {
+            fprintf(stderr, "%u regression(s) against %s (threshold %.1f%%):\n", static_cast<uint32_t>(regressions.size()), m_options.baseline_path.c_str(), m_options.threshold_percent);
+            for (const string& regression : regressions)
+            {
+                fprintf(stderr, "    %s\n", regression.c_str());
+            }
+
+            result = BenchmarkResult::Regressed;
+        }
+    }
+
+    // Steady state allocations, with where they were made
+    if (m_options.assert_no_allocations && m_allocating_frames != 0)
+    {
+        vector<pair<string, uint64_t>> blocks(m_allocating_blocks.begin(), m_allocating_blocks.end());
+        sort(blocks.begin(), blocks.end(), [](const pair<string, uint64_t>& a, const pair<string, uint64_t>& b) { return a.second > b.second; });
+
+        fprintf(stderr, "%u of %u measured frames allocated, allocations per time block (excluding its children):\n", m_allocating_frames, m_results.GetFrameCount());
+        for (const pair<string, uint64_t>& block : blocks)
+        {
+            fprintf(stderr, "    %-48s %llu\n", block.first.c_str(), static_cast<unsigned long long>(block.second));
+        }
+        fprintf(stderr, "    %-48s %llu\n", "(outside of time blocks)", static_cast<unsigned long long>(m_allocations_untracked));
+
+        result = BenchmarkResult::Regressed;
+    }
+
+    return result;
+}
+
+bool Benchmark::Start()
+{
+    // A fixed resolution, so that runs on different monitors are comparable
+    m_renderer->SetResolutionRender(m_options.width, m_options.height);
+    m_renderer->SetResolutionOutput(m_options.width, m_options.height);
+    m_renderer->SetViewport(static_cast<float>(m_options.width), static_cast<float>(m_options.height));
+
+    // Measure how fast frames can be, not how well they are paced
+    m_context->GetSubsystem<Timer>()->SetTargetFps(0.0);
+
+    if (m_options.mode == "world" || m_options.mode == "load")
+    {
+        if (!FileSystem::Exists(m_options.world_path))
+        {
+            fprintf(stderr, "The world \"%s\" doesn't exist\n", m_options.world_path.c_str());
+            return false;
+        }
+    }
+    else if (m_options.mode != "jobs" && m_options.mode != "lookup" && m_options.mode != "entities")
+    {
+        fprintf(stderr, "Unknown mode \"%s\"\n", m_options.mode.c_str());
+        return false;
+    }
+
+    if (m_options.mode == "world")
+    {
+        World* world = m_context->GetSubsystem<World>();
+        if (!world->LoadFromFile(m_options.world_path))
+        {
+            fprintf(stderr, "Failed to load the world \"%s\"\n", m_options.world_path.c_str());
+            return false;
+        }
+        _Benchmark::wait_for_world(world);
+
+        if (!m_options.camera_path.empty() && !LoadCameraPath(m_options.camera_path))
+            return false;
+
+        // Every frame is measured, not just the ones the profiler would otherwise present
+        m_profiler->SetEnabled(true);
+        m_profiler->SetUpdateInterval(0.0f);
+        m_profiler->SetTrackAllocations(m_options.track_allocations);
+    }
+
+    return true;
+}
+
+bool Benchmark::TickWorld()
+{
+    if (m_frame >= m_options.frames_warmup + m_options.frames)
+        return false;
+
+    UpdateCamera(m_frame < m_options.frames_warmup ? 0 : m_frame - m_options.frames_warmup);
+
+    m_engine->Tick();
+    m_renderer->Pass_CopyToBackbuffer(m_renderer->GetSwapChain()->GetCmdList());
+    m_renderer->Present();
+
+    if (m_frame >= m_options.frames_warmup)
+    {
+        RecordFrame();
+    }
+
+    m_frame++;
+    return true;
+}
+
+void Benchmark::RunWorldLoad()
+{
+    World* world        = m_context->GetSubsystem<World>();
+    const uint32_t runs = GetIterations(10);
+
+    for (uint32_t i = 0; i < runs; i++)
+    {
+        m_results.FrameBegin();
+
+        // Loading, including the resources it loads in the background
+        {
+            const Stopwatch stopwatch;
+            if (!world->LoadFromFile(m_options.world_path))
+            {
+                fprintf(stderr, "Failed to load the world \"%s\"\n", m_options.world_path.c_str());
+                m_failed = true;
+                return;
+            }
+            _Benchmark::wait_for_world(world);
+            m_results.Add("load/world", stopwatch.GetElapsedTimeMs());
+        }
+
+        // The first frame, which is where anything that was deferred during loading catches up
+        {
+            const Stopwatch stopwatch;
+            m_engine->Tick();
+            m_renderer->Pass_CopyToBackbuffer(m_renderer->GetSwapChain()->GetCmdList());
+            m_renderer->Present();
+            m_results.Add("load/first_frame", stopwatch.GetElapsedTimeMs());
+        }
+
+        m_results.FrameEnd();
+    }
+}
+
+void Benchmark::RunJobs()
+{
+    Threading* threading = m_context->GetSubsystem<Threading>();
+    const uint32_t runs  = GetIterations(100);
+
+    for (uint32_t i = 0; i < runs; i++)
+    {
+        m_results.FrameBegin();
+
+        // Scheduling and waiting on many small tasks
+        {
+            const uint32_t task_count = 10000;
+            atomic<uint32_t> executed = 0;
+            TaskCounter counter;
+
+            const Stopwatch stopwatch;
+            for (uint32_t task = 0; task < task_count; task++)
+            {
+                threading->AddTask([&executed]() { executed.fetch_add(1, memory_order_relaxed); }, &counter);
+            }
+            threading->Wait(counter);
+            m_results.Add("jobs/task_us", stopwatch.GetElapsedTimeMs() * 1000.0 / task_count);
+        }
+
+        // Splitting a loop across the workers
+        {
+            vector<float> values(1 << 20, 1.0f);
+
+            const Stopwatch stopwatch;
+            threading->ParallelFor(0, static_cast<uint32_t>(values.size()), 0, [&values](const uint32_t begin, const uint32_t end)
+            {
+                for (uint32_t index = begin; index < end; index++)
+                {
+                    values[index] = sqrt(values[index] * 2.0f);
+                }
+            });
+            m_results.Add("jobs/parallel_for_ms", stopwatch.GetElapsedTimeMs());
+        }
+
+        // The latency of a chain of continuations, every step waits for the previous one
+        {
+            const uint32_t chain_length = 100;
+
+            const Stopwatch stopwatch;
+            Future<uint32_t> future = threading->AddTask([]() { return 0u; });
+            for (uint32_t step = 0; step < chain_length; step++)
+            {
+                future = future.Then([](const uint32_t value) { return value + 1; });
+            }
+            _Benchmark::sink = _Benchmark::sink + future.Get();
+            m_results.Add("jobs/continuation_us", stopwatch.GetElapsedTimeMs() * 1000.0 / (chain_length + 1));
+        }
+
+        m_results.FrameEnd();
+    }
+}
+
+void Benchmark::RunLookup()
+{
+    const uint32_t runs         = GetIterations(100);
+    const uint32_t lookup_count = 100000;
+
+    for (uint32_t i = 0; i < runs; i++)
+    {
+        m_results.FrameBegin();
+        m_results.Add("lookup/timer_ns",            _Benchmark::measure_lookup_ns<Timer>(m_context, lookup_count));
+        m_results.Add("lookup/input_ns",            _Benchmark::measure_lookup_ns<Input>(m_context, lookup_count));
+        m_results.Add("lookup/threading_ns",        _Benchmark::measure_lookup_ns<Threading>(m_context, lookup_count));
+        m_results.Add("lookup/resource_cache_ns",   _Benchmark::measure_lookup_ns<ResourceCache>(m_context, lookup_count));
+        m_results.Add("lookup/world_ns",            _Benchmark::measure_lookup_ns<World>(m_context, lookup_count));
+        m_results.Add("lookup/physics_ns",          _Benchmark::measure_lookup_ns<Physics>(m_context, lookup_count));
+        m_results.Add("lookup/renderer_ns",         _Benchmark::measure_lookup_ns<Renderer>(m_context, lookup_count));
+        m_results.Add("lookup/profiler_ns",         _Benchmark::measure_lookup_ns<Profiler>(m_context, lookup_count));
+        m_results.FrameEnd();
+    }
+}
+
+void Benchmark::RunEntities()
+{
+    World* world                = m_context->GetSubsystem<World>();
+    const uint32_t runs         = GetIterations(5);
+    const uint32_t count        = m_options.entities;
+    const string file_path      = m_options.output_path + "_entities" + EXTENSION_WORLD;
+
+    // Generate a world which is shaped like imported models, roots with a few levels of children below them.
+    // Names repeat, every name is shared by two entities.
+    {
+        const uint32_t group_size   = 64;
+        const uint32_t branching    = 4;
+
+        world->New();
+        vector<Entity*> entities;
+        entities.reserve(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            Entity* entity = world->EntityCreate().get();
+            entity->SetName("Entity_" + to_string(i / 2));
+
+            const uint32_t index_in_group = i % group_size;
+            if (index_in_group != 0)
+            {
+                entity->GetTransform()->SetParent(entities[i - index_in_group + (index_in_group - 1) / branching]->GetTransform());
+            }
+
+            entities.emplace_back(entity);
+        }
+
+        if (!world->SaveToFile(file_path))
+        {
+            fprintf(stderr, "Failed to save the generated world \"%s\"\n", file_path.c_str());
+            m_failed = true;
+            return;
+        }
+    }
+
+    vector<uint32_t> ids;
+    vector<string> names;
+    for (uint32_t i = 0; i < runs; i++)
+    {
+        m_results.FrameBegin();
+
+        // Loading, which looks every parent up by id and links every child to it
+        {
+            const Stopwatch stopwatch;
+            if (!world->LoadFromFile(file_path))
+            {
+                fprintf(stderr, "Failed to load the generated world \"%s\"\n", file_path.c_str());
+                m_failed = true;
+                break;
+            }
+            _Benchmark::wait_for_world(world);
+            m_results.Add("entities/load", stopwatch.GetElapsedTimeMs());
+        }
+
+        // Roots, which the editor asks for every frame
+        {
+            const Stopwatch stopwatch;
+            _Benchmark::sink = _Benchmark::sink + world->EntityGetRoots().size();
+            m_results.Add("entities/get_roots_us", stopwatch.GetElapsedTimeMs() * 1000.0);
+        }
+
+        ids.clear();
+        names.clear();
+        for (const shared_ptr<Entity>& entity : world->EntityGetAll())
+        {
+            ids.emplace_back(entity->GetId());
+            names.emplace_back(entity->GetName());
+        }
+        const double lookup_count = static_cast<double>(ids.size() != 0 ? ids.size() : 1);
+
+        // Lookups, of every entity
+        {
+            uint64_t sum = 0;
+            const Stopwatch stopwatch;
+            for (const uint32_t id : ids)
+            {
+                sum += reinterpret_cast<uint64_t>(world->EntityGetById(id).get());
+            }
+            m_results.Add("entities/get_by_id_ns", stopwatch.GetElapsedTimeMs() * 1000000.0 / lookup_count);
+            _Benchmark::sink = _Benchmark::sink + sum;
+        }
+        {
+            uint64_t sum = 0;
+            const Stopwatch stopwatch;
+            for (const string& name : names)
+            {
+                sum += reinterpret_cast<uint64_t>(world->EntityGetByName(name).get());
+            }
+            m_results.Add("entities/get_by_name_ns", stopwatch.GetElapsedTimeMs() * 1000000.0 / lookup_count);
+            _Benchmark::sink = _Benchmark::sink + sum;
+        }
+
+        // Movement, every root moves a few times (like a script would) and then every matrix is read (like the renderer does)
+        {
+            const Stopwatch stopwatch;
+            for (uint32_t step = 1; step <= 3; step++)
+            {
+                for (const shared_ptr<Entity>& root : world->EntityGetRoots())
+                {
+                    root->GetTransform()->SetPositionLocal(Vector3(static_cast<float>(i), static_cast<float>(step), 0.0f));
+                }
+            }
+            float sum = 0.0f;
+            for (const shared_ptr<Entity>& entity : world->EntityGetAll())
+            {
+                sum += entity->GetTransform()->GetMatrix().m31;
+            }
+            m_results.Add("entities/move_roots_ms", stopwatch.GetElapsedTimeMs());
+            _Benchmark::sink = _Benchmark::sink + static_cast<uint64_t>(sum);
+        }
+
+        m_results.FrameEnd();
+    }
+
+    FileSystem::Delete(file_path);
+}
+
+void Benchmark::UpdateCamera(const uint32_t frame)
+{
+    if (m_camera_path.empty())
+        return;
+
+    shared_ptr<Camera> camera = m_renderer->GetCamera();
+    if (!camera)
+        return;
+
+    // Find the keys around the time, past the last key the camera stays there
+    const float time = frame * _Benchmark::camera_path_step_sec;
+    uint32_t index_b = 0;
+    while (index_b < m_camera_path.size() - 1 && m_camera_path[index_b].time <= time)
+    {
+        index_b++;
+    }
+    const uint32_t index_a = index_b != 0 ? index_b - 1 : 0;
+
+    const CameraKey& a  = m_camera_path[index_a];
+    const CameraKey& b  = m_camera_path[index_b];
+    float t             = b.time > a.time ? (time - a.time) / (b.time - a.time) : 0.0f;
+    t                   = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+
+    Transform* transform = camera->GetTransform();
+    transform->SetPosition(Vector3(
+        _Benchmark::lerp(a.position[0], b.position[0], t),
+        _Benchmark::lerp(a.position[1], b.position[1], t),
+        _Benchmark::lerp(a.position[2], b.position[2], t)
+    ));
+    transform->SetRotation(Quaternion::FromEulerAngles(
+        _Benchmark::lerp(a.rotation[0], b.rotation[0], t),
+        _Benchmark::lerp(a.rotation[1], b.rotation[1], t),
+        _Benchmark::lerp(a.rotation[2], b.rotation[2], t)
+    ));
+}
+
+void Benchmark::RecordFrame()
+{
+    m_results.FrameBegin();
+
+    m_results.Add("frame", m_profiler->GetTimeFrameLast());
+    m_results.Add("cpu", m_profiler->GetTimeCpuLast());
+    m_results.Add("gpu", m_profiler->GetTimeGpuLast());
+
+    // Subsystem ticks
+    for (const TickType tick_type : { TickType::Variable, TickType::Smoothed })
+    {
+        for (const TickNode& node : m_profiler->GetTickGraph(tick_type).GetNodes())
+        {
+            m_results.Add("tick/" + node.name, node.time_end_ms - node.time_start_ms);
+        }
+    }
+
+    // Render passes and everything else which is timed, per thread the time of a block name is summed
+    for (const TimeBlock& time_block : m_profiler->GetTimeBlocks())
+    {
+        if (!time_block.IsComplete())
+            continue;
+
+        const char* prefix = time_block.GetType() == TimeBlockType::Gpu ? "gpu/" : "cpu/";
+        m_results.Add(prefix + string(time_block.GetName()), time_block.GetDuration());
+    }
+
+    // Published metrics, histograms are polled every frame here so their percentiles are of the frame
+    for (const MetricValue& metric : m_profiler->GetMetricValues())
+    {
+        if (metric.type != MetricType::Histogram)
+        {
+            m_results.Add("metric/" + metric.name, metric.value);
+        }
+        else if (metric.count != 0)
+        {
+            m_results.Add("metric/" + metric.name + "/p50", metric.p50);
+            m_results.Add("metric/" + metric.name + "/p99", metric.p99);
+        }
+    }
+
+    if (m_options.track_allocations)
+    {
+        RecordAllocations();
+    }
+
+    m_results.FrameEnd();
+}
+
+void Benchmark::RecordAllocations()
+{
+    const AllocationCount& allocations = m_profiler->GetAllocationsLast();
+    m_results.Add("allocations", static_cast<double>(allocations.count));
+    m_results.Add("allocations_kb", allocations.bytes / 1024.0);
+
+    if (allocations.count == 0)
+        return;
+
+    m_allocating_frames++;
+
+    // A block's allocations include the ones of its children, subtract those to find where they were made
+    const vector<TimeBlock>& time_blocks = m_profiler->GetTimeBlocks();
+    vector<uint64_t> exclusive(time_blocks.size(), 0);
+    uint64_t attributed = 0;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(time_blocks.size()); i++)
+    {
+        const TimeBlock& time_block = time_blocks[i];
+        if (time_block.GetType() != TimeBlockType::Cpu || !time_block.IsComplete())
+            continue;
+
+        const uint64_t count = time_block.GetAllocations().count;
+        exclusive[i] += count;
+
+        const TimeBlock* parent = time_block.GetParent();
+        if (parent && parent->IsComplete())
+        {
+            exclusive[parent - time_blocks.data()] -= count;
+        }
+        else if (!parent)
+        {
+            attributed += count;
+        }
+    }
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(time_blocks.size()); i++)
+    {
+        if (exclusive[i] != 0)
+        {
+            m_allocating_blocks[time_blocks[i].GetName()] += exclusive[i];
+        }
+    }
+
+    // The frame's total is of every thread, so whatever no block accounts for was allocated outside of one
+    m_allocations_untracked += allocations.count > attributed ? allocations.count - attributed : 0;
+}
+
+bool Benchmark::LoadCameraPath(const string& file_path)
+{
+    // A key per line: time x y z pitch yaw roll, lines which start with # are comments
+    ifstream file(file_path);
+    if (!file.is_open())
+    {
+        fprintf(stderr, "Failed to open the camera path \"%s\"\n", file_path.c_str());
+        return false;
+    }
+
+    m_camera_path.clear();
+    string line;
+    uint32_t line_number = 0;
+    while (getline(file, line))
+    {
+        line_number++;
+        if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == string::npos)
+            continue;
+
+        CameraKey key;
+        istringstream stream(line);
+        if (!(stream >> key.time >> key.position[0] >> key.position[1] >> key.position[2] >> key.rotation[0] >> key.rotation[1] >> key.rotation[2]))
+        {
+            fprintf(stderr, "%s(%u): expected \"time x y z pitch yaw roll\"\n", file_path.c_str(), line_number);
+            return false;
+        }
+
+        if (!m_camera_path.empty() && key.time < m_camera_path.back().time)
+        {
+            fprintf(stderr, "%s(%u): the keys must be in time order\n", file_path.c_str(), line_number);
+            return false;
+        }
+
+        m_camera_path.emplace_back(key);
+    }
+
+    if (m_camera_path.empty())
+    {
+        fprintf(stderr, "The camera path \"%s\" has no keys\n", file_path.c_str());
+        return false;
+    }
+
+    return true;
+}
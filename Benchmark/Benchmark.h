@@ -0,0 +1,121 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ================
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BenchmarkResults.h"
+//===========================
+
+//= FORWARD DECLARATIONS =
+namespace Genome
+{
+    class Context;
+    class Engine;
+    class Renderer;
+    class Profiler;
+    struct WindowData;
+}
+//========================
+
+struct BenchmarkOptions
+{
+    std::string mode            = "world";      // world, load, jobs, lookup or entities
+    std::string world_path;                     // world and load
+    std::string camera_path;                    // world, optional
+    std::string output_path     = "benchmark";  // the results are written to <output_path>.json, <output_path>.csv and <output_path>_frames.csv
+    std::string baseline_path;                  // a <output_path>.json of an earlier run
+    uint32_t frames             = 600;          // measured
+    uint32_t frames_warmup      = 60;           // ticked before measuring, so that caches, shaders and the frame pacing settle
+    uint32_t iterations         = 0;            // load, jobs, lookup and entities, 0 picks a default for the mode
+    uint32_t entities           = 100000;       // entities, the size of the generated world
+    uint32_t width              = 1920;
+    uint32_t height             = 1080;
+    float threshold_percent     = 10.0f;        // how much worse than the baseline a metric can get
+    float noise_floor           = 0.05f;        // metrics below this (in the baseline) are too small to compare
+    bool track_allocations      = false;        // world, records the heap allocations of every frame
+    bool assert_no_allocations  = false;        // world, fails if a measured frame allocates (implies track_allocations)
+};
+
+// Exit codes
+enum class BenchmarkResult : int
+{
+    Pass        = 0,
+    Regressed   = 1,
+    Failed      = 2
+};
+
+// Runs the engine without the editor and measures it
+class Benchmark
+{
+public:
+    Benchmark(const BenchmarkOptions& options) : m_options(options) {}
+    ~Benchmark();
+
+    void OnWindowMessage(Genome::WindowData& window_data);
+
+    // Returns false once the benchmark is done (or failed)
+    bool OnTick();
+
+    // Writes the results out and compares them against the baseline
+    BenchmarkResult Finish();
+
+private:
+    bool Start();
+    bool TickWorld();
+    void RunWorldLoad();
+    void RunJobs();
+    void RunLookup();
+    void RunEntities();
+    void UpdateCamera(uint32_t frame);
+    void RecordFrame();
+    void RecordAllocations();
+    bool LoadCameraPath(const std::string& file_path);
+    uint32_t GetIterations(uint32_t default_count) const { return m_options.iterations != 0 ? m_options.iterations : default_count; }
+
+    // A camera key, the path is interpolated between them
+    struct CameraKey
+    {
+        float time = 0.0f;
+        float position[3] = {};
+        float rotation[3] = {}; // euler angles, in degrees
+    };
+
+    BenchmarkOptions m_options;
+    BenchmarkResults m_results;
+    std::vector<CameraKey> m_camera_path;
+    std::map<std::string, uint64_t> m_allocating_blocks; // allocations per time block name (excluding children), over all measured frames
+    uint64_t m_allocations_untracked = 0;               // allocations outside of any time block
+    uint32_t m_allocating_frames     = 0;
+    uint32_t m_frame    = 0;
+    bool m_started      = false;
+    bool m_failed       = false;
+
+    // Engine
+    std::unique_ptr<Genome::Engine> m_engine;
+    Genome::Context* m_context      = nullptr;
+    Genome::Renderer* m_renderer    = nullptr;
+    Genome::Profiler* m_profiler    = nullptr;
+};
@@ -0,0 +1,264 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ================
+#include "BenchmarkResults.h"
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+//===========================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace _BenchmarkResults
+{
+    const double nan = numeric_limits<double>::quiet_NaN();
+
+    // Nearest rank, of sorted samples
+    double percentile(const vector<double>& samples, const double percent)
+    {
+        if (samples.empty())
+            return 0.0;
+
+        const size_t rank = static_cast<size_t>(ceil(percent / 100.0 * samples.size()));
+        return samples[min(max(rank, static_cast<size_t>(1)), samples.size()) - 1];
+    }
+
+    bool read_value(const string& line, const char* key, double* value)
+    {
+        const size_t position = line.find(key);
+        if (position == string::npos)
+            return false;
+
+        *value = strtod(line.c_str() + position + strlen(key), nullptr);
+        return true;
+    }
+}
+
+void BenchmarkResults::FrameBegin()
+{
+    m_frame.assign(m_metrics.size(), _BenchmarkResults::nan);
+    m_frame_begun = true;
+}
+
+void BenchmarkResults::Add(const string& metric, const double value)
+{
+    if (!m_frame_begun)
+        return;
+
+    auto it = m_metric_indices.find(metric);
+    if (it == m_metric_indices.end())
+    {
+        it = m_metric_indices.emplace(metric, static_cast<uint32_t>(m_metrics.size())).first;
+        m_metrics.emplace_back(metric);
+        m_frame.emplace_back(_BenchmarkResults::nan);
+    }
+
+    double& sample = m_frame[it->second];
+    sample = isnan(sample) ? value : sample + value;
+}
+
+void BenchmarkResults::FrameEnd()
+{
+    if (!m_frame_begun)
+        return;
+
+    m_frames.emplace_back(move(m_frame));
+    m_frame_begun = false;
+}
+
+BenchmarkResults::Statistics BenchmarkResults::GetStatistics(const string& metric) const
+{
+    Statistics statistics;
+
+    const auto it = m_metric_indices.find(metric);
+    if (it == m_metric_indices.end())
+        return statistics;
+
+    vector<double> samples;
+    samples.reserve(m_frames.size());
+    for (const vector<double>& frame : m_frames)
+    {
+        if (it->second < frame.size() && !isnan(frame[it->second]))
+        {
+            samples.emplace_back(frame[it->second]);
+        }
+    }
+
+    if (samples.empty())
+        return statistics;
+
+    sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (const double sample : samples)
+    {
+        sum += sample;
+    }
+
+    statistics.samples  = static_cast<uint32_t>(samples.size());
+    statistics.mean     = sum / samples.size();
+    statistics.p50      = _BenchmarkResults::percentile(samples, 50.0);
+    statistics.p95      = _BenchmarkResults::percentile(samples, 95.0);
+    statistics.p99      = _BenchmarkResults::percentile(samples, 99.0);
+    statistics.max      = samples.back();
+
+    return statistics;
+}
+
+bool BenchmarkResults::SaveFramesCsv(const string& file_path) const
+{
+    ofstream fout(file_path, ofstream::out | ofstream::trunc);
+    if (!fout.is_open())
+        return false;
+
+    fout << "index";
+    for (const string& metric : m_metrics)
+    {
+        fout << "," << metric;
+    }
+    fout << "\n";
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_frames.size()); i++)
+    {
+        fout << i;
+        for (uint32_t j = 0; j < static_cast<uint32_t>(m_metrics.size()); j++)
+        {
+            fout << ",";
+            if (j < m_frames[i].size() && !isnan(m_frames[i][j]))
+            {
+                fout << m_frames[i][j];
+            }
+        }
+        fout << "\n";
+    }
+
+    return true;
+}
+
+bool BenchmarkResults::SaveSummaryCsv(const string& file_path) const
+{
+    ofstream fout(file_path, ofstream::out | ofstream::trunc);
+    if (!fout.is_open())
+        return false;
+
+    fout << "metric,samples,mean,p50,p95,p99,max\n";
+    for (const string& metric : m_metrics)
+    {
+        const Statistics statistics = GetStatistics(metric);
+        fout << metric << "," << statistics.samples << "," << statistics.mean << "," << statistics.p50 << "," << statistics.p95 << "," << statistics.p99 << "," << statistics.max << "\n";
+    }
+
+    return true;
+}
+
+bool BenchmarkResults::SaveSummaryJson(const string& file_path) const
+{
+    ofstream fout(file_path, ofstream::out | ofstream::trunc);
+    if (!fout.is_open())
+        return false;
+
+    // One metric per line, which is what LoadBaseline() expects
+    fout << "{\n    \"frames\": " << m_frames.size() << ",\n    \"metrics\":\n    {\n";
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_metrics.size()); i++)
+    {
+        const Statistics statistics = GetStatistics(m_metrics[i]);
+        fout << "        \"" << m_metrics[i] << "\": { "
+             << "\"samples\": " << statistics.samples << ", "
+             << "\"mean\": "    << statistics.mean    << ", "
+             << "\"p50\": "     << statistics.p50     << ", "
+             << "\"p95\": "     << statistics.p95     << ", "
+             << "\"p99\": "     << statistics.p99     << ", "
+             << "\"max\": "     << statistics.max     << " }"
+             << (i + 1 < m_metrics.size() ? ",\n" : "\n");
+    }
+    fout << "    }\n}\n";
+
+    return true;
+}
+
+bool BenchmarkResults::LoadBaseline(const string& file_path, map<string, Statistics>* baseline)
+{
+    ifstream fin(file_path);
+    if (!fin.is_open())
+        return false;
+
+    string line;
+    while (getline(fin, line))
+    {
+        // "name": { "samples": ..., "p50": ..., ... }
+        const size_t name_start = line.find('"');
+        const size_t name_end   = name_start != string::npos ? line.find('"', name_start + 1) : string::npos;
+        if (name_end == string::npos || line.find('{', name_end) == string::npos)
+            continue;
+
+        Statistics statistics;
+        double samples = 0.0;
+        if (!_BenchmarkResults::read_value(line, "\"p50\":", &statistics.p50) || !_BenchmarkResults::read_value(line, "\"p95\":", &statistics.p95))
+            continue;
+
+        _BenchmarkResults::read_value(line, "\"samples\":", &samples);
+        _BenchmarkResults::read_value(line, "\"mean\":", &statistics.mean);
+        _BenchmarkResults::read_value(line, "\"p99\":", &statistics.p99);
+        _BenchmarkResults::read_value(line, "\"max\":", &statistics.max);
+        statistics.samples = static_cast<uint32_t>(samples);
+
+        (*baseline)[line.substr(name_start + 1, name_end - name_start - 1)] = statistics;
+    }
+
+    return true;
+}
+
+vector<string> BenchmarkResults::Compare(const map<string, Statistics>& baseline, const float threshold_percent, const float noise_floor) const
+{
+    vector<string> regressions;
+    const double factor = 1.0 + threshold_percent / 100.0;
+
+    for (const string& metric : m_metrics)
+    {
+        const auto it = baseline.find(metric);
+        if (it == baseline.end())
+            continue;
+
+        const Statistics& before    = it->second;
+        const Statistics after      = GetStatistics(metric);
+
+        const auto check = [&](const char* name, const double value_before, const double value_after)
+        {
+            if (value_before < noise_floor || value_after <= value_before * factor)
+                return;
+
+            ostringstream line;
+            line << metric << " " << name << ": " << value_before << " -> " << value_after << " (+" << ((value_after / value_before) - 1.0) * 100.0 << "%)";
+            regressions.emplace_back(line.str());
+        };
+
+        check("p50", before.p50, after.p50);
+        check("p95", before.p95, after.p95);
+    }
+
+    return regressions;
+}
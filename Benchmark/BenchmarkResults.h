@@ -0,0 +1,73 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ===========
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+//======================
+
+// Per-frame samples of named metrics, and their statistics
+class BenchmarkResults
+{
+public:
+    struct Statistics
+    {
+        uint32_t samples    = 0;
+        double mean         = 0.0;
+        double p50          = 0.0;
+        double p95          = 0.0;
+        double p99          = 0.0;
+        double max          = 0.0;
+    };
+
+    // A frame is a row of samples, a metric which is added more than once during a frame is summed (e.g. a pass which runs per light)
+    void FrameBegin();
+    void Add(const std::string& metric, double value);
+    void FrameEnd();
+
+    Statistics GetStatistics(const std::string& metric) const;
+    const std::vector<std::string>& GetMetrics() const { return m_metrics; }
+    uint32_t GetFrameCount()                     const { return static_cast<uint32_t>(m_frames.size()); }
+
+    // Every frame, one column per metric
+    bool SaveFramesCsv(const std::string& file_path) const;
+    // The statistics of every metric, the JSON is also what a later run compares against
+    bool SaveSummaryCsv(const std::string& file_path) const;
+    bool SaveSummaryJson(const std::string& file_path) const;
+
+    // Reads the statistics a previous run saved with SaveSummaryJson()
+    static bool LoadBaseline(const std::string& file_path, std::map<std::string, Statistics>* baseline);
+
+    // Returns a line per metric whose p50 or p95 is more than threshold_percent worse than the baseline's.
+    // Metrics which are below noise_floor in the baseline are too small to compare and are skipped.
+    std::vector<std::string> Compare(const std::map<std::string, Statistics>& baseline, float threshold_percent, float noise_floor) const;
+
+private:
+    std::vector<std::string> m_metrics;
+    std::unordered_map<std::string, uint32_t> m_metric_indices;
+    std::vector<std::vector<double>> m_frames; // a sample per metric, NaN if the metric wasn't added during the frame
+    std::vector<double> m_frame;
+    bool m_frame_begun = false;
+};
@@ -0,0 +1,136 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ============================================
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include "Window.h"
+#include "Benchmark.h"
+#include "Profiling/AllocationTracker_Operators.h"
+//=======================================================
+
+namespace _main
+{
+    void print_usage()
+    {
+        printf(
+            "Usage: benchmark [options]\n"
+            "  --mode <mode>                    what to measure, world, load, jobs, lookup or entities (default: world)\n"
+            "  --world <path>                   the world to render (world) or load (load)\n"
+            "  --camera <path>                  a camera path to play back, a \"time x y z pitch yaw roll\" key per line\n"
+            "  --frames <count>                 frames to measure (default: 600)\n"
+            "  --warmup <count>                 frames to tick before measuring (default: 60)\n"
+            "  --iterations <count>             repetitions of the load, jobs, lookup and entities modes\n"
+            "  --entities <count>               the size of the world the entities mode generates (default: 100000)\n"
+            "  --width <pixels>                 render resolution (default: 1920)\n"
+            "  --height <pixels>                render resolution (default: 1080)\n"
+            "  --out <path>                     writes <path>.json, <path>.csv and <path>_frames.csv (default: benchmark)\n"
+            "  --baseline <path>                a .json of an earlier run to compare against\n"
+            "  --threshold <percent>            how much worse than the baseline a p50 or p95 can get (default: 10)\n"
+            "  --noise-floor <value>            baseline values below this are ignored (default: 0.05)\n"
+            "  --allocations <track|assert>     record the heap allocations of every frame, assert also fails the run if any are made\n"
+            "Exit code: 0 pass, 1 regressed, 2 failed\n"
+        );
+    }
+
+    bool parse_arguments(const int argc, char** argv, BenchmarkOptions* options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const char* argument = argv[i];
+            if (i + 1 >= argc)
+            {
+                fprintf(stderr, "Missing value for %s\n", argument);
+                return false;
+            }
+            const char* value = argv[++i];
+
+            if      (strcmp(argument, "--mode") == 0)        options->mode              = value;
+            else if (strcmp(argument, "--world") == 0)       options->world_path        = value;
+            else if (strcmp(argument, "--camera") == 0)      options->camera_path       = value;
+            else if (strcmp(argument, "--frames") == 0)      options->frames            = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            else if (strcmp(argument, "--warmup") == 0)      options->frames_warmup     = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            else if (strcmp(argument, "--iterations") == 0)  options->iterations        = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            else if (strcmp(argument, "--entities") == 0)    options->entities          = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            else if (strcmp(argument, "--width") == 0)       options->width             = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            else if (strcmp(argument, "--height") == 0)      options->height            = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            else if (strcmp(argument, "--out") == 0)         options->output_path       = value;
+            else if (strcmp(argument, "--baseline") == 0)    options->baseline_path     = value;
+            else if (strcmp(argument, "--threshold") == 0)   options->threshold_percent = static_cast<float>(atof(value));
+            else if (strcmp(argument, "--noise-floor") == 0) options->noise_floor       = static_cast<float>(atof(value));
+            else if (strcmp(argument, "--allocations") == 0)
+            {
+                options->assert_no_allocations  = strcmp(value, "assert") == 0;
+                options->track_allocations      = strcmp(value, "track") == 0 || options->assert_no_allocations;
+                if (!options->track_allocations)
+                {
+                    fprintf(stderr, "Unknown value %s for %s\n", value, argument);
+                    return false;
+                }
+            }
+            else
+            {
+                fprintf(stderr, "Unknown option %s\n", argument);
+                return false;
+            }
+        }
+
+        if (options->frames == 0 || options->width == 0 || options->height == 0)
+        {
+            fprintf(stderr, "The frame count and resolution must be greater than zero\n");
+            return false;
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkOptions options;
+    if (!_main::parse_arguments(argc, argv, &options))
+    {
+        _main::print_usage();
+        return static_cast<int>(BenchmarkResult::Failed);
+    }
+
+    // The renderer presents to a window, even though nothing is interactive
+    if (!Window::Create(GetModuleHandle(nullptr), "Genome Benchmark"))
+        return static_cast<int>(BenchmarkResult::Failed);
+    Window::Show();
+
+    BenchmarkResult result = BenchmarkResult::Failed;
+    {
+        Benchmark benchmark(options);
+        Window::g_on_message = [&benchmark](Genome::WindowData& window_data) { benchmark.OnWindowMessage(window_data); };
+
+        // Tick
+        while (Window::Tick() && benchmark.OnTick()) {}
+
+        result = benchmark.Finish();
+        Window::g_on_message = nullptr;
+    }
+
+    // Exit
+    Window::Destroy();
+    return static_cast<int>(result);
+}
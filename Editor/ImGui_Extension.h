@@ -45,10 +45,7 @@ public:
         auto resource_cache = g_resource_cache;
 
         // Load the model asynchronously
-        g_threading->AddTask([resource_cache, file_path]()
-            {
-                resource_cache->Load<Model>(file_path);
-            });
+        resource_cache->LoadAsync<Model>(file_path);
     }
 
     void LoadWorld(const std::string& file_path) const
@@ -58,11 +55,11 @@ public:
         // Loading a world resets everything so it's important to ensure that no tasks are running
         g_threading->Flush(true);
 
-        // Load the scene asynchronously
+        // Load the scene asynchronously, the task returns once the loading has started
         g_threading->AddTask([world, file_path]()
             {
-                world->LoadFromFile(file_path);
-            });
+                world->LoadFromFileAsync(file_path);
+            }, Task_Lane::Io);
     }
 
     void SaveWorld(const std::string& file_path) const
@@ -73,7 +70,7 @@ public:
         g_threading->AddTask([world, file_path]()
             {
                 world->SaveToFile(file_path);
-            });
+            }, Task_Lane::Io);
     }
 
     void PickEntity()
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Math/Vector3.h"
 #include "Core/Context.h"
 #include "Math/Vector2.h"
+#include "Input/Input.h"
 //==========================
 
 //= NAMESPACES =========
@@ -38,6 +39,7 @@ Widget_Profiler::Widget_Profiler(Editor* editor) : Widget(editor)
     m_title         = "Profiler";
     m_is_visible    = false;
     m_profiler      = m_context->GetSubsystem<Profiler>();
+    m_input         = m_context->GetSubsystem<Input>();
     m_size          = Vector2(1000, 715);
 }
 
@@ -51,6 +53,15 @@ void Widget_Profiler::OnHide()
     m_profiler->SetEnabled(false);
 }
 
+void Widget_Profiler::TickAlways()
+{
+    // F12 captures a trace, whether the profiler is visible or not
+    if (m_input->GetKeyDown(KeyCode::F12))
+    {
+        m_profiler->CaptureTrace();
+    }
+}
+
 static void ShowTimeBlock(const TimeBlock& time_block, float total_time)
 {
     if (!time_block.IsComplete())
@@ -71,7 +82,139 @@ static void ShowTimeBlock(const TimeBlock& time_block, float total_time)
     ImGui::GetWindowDrawList()->AddRectFilled(pos_screen, ImVec2(pos_screen.x + width, pos_screen.y + text_height), IM_COL32(color.x * 255, color.y * 255, color.z * 255, 255));
     // Text
     ImGui::SetCursorPos(ImVec2(pos.x + m_tree_depth_stride * time_block.GetTreeDepth(), pos.y));
-    ImGui::Text("%s - %.2f ms", name, duration);
+    const AllocationCount& allocations = time_block.GetAllocations();
+    if (allocations.count != 0)
+    {
+        ImGui::Text("%s - %.2f ms - %llu allocations, %.1f KB", name, duration, static_cast<unsigned long long>(allocations.count), allocations.bytes / 1024.0f);
+    }
+    else
+    {
+        ImGui::Text("%s - %.2f ms", name, duration);
+    }
+}
+
+static void ShowTickGraph(const TickGraph& tick_graph, const char* title)
+{
+    const float duration = tick_graph.GetDurationMs();
+    ImGui::Text("%s - %.2f ms (critical path: %.2f ms)", title, duration, tick_graph.GetCriticalPathMs());
+
+    if (duration <= 0.0f)
+        return;
+
+    const float width_max       = ImGui::GetWindowContentRegionWidth();
+    const auto& color           = ImGui::GetStyle().Colors[ImGuiCol_FrameBgActive];
+    const ImU32 color_critical  = IM_COL32(220, 80, 60, 255);
+
+    for (const TickNode& node : tick_graph.GetNodes())
+    {
+        const float duration_node   = node.time_end_ms - node.time_start_ms;
+        const ImVec2 pos_screen     = ImGui::GetCursorScreenPos();
+        const float text_height     = ImGui::GetTextLineHeight();
+        const float offset          = (node.time_start_ms / duration) * width_max;
+        const float width           = Math::Max((duration_node / duration) * width_max, 1.0f);
+
+        // Rectangle, positioned where the subsystem started ticking within the group
+        ImGui::GetWindowDrawList()->AddRectFilled(
+            ImVec2(pos_screen.x + offset, pos_screen.y),
+            ImVec2(pos_screen.x + offset + width, pos_screen.y + text_height),
+            node.is_critical ? color_critical : IM_COL32(color.x * 255, color.y * 255, color.z * 255, 255)
+        );
+        // Text
+        ImGui::Text("%s - %.2f ms [%s]", node.name.c_str(), duration_node, node.thread_name.c_str());
+    }
+}
+
+static void ShowThreadMetrics(const Profiler* profiler)
+{
+    const float width_max       = ImGui::GetWindowContentRegionWidth();
+    const auto& color           = ImGui::GetStyle().Colors[ImGuiCol_FrameBgActive];
+    const ImU32 color_asleep    = IM_COL32(90, 90, 90, 255);
+
+    // Utilization, busy followed by asleep, the gap is time spent looking for work
+    for (const ThreadMetrics& metrics : profiler->GetThreadMetrics())
+    {
+        const ImVec2 pos_screen = ImGui::GetCursorScreenPos();
+        const float text_height = ImGui::GetTextLineHeight();
+        const float width_busy  = metrics.busy * width_max;
+        const float width_sleep = metrics.asleep * width_max;
+
+        ImGui::GetWindowDrawList()->AddRectFilled(pos_screen, ImVec2(pos_screen.x + width_busy, pos_screen.y + text_height), IM_COL32(color.x * 255, color.y * 255, color.z * 255, 255));
+        ImGui::GetWindowDrawList()->AddRectFilled(ImVec2(pos_screen.x + width_busy, pos_screen.y), ImVec2(pos_screen.x + width_busy + width_sleep, pos_screen.y + text_height), color_asleep);
+        ImGui::Text("%s - busy: %.0f%%, asleep: %.0f%%, tasks: %llu, stolen: %llu, sleeps: %llu",
+            metrics.name.c_str(),
+            metrics.busy * 100.0f,
+            metrics.asleep * 100.0f,
+            static_cast<unsigned long long>(metrics.tasks_executed),
+            static_cast<unsigned long long>(metrics.tasks_stolen),
+            static_cast<unsigned long long>(metrics.sleeps)
+        );
+    }
+
+    ImGui::Separator();
+
+    // Queue latency and peak depth, per lane
+    static const char* lane_names[] = { "High", "Normal", "Background", "I/O" };
+    for (uint32_t lane = 0; lane < static_cast<uint32_t>(Task_Lane::Count); lane++)
+    {
+        const QueueLatencyHistogram& histogram = profiler->GetQueueLatency(static_cast<Task_Lane>(lane));
+
+        array<float, queue_latency_bucket_count> values;
+        uint64_t task_count = 0;
+        for (uint32_t i = 0; i < queue_latency_bucket_count; i++)
+        {
+            values[i]   = static_cast<float>(histogram[i]);
+            task_count += histogram[i];
+        }
+
+        ImGui::Text("%s - tasks: %llu, peak queue depth: %d", lane_names[lane], static_cast<unsigned long long>(task_count), profiler->GetQueueDepthPeak(static_cast<Task_Lane>(lane)));
+        ImGui::PushID(lane);
+        ImGui::PlotHistogram("", values.data(), static_cast<int>(values.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(width_max, 40));
+        ImGui::PopID();
+    }
+    ImGui::Text("Queue latency, buckets double from < 1 us (left) to >= 16 ms (right)");
+}
+
+static void ShowMetrics(const Profiler* profiler)
+{
+    const vector<MetricValue>& metrics = profiler->GetMetricValues();
+
+    // Counters, during the last frame
+    for (const MetricValue& metric : metrics)
+    {
+        if (metric.type == MetricType::Counter)
+        {
+            ImGui::Text("%s - %.0f%s%s (total: %lld)", metric.name.c_str(), metric.value, metric.unit.empty() ? "" : " ", metric.unit.c_str(), static_cast<long long>(metric.total));
+        }
+    }
+    ImGui::Separator();
+
+    // Gauges, as last set
+    for (const MetricValue& metric : metrics)
+    {
+        if (metric.type == MetricType::Gauge)
+        {
+            ImGui::Text("%s - %.2f%s%s", metric.name.c_str(), metric.value, metric.unit.empty() ? "" : " ", metric.unit.c_str());
+        }
+    }
+    ImGui::Separator();
+
+    // Histograms, over the last update interval
+    for (const MetricValue& metric : metrics)
+    {
+        if (metric.type == MetricType::Histogram)
+        {
+            const char* unit = metric.unit.c_str();
+            ImGui::Text("%s - count: %llu, mean: %.2f %s, p50: %.2f %s, p95: %.2f %s, p99: %.2f %s, max: %.2f %s",
+                metric.name.c_str(),
+                static_cast<unsigned long long>(metric.count),
+                metric.value, unit,
+                metric.p50, unit,
+                metric.p95, unit,
+                metric.p99, unit,
+                metric.max, unit
+            );
+        }
+    }
 }
 
 void Widget_Profiler::TickVisible()
@@ -82,22 +225,87 @@ void Widget_Profiler::TickVisible()
     ImGui::SameLine();
     ImGui::RadioButton("GPU", &m_item_type, 1);
     ImGui::SameLine();
+    ImGui::RadioButton("Subsystems", &m_item_type, 2);
+    ImGui::SameLine();
+    ImGui::RadioButton("Threads", &m_item_type, 3);
+    ImGui::SameLine();
+    ImGui::RadioButton("Metrics", &m_item_type, 4);
+    ImGui::SameLine();
+    if (m_profiler->IsCapturingTrace())
+    {
+        ImGui::Text("Capturing...");
+    }
+    else if (ImGui::Button("Capture trace (F12)"))
+    {
+        m_profiler->CaptureTrace();
+    }
+    ImGui::SameLine();
+    bool track_allocations = m_profiler->GetTrackAllocations();
+    if (ImGui::Checkbox("Track allocations", &track_allocations))
+    {
+        m_profiler->SetTrackAllocations(track_allocations);
+    }
+    ImGui::SameLine();
+    bool capture_hitches = m_profiler->IsCapturingHitches();
+    if (ImGui::Checkbox("Capture hitches", &capture_hitches))
+    {
+        m_profiler->SetHitchCapture(capture_hitches);
+    }
+    ImGui::SameLine();
     float interval = m_profiler->GetUpdateInterval();
     ImGui::DragFloat("Update interval (The smaller the interval the higher the performance impact)", &interval, 0.001f, 0.0f, 0.5f);
     m_profiler->SetUpdateInterval(interval);
     ImGui::Separator();
 
+    // Subsystem ticks, red marks the critical path
+    if (m_item_type == 2)
+    {
+        ShowTickGraph(m_profiler->GetTickGraph(TickType::Variable), "Variable");
+        ImGui::Separator();
+        ShowTickGraph(m_profiler->GetTickGraph(TickType::Smoothed), "Smoothed");
+        return;
+    }
+
+    // Thread pool utilization and queues
+    if (m_item_type == 3)
+    {
+        ShowThreadMetrics(m_profiler);
+        return;
+    }
+
+    // Counters, gauges and histograms which the subsystems publish
+    if (m_item_type == 4)
+    {
+        ShowMetrics(m_profiler);
+        return;
+    }
+
     TimeBlockType type                          = m_item_type == 0 ? TimeBlockType::Cpu : TimeBlockType::Gpu;
     const std::vector<TimeBlock>& time_blocks   = m_profiler->GetTimeBlocks();
     const uint32_t time_block_count             = static_cast<uint32_t>(time_blocks.size());
     float time_last                             = type == TimeBlockType::Cpu ? m_profiler->GetTimeCpuLast() : m_profiler->GetTimeGpuLast();
 
-    // Time blocks
+    // Heap allocations, per block they are of the thread which recorded it (and include the block's children)
+    if (type == TimeBlockType::Cpu && m_profiler->GetTrackAllocations())
+    {
+        const AllocationCount& allocations = m_profiler->GetAllocationsLast();
+        ImGui::Text("Allocations - %llu, %.1f KB (last frame, every thread)", static_cast<unsigned long long>(allocations.count), allocations.bytes / 1024.0f);
+        ImGui::Separator();
+    }
+
+    // Time blocks, grouped by thread
+    const char* thread_name = nullptr;
     for (uint32_t i = 0; i < time_block_count; i++)
     {
-        if (time_blocks[i].GetType() != type)
+        if (time_blocks[i].GetType() != type || !time_blocks[i].IsComplete())
             continue;
 
+        if (type == TimeBlockType::Cpu && time_blocks[i].GetThreadName() != thread_name)
+        {
+            thread_name = time_blocks[i].GetThreadName();
+            ImGui::TextDisabled("%s", thread_name ? thread_name : "unknown");
+        }
+
         ShowTimeBlock(time_blocks[i], time_last);
     }
 
@@ -29,6 +29,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <array>
 //=============================
 
+namespace Genome
+{
+    class Input;
+}
+
 using namespace Genome;
 
 struct Timings
@@ -67,11 +72,13 @@ public:
 
     void OnShow() override;
     void OnHide() override;
+    void TickAlways() override;
     void TickVisible() override;
 
 private:
     std::array<float, 400> m_plot;
     Timings m_timings;
     Profiler* m_profiler;
+    Input* m_input;
     int m_item_type = 1;
 };
@@ -175,7 +175,7 @@ const Thumbnail& IconProvider::Thumbnail_Load(const string& file_path, Icon_Type
         m_context->GetSubsystem<Threading>()->AddTask([texture, file_path]()
         {
             texture->LoadFromFile(file_path);
-        });
+        }, Task_Lane::Io);
 
         m_thumbnails.emplace_back(type, texture, file_path);
         return m_thumbnails.back();
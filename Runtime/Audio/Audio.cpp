@@ -41,7 +41,7 @@ namespace Genome
     Audio::~Audio()
     {
         // Unsubscribe from events
-        UNSUBSCRIBE_FROM_EVENT(EventType::WorldClear, [this](Variant) { m_listener = nullptr; });
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_clear);
 
         if (!m_system_fmod)
             return;
@@ -124,9 +124,10 @@ namespace Genome
 
         // Get dependencies
         m_profiler = m_context->GetSubsystem<Profiler>();
+        m_metric_channels = m_profiler->RegisterGauge("audio/channels_playing");
 
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(EventType::WorldClear, [this](Variant) { m_listener = nullptr; });
+        m_event_world_clear = SUBSCRIBE_TO_EVENT(EventType::WorldClear, EVENT_HANDLER_EXPRESSION(m_listener = nullptr;));
    
         return true;
     }
@@ -150,6 +151,12 @@ namespace Genome
             return;
         }
 
+        int channels_playing = 0;
+        if (m_system_fmod->getChannelsPlaying(&channels_playing) == FMOD_OK)
+        {
+            m_profiler->GaugeSet(m_metric_channels, static_cast<double>(channels_playing));
+        }
+
         if (m_listener)
         {
             auto position = m_listener->GetPosition();
@@ -173,6 +180,16 @@ namespace Genome
         }
     }
 
+    TickDependencies Audio::GetTickDependencies() const
+    {
+        // Reads the listener transform (alongside the renderer, so once it's resolved), FMOD itself is thread safe
+        TickDependencies dependencies;
+        dependencies.reads          = Tick_Resource_World | Tick_Resource_Transforms | Tick_Resource_Time;
+        dependencies.writes         = Tick_Resource_Audio;
+        dependencies.main_thread    = false;
+        return dependencies;
+    }
+
     void Audio::SetListenerTransform(Transform* transform)
     {
         m_listener = transform;
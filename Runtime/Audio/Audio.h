@@ -21,9 +21,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ==================
+//= INCLUDES ====================
 #include "../Core/ISubsystem.h"
-//=============================
+#include "../Core/EventSystem.h"
+#include "../Profiling/Metrics.h"
+//===============================
 
 //= FORWARD DECLARATIONS =
 namespace FMOD
@@ -43,10 +45,12 @@ namespace Genome
         Audio(Context* context);
         ~Audio();
 
-        //= ISubsystem ======================
+        //= ISubsystem ================================================================
         bool Initialize() override;
         void Tick(float delta_time) override;
-        //===================================
+        TickDependencies GetTickDependencies() const override;
+        InitDependencies GetInitDependencies() const override { return InitAfter<>(); }
+        //=============================================================================
 
         auto GetSystemFMOD() const { return m_system_fmod; }
         void SetListenerTransform(Transform* transform);
@@ -59,7 +63,9 @@ namespace Genome
         float m_distance_entity        = 1.0f;
         bool m_initialized            = false;
         Transform* m_listener        = nullptr;
+        EventToken m_event_world_clear;
         Profiler* m_profiler        = nullptr;
         FMOD::System* m_system_fmod = nullptr;
+        MetricId m_metric_channels  = MetricRegistry::capacity;
     };
 }
@@ -22,7 +22,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES ===================
+#include <array>
+#include <algorithm>
 #include "ISubsystem.h"
+#include "TickGraph.h"
+#include "InitGraph.h"
 #include "../Logging/Log.h"
 #include "Spartan_Definitions.h"
 //==============================
@@ -59,9 +63,12 @@ namespace Genome
             // Loop in reverse registration order to avoid dependency conflicts
             for (size_t i = m_subsystems.size() - 1; i > 0; i--)
             {
+                // Subsystems which are still alive must not get a destroyed one from GetSubsystem()
+                std::replace(m_subsystems_by_index.begin(), m_subsystems_by_index.end(), m_subsystems[i].ptr.get(), static_cast<ISubsystem*>(nullptr));
                 m_subsystems[i].ptr.reset();
             }
 
+            m_subsystems_by_index.clear();
             m_subsystems.clear();
         }
 
@@ -72,57 +79,84 @@ namespace Genome
             validate_subsystem_type<T>();
 
             m_subsystems.emplace_back(std::make_shared<T>(this), tick_group);
+            m_tick_graphs_dirty = true;
+
+            // Map the type's index to the subsystem, so GetSubsystem() doesn't have to search
+            const uint32_t index = SubsystemIndex::Get<T>();
+            if (index >= m_subsystems_by_index.size())
+            {
+                m_subsystems_by_index.resize(index + 1, nullptr);
+            }
+            m_subsystems_by_index[index] = m_subsystems.back().ptr.get();
         }
 
-        // Initialize subsystems
+        // Initialize subsystems, independent ones initialize concurrently (see InitGraph)
         bool Initialize()
         {
-            auto result = true;
+            std::vector<ISubsystem*> subsystems;
             for (const _subystem& subsystem : m_subsystems)
             {
-                if (!subsystem.ptr->Initialize())
-                {
-                    LOG_ERROR("Failed to initialize %s", typeid(*subsystem.ptr).name());
-                    result = false;
-                }
+                subsystems.emplace_back(subsystem.ptr.get());
             }
 
-            return result;
+            return m_init_graph.Initialize(this, subsystems);
         }
 
-        // Tick
+        // Tick, independent subsystems tick concurrently (see TickGraph)
         void Tick(TickType tick_group, float delta_time = 0.0f)
         {
-            for (const _subystem& subsystem : m_subsystems)
+            if (m_tick_graphs_dirty)
             {
-                if (subsystem.tick_group != tick_group)
-                    continue;
-
-                subsystem.ptr->Tick(delta_time);
+                BuildTickGraphs();
             }
+
+            m_tick_graphs[static_cast<uint32_t>(tick_group)].Tick(delta_time);
         }
 
-        // Get a subsystem
-        template <class T> 
+        // Get the graph the subsystems were initialized with
+        const InitGraph& GetInitGraph() const { return m_init_graph; }
+
+        // Get the graph a tick group was last ticked with
+        const TickGraph& GetTickGraph(TickType tick_group) const { return m_tick_graphs[static_cast<uint32_t>(tick_group)]; }
+
+        // Get a subsystem, returns nullptr if it wasn't registered
+        template <class T>
         T* GetSubsystem() const
         {
             validate_subsystem_type<T>();
 
-            for (const auto& subsystem : m_subsystems)
-            {
-                if (subsystem.ptr)
-                {
-                    if (typeid(T) == typeid(*subsystem.ptr))
-                        return static_cast<T*>(subsystem.ptr.get());
-                }
-            }
+            return static_cast<T*>(GetSubsystemByIndex(SubsystemIndex::Get<T>()));
+        }
 
-            return nullptr;
+        // Get a subsystem by its SubsystemIndex, returns nullptr if it wasn't registered
+        ISubsystem* GetSubsystemByIndex(const uint32_t index) const
+        {
+            return index < m_subsystems_by_index.size() ? m_subsystems_by_index[index] : nullptr;
         }
 
         Engine* m_engine = nullptr;
 
     private:
+        void BuildTickGraphs()
+        {
+            std::array<std::vector<ISubsystem*>, 2> subsystems;
+            for (const _subystem& subsystem : m_subsystems)
+            {
+                subsystems[static_cast<uint32_t>(subsystem.tick_group)].emplace_back(subsystem.ptr.get());
+            }
+
+            for (uint32_t i = 0; i < static_cast<uint32_t>(m_tick_graphs.size()); i++)
+            {
+                m_tick_graphs[i].Build(this, subsystems[i]);
+            }
+
+            m_tick_graphs_dirty = false;
+        }
+
         std::vector<_subystem> m_subsystems;
+        std::vector<ISubsystem*> m_subsystems_by_index; // indexed by SubsystemIndex, registration happens before any lookups
+        std::array<TickGraph, 2> m_tick_graphs; // one per TickType
+        InitGraph m_init_graph;
+        bool m_tick_graphs_dirty = true;
     };
 }
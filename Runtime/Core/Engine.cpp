@@ -19,7 +19,7 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =========================
+//= INCLUDES ==========================
 #include "Spartan.h"
 #include "../Audio/Audio.h"
 #include "../Input/Input.h"
@@ -30,7 +30,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Scripting/Scripting.h"
 #include "../Threading/Threading.h"
 #include "../World/World.h"
-//====================================
+#include "../World/TransformResolver.h"
+//=====================================
 
 //= NAMESPACES ===============
 using namespace std;
@@ -56,8 +57,9 @@ namespace Genome
         m_context->RegisterSubsystem<Timer>(); // must be first so it ticks first
         m_context->RegisterSubsystem<Threading>();
         m_context->RegisterSubsystem<ResourceCache>();
-        m_context->RegisterSubsystem<Audio>();
         m_context->RegisterSubsystem<Physics>(); // integrates internally
+        m_context->RegisterSubsystem<TransformResolver>(); // after physics (and before anything which reads transforms), so they are read resolved
+        m_context->RegisterSubsystem<Audio>();   // after physics, so it reads this frame's listener transform and can tick alongside the renderer
         m_context->RegisterSubsystem<Input>(TickType::Smoothed);
         m_context->RegisterSubsystem<Scripting>(TickType::Smoothed);
         m_context->RegisterSubsystem<World>(TickType::Smoothed);
@@ -78,6 +80,9 @@ namespace Genome
 
     void Engine::Tick() const
     {
+        // Events which were fired deferred during the previous frame
+        EventSystem::Get().Flush();
+
         m_context->Tick(TickType::Variable, static_cast<float>(m_timer->GetDeltaTimeSec()));
         m_context->Tick(TickType::Smoothed, static_cast<float>(m_timer->GetDeltaTimeSmoothedSec()));
     }
@@ -21,22 +21,29 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ===============
-#include <unordered_map>
+//= INCLUDES ======================
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
 #include <functional>
-#include "../Core/Variant.h"
-//==========================
+#include <typeinfo>
+#include "../Logging/Log.h"
+#include "../Threading/TaskQueue.h"
+//=================================
 
 /*
 HOW TO USE
 =================================================================================
-To subscribe a function to an event     -> SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
-To unsubscribe a function from an event -> SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
-To fire an event                        -> FIRE_EVENT(EVENT_ID);
-To fire an event with data              -> FIRE_EVENT_DATA(EVENT_ID, Variant);
-
-Note: Currently, this is a blocking event system
+To subscribe a function to an event         -> token = SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
+To unsubscribe a function from an event     -> UNSUBSCRIBE_FROM_EVENT(token);
+To fire an event                            -> FIRE_EVENT(EVENT_ID);
+To fire an event with data                  -> FIRE_EVENT_DATA(EVENT_ID, data);
+To fire an event at the start of next frame -> FIRE_EVENT_DEFERRED(EVENT_ID) or FIRE_EVENT_DEFERRED_DATA(EVENT_ID, data);
+
+Events can be fired from any thread. Immediate events run the handlers on the firing thread and pass the data by
+reference, deferred events copy the data and run the handlers on the main thread, when EventSystem::Flush() is called.
+Handlers which take data must take the exact type the event is fired with, handlers which don't take data take any.
 =================================================================================
 */
 
@@ -50,29 +57,45 @@ enum class EventType
     WorldLoaded,    // The world finished loading from file
     WorldClear,     // The world should clear everything
     WorldResolve,   // The world should resolve
-    WorldResolved   // The world has finished resolving
+    WorldResolved,  // The world has finished resolving, data: std::vector<std::shared_ptr<Entity>>
+    Count
 };
 
-//= MACROS ====================================================================================================
-#define EVENT_HANDLER_EXPRESSION(expression)        [this](const Genome::Variant& var)    { ##expression }
-#define EVENT_HANDLER_EXPRESSION_STATIC(expression) [](const Genome::Variant& var)        { ##expression }
+//= MACROS ==============================================================================================================
+#define EVENT_HANDLER_EXPRESSION(expression)        [this]()                        { expression }
+#define EVENT_HANDLER_EXPRESSION_STATIC(expression) []()                            { expression }
 
-#define EVENT_HANDLER(function)                     [this](const Genome::Variant& var)    { function(); }
-#define EVENT_HANDLER_STATIC(function)              [](const Genome::Variant& var)        { function(); }
+#define EVENT_HANDLER(function)                     [this]()                        { function(); }
+#define EVENT_HANDLER_STATIC(function)              []()                            { function(); }
 
-#define EVENT_HANDLER_VARIANT(function)             [this](const Genome::Variant& var)    { function(var); }
-#define EVENT_HANDLER_VARIANT_STATIC(function)      [](const Genome::Variant& var)        { function(var); }
+#define EVENT_HANDLER_DATA(type, function)          [this](const type& data)        { function(data); }
+#define EVENT_HANDLER_DATA_STATIC(type, function)   [](const type& data)            { function(data); }
 
 #define FIRE_EVENT(eventID)                         Genome::EventSystem::Get().Fire(eventID)
 #define FIRE_EVENT_DATA(eventID, data)              Genome::EventSystem::Get().Fire(eventID, data)
+#define FIRE_EVENT_DEFERRED(eventID)                Genome::EventSystem::Get().FireDeferred(eventID)
+#define FIRE_EVENT_DEFERRED_DATA(eventID, data)     Genome::EventSystem::Get().FireDeferred(eventID, data)
 
-#define SUBSCRIBE_TO_EVENT(eventID, function)       Genome::EventSystem::Get().Subscribe(eventID, function);
-#define UNSUBSCRIBE_FROM_EVENT(eventID, function)   Genome::EventSystem::Get().Unsubscribe(eventID, function);
-//=============================================================================================================
+#define SUBSCRIBE_TO_EVENT(eventID, function)       Genome::EventSystem::Get().Subscribe(eventID, function)
+#define UNSUBSCRIBE_FROM_EVENT(token)               Genome::EventSystem::Get().Unsubscribe(token)
+//=======================================================================================================================
 
 namespace Genome
 {
-    using subscriber = std::function<void(const Variant&)>;
+    // A subscribed handler, receives a pointer to the data the event was fired with
+    struct EventSubscriber
+    {
+        std::function<void(const void*)> function;
+        const std::type_info* data_type = nullptr; // nullptr if the handler doesn't take data
+        std::atomic<bool> is_subscribed = true;
+    };
+
+    // Returned by Subscribe(), unsubscribing with it is O(1)
+    struct EventToken
+    {
+        EventType event_id = EventType::Count;
+        std::shared_ptr<EventSubscriber> subscriber;
+    };
 
     class GENOME_CLASS EventSystem
     {
@@ -83,44 +106,135 @@ namespace Genome
             return instance;
         }
 
-        void Subscribe(const EventType event_id, subscriber&& function)
+        template <typename Function>
+        EventToken Subscribe(const EventType event_id, Function&& function)
         {
-            m_subscribers[event_id].push_back(std::forward<subscriber>(function));
-        }
+            EventToken token;
+            token.event_id      = event_id;
+            token.subscriber    = std::make_shared<EventSubscriber>();
 
-        void Unsubscribe(const EventType event_id, subscriber&& function)
-        {
-            const size_t function_adress    = *reinterpret_cast<long*>(reinterpret_cast<char*>(&function));
-            auto& subscribers               = m_subscribers[event_id];
+            if constexpr (std::is_invocable_v<Function&>)
+            {
+                token.subscriber->function = [function = std::forward<Function>(function)](const void*) mutable { function(); };
+            }
+            else
+            {
+                typedef std::decay_t<typename handler_data<decltype(&std::decay_t<Function>::operator())>::type> data_type;
+                token.subscriber->function  = [function = std::forward<Function>(function)](const void* data) mutable { function(*static_cast<const data_type*>(data)); };
+                token.subscriber->data_type = &typeid(data_type);
+            }
 
-            for (auto it = subscribers.begin(); it != subscribers.end();)
+            // Handlers can be running, so they get a new list instead of a modified one, subscribing is rare
+            std::lock_guard<std::mutex> lock(m_mutex);
+            SubscriberList& list                            = m_subscribers[static_cast<uint32_t>(event_id)];
+            std::shared_ptr<SubscriberList::Array> array    = std::make_shared<SubscriberList::Array>();
+            if (list.array)
             {
-                const size_t subscriber_adress = *reinterpret_cast<long*>(reinterpret_cast<char*>(&(*it)));
-                if (subscriber_adress == function_adress)
+                for (const std::shared_ptr<EventSubscriber>& subscriber : *list.array)
                 {
-                    it = subscribers.erase(it);
-                    return;
+                    if (subscriber->is_subscribed.load(std::memory_order_relaxed))
+                    {
+                        array->emplace_back(subscriber);
+                    }
                 }
             }
+            array->emplace_back(token.subscriber);
+            std::atomic_store(&list.array, std::shared_ptr<const SubscriberList::Array>(array));
+
+            return token;
         }
 
-        void Fire(const EventType event_id, const Variant& data = 0)
+        // Handlers which are already running on other threads will finish, but no new ones will start
+        void Unsubscribe(EventToken& token)
         {
-            if (m_subscribers.find(event_id) == m_subscribers.end())
+            if (!token.subscriber)
                 return;
 
-            for (const auto& subscriber : m_subscribers[event_id])
+            token.subscriber->is_subscribed.store(false, std::memory_order_relaxed);
+            token.subscriber = nullptr;
+        }
+
+        // Runs the handlers on the calling thread
+        void Fire(const EventType event_id)
+        {
+            Dispatch(event_id, nullptr, nullptr);
+        }
+
+        template <typename T>
+        void Fire(const EventType event_id, const T& data)
+        {
+            Dispatch(event_id, &data, &typeid(T));
+        }
+
+        // Queues the event (and a copy of the data), the main thread runs the handlers on Flush()
+        void FireDeferred(const EventType event_id)
+        {
+            m_deferred.Push([this, event_id]() { Fire(event_id); });
+        }
+
+        template <typename T>
+        void FireDeferred(const EventType event_id, T data)
+        {
+            m_deferred.Push([this, event_id, data = std::move(data)]() { Fire(event_id, data); });
+        }
+
+        // Runs the handlers of the deferred events, call from the main thread
+        void Flush()
+        {
+            std::function<void()> event;
+            while (m_deferred.TryPop(event))
             {
-                subscriber(data);
+                event();
             }
         }
 
         void Clear() 
         {
-            m_subscribers.clear(); 
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (SubscriberList& list : m_subscribers)
+            {
+                std::atomic_store(&list.array, std::shared_ptr<const SubscriberList::Array>());
+            }
         }
 
     private:
-        std::unordered_map<EventType, std::vector<subscriber>> m_subscribers;
+        // The type of the data a handler takes, deduced from its call operator
+        template <typename T>
+        struct handler_data;
+        template <typename C, typename R, typename A>
+        struct handler_data<R(C::*)(A)> { typedef A type; };
+        template <typename C, typename R, typename A>
+        struct handler_data<R(C::*)(A) const> { typedef A type; };
+
+        struct SubscriberList
+        {
+            typedef std::vector<std::shared_ptr<EventSubscriber>> Array;
+            std::shared_ptr<const Array> array;
+        };
+
+        void Dispatch(const EventType event_id, const void* data, const std::type_info* data_type)
+        {
+            const std::shared_ptr<const SubscriberList::Array> array = std::atomic_load(&m_subscribers[static_cast<uint32_t>(event_id)].array);
+            if (!array)
+                return;
+
+            for (const std::shared_ptr<EventSubscriber>& subscriber : *array)
+            {
+                if (!subscriber->is_subscribed.load(std::memory_order_relaxed))
+                    continue;
+
+                if (subscriber->data_type && (!data_type || *subscriber->data_type != *data_type))
+                {
+                    LOG_ERROR("Event %d was fired with data which doesn't match the type a handler takes", static_cast<int>(event_id));
+                    continue;
+                }
+
+                subscriber->function(data);
+            }
+        }
+
+        SubscriberList m_subscribers[static_cast<uint32_t>(EventType::Count)];
+        MpscQueue<std::function<void()>> m_deferred;
+        std::mutex m_mutex;
     };
 }
@@ -41,6 +41,18 @@ namespace Genome
         outfile.close();
     }
 
+    bool FileSystem::ReadFileBytes(const string& file_path, vector<std::byte>& bytes)
+    {
+        ifstream file(file_path, ios::binary | ios::ate);
+        if (!file.is_open())
+            return false;
+
+        bytes.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0, ios::beg);
+
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(bytes.data()), bytes.size()));
+    }
+
     bool FileSystem::IsEmptyOrWhitespace(const std::string& var)
     {
         // Check if it's empty
@@ -35,6 +35,9 @@ namespace Genome
         // File creation
         static void CreateTextFile(const std::string& file_path, const std::string& text);
 
+        // File reading
+        static bool ReadFileBytes(const std::string& file_path, std::vector<std::byte>& bytes);
+
         // Strings
         static bool IsEmptyOrWhitespace(const std::string& var);
         static bool IsAlphanumeric(const std::string& var);
@@ -24,6 +24,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===================
 #include <type_traits>
 #include <memory>
+#include <vector>
+#include <atomic>
 #include "Spartan_Definitions.h"
 //==============================
 
@@ -31,6 +33,63 @@ namespace Genome
 {
     class Context;
 
+    // Data a subsystem can touch while ticking, used to figure out which subsystems can tick concurrently
+    enum Tick_Resource : uint32_t
+    {
+        Tick_Resource_Time          = 1UL << 0,
+        Tick_Resource_Input         = 1UL << 1,
+        Tick_Resource_World         = 1UL << 2, // entities, components and transforms
+        Tick_Resource_Physics       = 1UL << 3,
+        Tick_Resource_Audio         = 1UL << 4,
+        Tick_Resource_Resources     = 1UL << 5,
+        Tick_Resource_Renderer      = 1UL << 6,
+        Tick_Resource_Transforms    = 1UL << 7, // resolved transforms (see TransformResolver), read it to read transforms alongside other subsystems
+        Tick_Resource_All           = 0xFFFFFFFF
+    };
+
+    struct TickDependencies
+    {
+        uint32_t reads      = Tick_Resource_All;
+        uint32_t writes     = Tick_Resource_All;
+        bool main_thread    = true; // if false, the subsystem can tick on a worker thread
+
+        // Two subsystems conflict if either writes something the other one touches
+        bool ConflictsWith(const TickDependencies& other) const
+        {
+            return (writes & (other.reads | other.writes)) || (other.writes & (reads | writes));
+        }
+    };
+
+    // Hands out a unique index per subsystem type, the first time the type asks for one
+    class SubsystemIndex
+    {
+    public:
+        template <class T>
+        static uint32_t Get()
+        {
+            static const uint32_t index = m_count++;
+            return index;
+        }
+
+    private:
+        static inline std::atomic<uint32_t> m_count = 0;
+    };
+
+    // What has to happen before a subsystem can initialize, used to initialize independent subsystems concurrently
+    struct InitDependencies
+    {
+        std::vector<uint32_t> subsystems;   // SubsystemIndex of the subsystems which must have initialized first
+        bool after_earlier  = true;         // if true, wait for every subsystem registered earlier instead
+        bool main_thread    = true;         // if false, the subsystem can initialize on a worker thread
+    };
+
+    // Initialize after the given subsystems (and only those), e.g. InitAfter<ResourceCache>()
+    template <class... T>
+    InitDependencies InitAfter(const bool main_thread = false)
+    {
+        return { { SubsystemIndex::Get<T>()... }, false, main_thread };
+    }
+
     class GENOME_CLASS ISubsystem : public std::enable_shared_from_this<ISubsystem>
     {        
     public:
@@ -39,6 +98,12 @@ namespace Genome
         virtual bool Initialize() { return true; }
         virtual void Tick(float delta_time) {}
 
+        // What Tick() reads and writes, the default is exclusive access on the main thread
+        virtual TickDependencies GetTickDependencies() const { return TickDependencies(); }
+
+        // What Initialize() needs, the default is to initialize on the main thread after everything registered earlier
+        virtual InitDependencies GetInitDependencies() const { return InitDependencies(); }
+
         template <typename T>
         std::shared_ptr<T> GetPtrShared() { return std::dynamic_pointer_cast<T>(shared_from_this()); }
 
@@ -0,0 +1,253 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "Spartan.h"
+#include "InitGraph.h"
+#include "../Threading/Threading.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Genome
+{
+    void InitGraph::Build(Context* context, const vector<ISubsystem*>& subsystems)
+    {
+        m_nodes.clear();
+
+        for (ISubsystem* subsystem : subsystems)
+        {
+            InitNode& node      = m_nodes.emplace_back();
+            node.subsystem      = subsystem;
+            node.dependencies   = subsystem->GetInitDependencies();
+
+            // "class Genome::Renderer" -> "Renderer"
+            node.name = typeid(*subsystem).name();
+            const size_t pos = node.name.find_last_of(": ");
+            if (pos != string::npos)
+            {
+                node.name = node.name.substr(pos + 1);
+            }
+        }
+
+        const uint32_t node_count = static_cast<uint32_t>(m_nodes.size());
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            InitNode& node = m_nodes[i];
+
+            if (node.dependencies.after_earlier)
+            {
+                for (uint32_t j = 0; j < i; j++)
+                {
+                    node.predecessors.emplace_back(j);
+                }
+
+                continue;
+            }
+
+            for (const uint32_t index : node.dependencies.subsystems)
+            {
+                const ISubsystem* dependency = context->GetSubsystemByIndex(index);
+                const auto it = find(subsystems.begin(), subsystems.end(), dependency);
+                if (!dependency || it == subsystems.end())
+                {
+                    LOG_WARNING("%s depends on a subsystem which isn't registered", node.name.c_str());
+                    continue;
+                }
+
+                node.predecessors.emplace_back(static_cast<uint32_t>(it - subsystems.begin()));
+            }
+        }
+    }
+
+    bool InitGraph::Sort()
+    {
+        // Kahn's algorithm, ties go to registration order
+        const uint32_t node_count = static_cast<uint32_t>(m_nodes.size());
+        vector<uint32_t> predecessors_remaining(node_count);
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            predecessors_remaining[i] = static_cast<uint32_t>(m_nodes[i].predecessors.size());
+        }
+
+        m_order.clear();
+        vector<bool> is_sorted(node_count, false);
+        while (m_order.size() < node_count)
+        {
+            uint32_t next = node_count;
+            for (uint32_t i = 0; i < node_count; i++)
+            {
+                if (!is_sorted[i] && predecessors_remaining[i] == 0)
+                {
+                    next = i;
+                    break;
+                }
+            }
+
+            // Cycle
+            if (next == node_count)
+                return false;
+
+            is_sorted[next] = true;
+            m_order.emplace_back(next);
+
+            for (uint32_t i = 0; i < node_count; i++)
+            {
+                for (const uint32_t predecessor : m_nodes[i].predecessors)
+                {
+                    if (predecessor == next)
+                    {
+                        predecessors_remaining[i]--;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool InitGraph::Initialize(Context* context, const vector<ISubsystem*>& subsystems)
+    {
+        const auto time_start = chrono::steady_clock::now();
+        const auto time_since_start = [&time_start]()
+        {
+            return static_cast<float>(chrono::duration<double, milli>(chrono::steady_clock::now() - time_start).count());
+        };
+
+        Build(context, subsystems);
+
+        const uint32_t node_count = static_cast<uint32_t>(m_nodes.size());
+        Threading* threading = context->GetSubsystem<Threading>();
+        if (!Sort())
+        {
+            LOG_ERROR("The init dependencies of the subsystems form a cycle, initializing them in registration order instead");
+            threading = nullptr;
+
+            m_order.clear();
+            for (uint32_t i = 0; i < node_count; i++)
+            {
+                m_order.emplace_back(i);
+            }
+        }
+
+        auto initialize = [this, &time_since_start, threading](const uint32_t index)
+        {
+            InitNode& node      = m_nodes[index];
+            node.time_start_ms  = time_since_start();
+            node.thread_name    = threading ? threading->GetThreadName() : "main";
+            node.result         = node.subsystem->Initialize();
+            node.time_end_ms    = time_since_start();
+
+            if (!node.result)
+            {
+                LOG_ERROR("Failed to initialize %s", node.name.c_str());
+            }
+        };
+
+        if (threading)
+        {
+            // Main thread nodes complete a promise, so that worker nodes can depend on them before they run
+            vector<Future<void>> futures(node_count);
+            vector<Promise<void>> promises;
+            vector<uint32_t> promise_indices(node_count);
+            vector<uint32_t> main_thread_nodes;
+            for (const uint32_t i : m_order)
+            {
+                if (m_nodes[i].dependencies.main_thread)
+                {
+                    promise_indices[i] = static_cast<uint32_t>(promises.size());
+                    futures[i]         = promises.emplace_back(threading).GetFuture();
+                    main_thread_nodes.emplace_back(i);
+                }
+            }
+
+            // Worker nodes start as soon as their predecessors complete (sorted, so their futures exist by now)
+            for (const uint32_t i : m_order)
+            {
+                if (m_nodes[i].dependencies.main_thread)
+                    continue;
+
+                vector<Future<void>> predecessors;
+                for (const uint32_t predecessor : m_nodes[i].predecessors)
+                {
+                    predecessors.emplace_back(futures[predecessor]);
+                }
+
+                futures[i] = threading->WhenAll(predecessors).Then([&initialize, i]() { initialize(i); }, Task_Lane::High);
+            }
+
+            // Main thread nodes, whichever is ready goes first. If none is, wait for the first one (in sorted order) while helping with the rest.
+            auto is_ready = [this, &futures](const uint32_t index)
+            {
+                for (const uint32_t predecessor : m_nodes[index].predecessors)
+                {
+                    if (!futures[predecessor].IsReady())
+                        return false;
+                }
+
+                return true;
+            };
+
+            while (!main_thread_nodes.empty())
+            {
+                auto it = find_if(main_thread_nodes.begin(), main_thread_nodes.end(), is_ready);
+                if (it == main_thread_nodes.end())
+                {
+                    it = main_thread_nodes.begin();
+                    for (const uint32_t predecessor : m_nodes[*it].predecessors)
+                    {
+                        futures[predecessor].Wait();
+                    }
+                }
+
+                const uint32_t index = *it;
+                main_thread_nodes.erase(it);
+                initialize(index);
+                promises[promise_indices[index]].SetValue();
+            }
+
+            // Initialization is done once the last worker node is
+            threading->WhenAll(futures).Wait();
+        }
+        else
+        {
+            for (const uint32_t i : m_order)
+            {
+                initialize(i);
+            }
+        }
+
+        m_duration_ms = time_since_start();
+
+        bool result = true;
+        for (const uint32_t i : m_order)
+        {
+            const InitNode& node = m_nodes[i];
+            LOG_INFO("%s initialized in %.1f ms on %s", node.name.c_str(), node.time_end_ms - node.time_start_ms, node.thread_name.c_str());
+            result = result && node.result;
+        }
+        LOG_INFO("Subsystems initialized in %.1f ms", m_duration_ms);
+
+        return result;
+    }
+}
@@ -65,6 +65,7 @@ namespace Genome
 
     bool Settings::Initialize()
     {
+        // This initializes after all other subsystems (the default), since mapping the settings reconfigures them
         // Acquire default settings
         Reflect();
 
@@ -83,12 +84,15 @@ namespace Genome
         LOG_INFO("Shadow resolution: %d", m_shadow_map_resolution);
         LOG_INFO("Anisotropy: %d", m_anisotropy);
         LOG_INFO("Max threads: %d", m_max_thread_count);
+        LOG_INFO("I/O threads: %d", m_io_thread_count);
 
         return true;
     }
 
     void Settings::RegisterThirdPartyLib(const std::string& name, const std::string& version, const std::string& url)
     {
+        // Subsystems initialize concurrently
+        std::lock_guard<std::mutex> guard(m_mutex_third_party_libs);
         m_third_party_libs.emplace_back(name, version, url);
     }
 
@@ -110,6 +114,9 @@ namespace Genome
         _Settings::write_setting(_Settings::fout, "fFPSLimit", m_fps_limit);
         _Settings::write_setting(_Settings::fout, "iMaxThreadCount", m_max_thread_count);
         _Settings::write_setting(_Settings::fout, "iRendererFlags", m_renderer_flags);
+        _Settings::write_setting(_Settings::fout, "iIoThreadCount", m_io_thread_count);
+        _Settings::write_setting(_Settings::fout, "iBackgroundThreadCount", m_background_thread_count);
+        _Settings::write_setting(_Settings::fout, "bThreadAffinity", m_thread_affinity);
 
         // Close the file.
         _Settings::fout.close();
@@ -133,6 +140,9 @@ namespace Genome
         _Settings::read_setting(_Settings::fin, "fFPSLimit", m_fps_limit);
         _Settings::read_setting(_Settings::fin, "iMaxThreadCount", m_max_thread_count);
         _Settings::read_setting(_Settings::fin, "iRendererFlags", m_renderer_flags);
+        _Settings::read_setting(_Settings::fin, "iIoThreadCount", m_io_thread_count);
+        _Settings::read_setting(_Settings::fin, "iBackgroundThreadCount", m_background_thread_count);
+        _Settings::read_setting(_Settings::fin, "bThreadAffinity", m_thread_affinity);
 
         // Close the file.
         _Settings::fin.close();
@@ -143,9 +153,13 @@ namespace Genome
     void Settings::Reflect()
     {
         Renderer* renderer = m_context->GetSubsystem<Renderer>();
+        Threading* threading = m_context->GetSubsystem<Threading>();
 
         m_fps_limit = m_context->GetSubsystem<Timer>()->GetTargetFps();
-        m_max_thread_count = m_context->GetSubsystem<Threading>()->GetThreadCountSupport();
+        m_max_thread_count = threading->GetThreadCount() + 1;
+        m_io_thread_count = threading->GetThreadCountIo();
+        m_background_thread_count = threading->GetThreadCountBackground();
+        m_thread_affinity = threading->GetThreadAffinity();
         m_is_fullscreen = renderer->GetIsFullscreen();
         m_resolution_output = renderer->GetResolutionOutput();
         m_resolution_render = renderer->GetResolutionRender();
@@ -158,8 +172,12 @@ namespace Genome
     void Settings::Map() const
     {
         Renderer* renderer = m_context->GetSubsystem<Renderer>();
+        Threading* threading = m_context->GetSubsystem<Threading>();
 
         m_context->GetSubsystem<Timer>()->SetTargetFps(m_fps_limit);
+        threading->SetThreadCount(m_max_thread_count > 0 ? m_max_thread_count - 1 : 0, m_io_thread_count);
+        threading->SetThreadCountBackground(m_background_thread_count);
+        threading->SetThreadAffinity(m_thread_affinity);
         renderer->SetIsFullscreen(m_is_fullscreen);
         renderer->SetResolutionOutput(static_cast<uint32_t>(m_resolution_output.x), static_cast<uint32_t>(m_resolution_output.y));
         renderer->SetResolutionRender(static_cast<uint32_t>(m_resolution_render.x), static_cast<uint32_t>(m_resolution_render.y));
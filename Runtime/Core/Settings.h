@@ -4,6 +4,7 @@
 #include "ISubsystem.h"
 #include "../Math/Vector2.h"
 #include <vector>
+#include <mutex>
 //==========================
 
 namespace Genome
@@ -30,9 +31,10 @@ namespace Genome
         Settings(Context* context);
         ~Settings();
 
-        //= Subsystem =============
+        //= Subsystem ==================================================================
         bool Initialize() override;
-        //=========================
+        TickDependencies GetTickDependencies() const override { return { 0, 0, true }; }
+        //==============================================================================
 
         //= MISC =======================================================
         bool GetIsFullScreen()      const { return m_is_fullscreen; }
@@ -58,10 +60,14 @@ namespace Genome
         Math::Vector2 m_resolution_render = Math::Vector2::Zero;
         uint32_t m_anisotropy = 0;
         uint32_t m_tonemapping = 0;
-        uint32_t m_max_thread_count = 0;
+        uint32_t m_max_thread_count = 0;          // including the main thread
+        uint32_t m_io_thread_count = 0;
+        uint32_t m_background_thread_count = 0;   // workers which can run Background tasks at the same time
+        bool m_thread_affinity = false;
         double m_fps_limit = 0;
         bool m_loaded = false;
         Context* m_context = nullptr;
         std::vector<ThirdPartyLib> m_third_party_libs;
+        std::mutex m_mutex_third_party_libs;
     };
 }
@@ -38,6 +38,12 @@ namespace Genome
 // Assert
 #define SP_ASSERT(expression) assert(expression)
 
+// Allocation tracking, replaces the global operator new/delete so that the profiler can count allocations (when asked to)
+// -> Defined by solution generation script, for the benchmark and the debug configuration of the editor
+#ifndef SP_TRACK_ALLOCATIONS
+#define SP_TRACK_ALLOCATIONS 0
+#endif
+
 // Platform 
 //#define API_GRAPHICS_D3D11    -> Defined by solution generation script
 //#define API_GRAPHICS_D3D12    -> Defined by solution generation script
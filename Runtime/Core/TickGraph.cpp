@@ -0,0 +1,196 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "Spartan.h"
+#include "TickGraph.h"
+#include "../Threading/Threading.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Genome
+{
+    void TickGraph::Build(Context* context, const vector<ISubsystem*>& subsystems)
+    {
+        m_threading = context->GetSubsystem<Threading>();
+        m_nodes.clear();
+
+        for (ISubsystem* subsystem : subsystems)
+        {
+            TickNode& node      = m_nodes.emplace_back();
+            node.subsystem      = subsystem;
+            node.dependencies   = subsystem->GetTickDependencies();
+
+            // "class Genome::Renderer" -> "Renderer"
+            node.name = typeid(*subsystem).name();
+            const size_t pos = node.name.find_last_of(": ");
+            if (pos != string::npos)
+            {
+                node.name = node.name.substr(pos + 1);
+            }
+
+            // Depend on every earlier subsystem we conflict with, which keeps registration order wherever it matters
+            const uint32_t index = static_cast<uint32_t>(m_nodes.size()) - 1;
+            for (uint32_t i = 0; i < index; i++)
+            {
+                if (node.dependencies.ConflictsWith(m_nodes[i].dependencies))
+                {
+                    node.predecessors.emplace_back(i);
+                }
+            }
+        }
+    }
+
+    void TickGraph::Tick(const float delta_time)
+    {
+        const auto time_start = chrono::steady_clock::now();
+        const auto time_since_start = [&time_start]()
+        {
+            return static_cast<float>(chrono::duration<double, milli>(chrono::steady_clock::now() - time_start).count());
+        };
+
+        auto tick = [this, delta_time, &time_since_start](const uint32_t index)
+        {
+            TickNode& node      = m_nodes[index];
+            node.time_start_ms  = time_since_start();
+            node.thread_name    = m_threading ? m_threading->GetThreadName() : "main";
+            node.subsystem->Tick(delta_time);
+            node.time_end_ms    = time_since_start();
+        };
+
+        const uint32_t node_count = static_cast<uint32_t>(m_nodes.size());
+        if (m_threading)
+        {
+            // Main thread nodes complete a promise, so that worker nodes can depend on them before they run
+            vector<Future<void>> futures(node_count);
+            vector<Promise<void>> promises;
+            vector<uint32_t> promise_indices(node_count);
+            vector<uint32_t> main_thread_nodes;
+            for (uint32_t i = 0; i < node_count; i++)
+            {
+                if (m_nodes[i].dependencies.main_thread)
+                {
+                    promise_indices[i] = static_cast<uint32_t>(promises.size());
+                    futures[i]         = promises.emplace_back(m_threading).GetFuture();
+                    main_thread_nodes.emplace_back(i);
+                }
+            }
+
+            // Worker nodes start as soon as their predecessors complete (those are earlier nodes, so their futures exist by now)
+            for (uint32_t i = 0; i < node_count; i++)
+            {
+                if (m_nodes[i].dependencies.main_thread)
+                    continue;
+
+                vector<Future<void>> predecessors;
+                for (const uint32_t predecessor : m_nodes[i].predecessors)
+                {
+                    predecessors.emplace_back(futures[predecessor]);
+                }
+
+                futures[i] = m_threading->WhenAll(predecessors).Then([&tick, i]() { tick(i); }, Task_Lane::High);
+            }
+
+            // Main thread nodes, whichever is ready goes first. If none is, wait for the first one while helping with the rest.
+            auto is_ready = [this, &futures](const uint32_t index)
+            {
+                for (const uint32_t predecessor : m_nodes[index].predecessors)
+                {
+                    if (!futures[predecessor].IsReady())
+                        return false;
+                }
+
+                return true;
+            };
+
+            while (!main_thread_nodes.empty())
+            {
+                auto it = find_if(main_thread_nodes.begin(), main_thread_nodes.end(), is_ready);
+                if (it == main_thread_nodes.end())
+                {
+                    it = main_thread_nodes.begin();
+                    for (const uint32_t predecessor : m_nodes[*it].predecessors)
+                    {
+                        futures[predecessor].Wait();
+                    }
+                }
+
+                const uint32_t index = *it;
+                main_thread_nodes.erase(it);
+                tick(index);
+                promises[promise_indices[index]].SetValue();
+            }
+
+            // Sync point, nothing from this group may still be running once we return
+            m_threading->WhenAll(futures).Wait();
+        }
+        else
+        {
+            for (uint32_t i = 0; i < node_count; i++)
+            {
+                tick(i);
+            }
+        }
+
+        m_duration_ms = time_since_start();
+        ComputeCriticalPath();
+    }
+
+    void TickGraph::ComputeCriticalPath()
+    {
+        // Longest chain of dependent subsystems, weighted by how long each one ticked
+        const uint32_t node_count = static_cast<uint32_t>(m_nodes.size());
+        vector<float> finish(node_count, 0.0f);
+        vector<int32_t> previous(node_count, -1);
+
+        int32_t last = -1;
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            TickNode& node  = m_nodes[i];
+            node.is_critical = false;
+
+            float start = 0.0f;
+            for (const uint32_t predecessor : node.predecessors)
+            {
+                if (finish[predecessor] > start)
+                {
+                    start       = finish[predecessor];
+                    previous[i] = static_cast<int32_t>(predecessor);
+                }
+            }
+            finish[i] = start + (node.time_end_ms - node.time_start_ms);
+
+            if (last == -1 || finish[i] > finish[last])
+            {
+                last = static_cast<int32_t>(i);
+            }
+        }
+
+        m_critical_path_ms = last != -1 ? finish[last] : 0.0f;
+        for (int32_t i = last; i != -1; i = previous[i])
+        {
+            m_nodes[i].is_critical = true;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <vector>
+#include <string>
+#include "ISubsystem.h"
+#include "Spartan_Definitions.h"
+//=============================
+
+namespace Genome
+{
+    class Context;
+    class Threading;
+
+    struct TickNode
+    {
+        ISubsystem* subsystem = nullptr;
+        std::string name;
+        TickDependencies dependencies;
+        std::vector<uint32_t> predecessors; // nodes which must finish before this one starts
+
+        // Timings of the last tick, relative to the start of the graph
+        float time_start_ms     = 0.0f;
+        float time_end_ms       = 0.0f;
+        std::string thread_name = "main"; // a copy, the pool can be restarted and its names are gone then
+        bool is_critical        = false;
+    };
+
+    // Ticks a group of subsystems on the job system. Each subsystem waits for the earlier ones it conflicts with
+    // (as declared by ISubsystem::GetTickDependencies()), everything else runs concurrently. Subsystems which
+    // must run on the main thread do so there, whichever of them is ready first goes first. Worker subsystems are
+    // dispatched as continuations of the ones they wait for, the graph joins all of them before returning.
+    class GENOME_CLASS TickGraph
+    {
+    public:
+        void Build(Context* context, const std::vector<ISubsystem*>& subsystems);
+        void Tick(float delta_time);
+
+        const std::vector<TickNode>& GetNodes() const { return m_nodes; }
+        float GetDurationMs()                   const { return m_duration_ms; }
+        float GetCriticalPathMs()               const { return m_critical_path_ms; }
+
+    private:
+        void ComputeCriticalPath();
+
+        std::vector<TickNode> m_nodes;
+        Threading* m_threading      = nullptr;
+        float m_duration_ms         = 0.0f;
+        float m_critical_path_ms    = 0.0f;
+    };
+}
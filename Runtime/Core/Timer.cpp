@@ -22,6 +22,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ==================
 #include "Spartan.h"
 #include "../Display/Display.h"
+#if defined(_WIN32)
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002 // older SDKs
+#endif
+#endif
 //=============================
 
 //= NAMESPACES =====
@@ -30,35 +36,56 @@ using namespace std;
 
 namespace Genome
 {
+    // A frame which ends later than this past its deadline, counts as a missed one
+    static const double pacing_tolerance_ms = 0.5;
+
     Timer::Timer(Context* context) : ISubsystem(context)
     {
         m_time_start        = chrono::high_resolution_clock::now();
         m_time_sleep_end    = chrono::high_resolution_clock::now();
+
+#if defined(_WIN32)
+        // Regular sleeps have the granularity of the system timer (up to 15.6 ms), high resolution timers exist since Windows 10 1803
+        m_sleep_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+    }
+
+    Timer::~Timer()
+    {
+#if defined(_WIN32)
+        if (m_sleep_timer)
+        {
+            CloseHandle(m_sleep_timer);
+        }
+#endif
     }
 
     void Timer::Tick(float _delta_time)
     {
-        // Compute delta time
+        const auto time_frame_start_previous = m_time_sleep_end;
         m_time_sleep_start = chrono::high_resolution_clock::now();
-        chrono::duration<double, milli> delta_time = m_time_sleep_start - m_time_sleep_end;
-
-        // FPS limiting
-        {
-            // The kernel takes time to wake up the thread after the thread has finished sleeping.
-            // It can't be trusted for accurate frame limiting, hence we do it simple stupid.
-            double target_ms = 1000.0 / m_fps_target;
-            while (delta_time.count() < target_ms)
-            {
-                delta_time = chrono::high_resolution_clock::now() - m_time_sleep_start;
-            }
 
-            m_time_sleep_end = chrono::high_resolution_clock::now();
-        }
+        // FPS limiting, the frame ends one target frame time after the previous one did
+        const double target_ms  = 1000.0 / m_fps_target;
+        const bool is_limited   = m_fps_target < m_fps_max;
+        const auto deadline     = time_frame_start_previous + chrono::duration_cast<chrono::high_resolution_clock::duration>(chrono::duration<double, milli>(target_ms));
+        WaitUntil(deadline);
+        m_time_sleep_end = chrono::high_resolution_clock::now();
 
         // Compute durations
-        m_delta_time_ms = static_cast<double>(delta_time.count());
+        m_delta_time_ms = chrono::duration<double, milli>(m_time_sleep_end - time_frame_start_previous).count();
         m_time_ms       = static_cast<double>(chrono::duration<double, milli>(m_time_start - m_time_sleep_start).count());
 
+        // Frame pacing
+        if (is_limited)
+        {
+            const double lateness_ms = chrono::duration<double, milli>(m_time_sleep_end - deadline).count();
+
+            m_pacing_stats.frames++;
+            m_pacing_stats.deadlines_missed += lateness_ms > pacing_tolerance_ms ? 1 : 0;
+            m_pacing_stats.jitter_ms        += abs(m_delta_time_ms - target_ms);
+        }
+
         // Compute smoothed delta time
         const double frames_to_accumulate   = 5;
         const double delta_feedback         = 1.0 / frames_to_accumulate;
@@ -67,6 +94,65 @@ namespace Genome
         m_delta_time_smoothed_ms            = m_delta_time_smoothed_ms * (1.0 - delta_feedback) + delta_clamped * delta_feedback;
     }
 
+    void Timer::WaitUntil(const chrono::high_resolution_clock::time_point& deadline)
+    {
+        const auto time_start   = chrono::high_resolution_clock::now();
+        const double wait_ms    = chrono::duration<double, milli>(deadline - time_start).count();
+        if (wait_ms <= 0.0)
+            return;
+
+        // The kernel takes time to wake up the thread after the thread has finished sleeping, so
+        // sleep for most of the wait, but leave enough of it to spin for an accurate wake up.
+        const double spin_ms = max(m_spin_ms, m_sleep_overhead_ms);
+        if (wait_ms > spin_ms)
+        {
+            const double sleep_ms = wait_ms - spin_ms;
+            SleepFor(sleep_ms);
+
+            // Worse wake ups are adopted right away, better ones gradually, so that one lucky wake up doesn't make us miss the next deadline
+            const auto time_awake       = chrono::high_resolution_clock::now();
+            const double slept_ms       = chrono::duration<double, milli>(time_awake - time_start).count();
+            const double overhead_ms    = max(slept_ms - sleep_ms, 0.0);
+            m_sleep_overhead_ms         = overhead_ms > m_sleep_overhead_ms ? overhead_ms : m_sleep_overhead_ms * 0.95 + overhead_ms * 0.05;
+            m_pacing_stats.time_slept_ms += slept_ms;
+        }
+
+        // Spin the rest
+        const auto time_spin_start = chrono::high_resolution_clock::now();
+        while (chrono::high_resolution_clock::now() < deadline)
+        {
+            this_thread::yield();
+        }
+        m_pacing_stats.time_spun_ms += chrono::duration<double, milli>(chrono::high_resolution_clock::now() - time_spin_start).count();
+    }
+
+    void Timer::SleepFor(const double duration_ms)
+    {
+#if defined(_WIN32)
+        if (m_sleep_timer)
+        {
+            LARGE_INTEGER due_time;
+            due_time.QuadPart = -static_cast<LONGLONG>(duration_ms * 10000.0); // relative, in 100 ns units
+            if (SetWaitableTimerEx(m_sleep_timer, &due_time, 0, nullptr, nullptr, nullptr, 0))
+            {
+                WaitForSingleObject(m_sleep_timer, INFINITE);
+                return;
+            }
+        }
+#endif
+        this_thread::sleep_for(chrono::duration<double, milli>(duration_ms));
+    }
+
+    TickDependencies Timer::GetTickDependencies() const
+    {
+        // Everything else reads the delta time, so the timer ticks first and alone
+        TickDependencies dependencies;
+        dependencies.reads          = 0;
+        dependencies.writes         = Tick_Resource_Time;
+        dependencies.main_thread    = true;
+        return dependencies;
+    }
+
     void Timer::SetTargetFps(double fps_in)
     {
         if (fps_in < 0.0f) // negative -> match monitor's refresh rate
@@ -37,15 +37,26 @@ namespace Genome
         FixedToMonitor
     };
 
+    // How well the frame limiter hits its deadlines, cumulative. Only frames which are limited count.
+    struct FramePacingStats
+    {
+        uint64_t frames             = 0;
+        uint64_t deadlines_missed   = 0;    // frames which ended noticeably later than their deadline
+        double jitter_ms            = 0.0;  // absolute differences between the frame time and the target frame time, summed
+        double time_slept_ms        = 0.0;
+        double time_spun_ms         = 0.0;
+    };
+
     class GENOME_CLASS Timer : public ISubsystem
     {
     public:
         Timer(Context* context);
-        ~Timer() = default;
+        ~Timer();
 
-        //= ISybsystem ======================
+        //= ISybsystem =======================================
         void Tick(float delta_time) override;
-        //===================================
+        TickDependencies GetTickDependencies() const override;
+        //====================================================
 
         //= FPS ==============================================
         void SetTargetFps(double fps);
@@ -54,6 +65,11 @@ namespace Genome
         FpsLimitType GetFpsLimitType();
         //====================================================
 
+        //= FRAME PACING =====================================================================
+        const FramePacingStats& GetFramePacingStats()   const { return m_pacing_stats; }
+        double GetSleepOverheadMs()                     const { return m_sleep_overhead_ms; }
+        //====================================================================================
+
         auto GetTimeMs()                const { return m_time_ms; }
         auto GetTimeSec()               const { return static_cast<float>(m_time_ms / 1000.0); }
         auto GetDeltaTimeMs()           const { return m_delta_time_ms; }
@@ -62,6 +78,9 @@ namespace Genome
         auto GetDeltaTimeSmoothedSec()  const { return static_cast<float>(m_delta_time_smoothed_ms / 1000.0); }
 
     private:
+        void WaitUntil(const std::chrono::high_resolution_clock::time_point& deadline);
+        void SleepFor(double duration_ms);
+
         // Frame time
         std::chrono::high_resolution_clock::time_point m_time_start;
         std::chrono::high_resolution_clock::time_point m_time_sleep_start;
@@ -69,7 +88,12 @@ namespace Genome
         double m_time_ms                = 0.0f;
         double m_delta_time_ms          = 0.0f;
         double m_delta_time_smoothed_ms = 0.0f;
-        double m_sleep_overhead         = 0.0f;
+
+        // Frame limiter, sleeps until the last m_spin_ms (or the measured wake-up latency if it's longer) and spins the rest
+        double m_spin_ms                = 1.0;
+        double m_sleep_overhead_ms      = 0.0; // how late the OS wakes us up after sleeping, tracked as we go
+        void* m_sleep_timer             = nullptr; // high resolution waitable timer, on Windows
+        FramePacingStats m_pacing_stats;
 
         // FPS
         double m_fps_min                = 30.0;
@@ -83,9 +83,11 @@ namespace Genome
         ~Input() = default;
 
         void OnWindowData();
-        //= ISubsystem ======================
+        //= ISubsystem ====================================================================
         void Tick(float delta_time) override;
-        //===================================
+        TickDependencies GetTickDependencies() const override;
+        InitDependencies GetInitDependencies() const override { return InitAfter<>(true); }
+        //=================================================================================
         
         // Keys
         bool GetKey(const KeyCode key)      { return m_keys[static_cast<uint32_t>(key)]; }                                  // Returns true while the button identified by KeyCode is held down.
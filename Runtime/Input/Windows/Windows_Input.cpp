@@ -314,6 +314,16 @@ namespace Genome
         m_is_new_frame = true;
     }
 
+    TickDependencies Input::GetTickDependencies() const
+    {
+        // Window messages arrive on the main thread
+        TickDependencies dependencies;
+        dependencies.reads          = 0;
+        dependencies.writes         = Tick_Resource_Input;
+        dependencies.main_thread    = true;
+        return dependencies;
+    }
+
     bool Input::GamepadVibrate(const float left_motor_speed, const float right_motor_speed) const
     {
         if (!m_gamepad_connected)
@@ -19,12 +19,15 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ===============
+//= INCLUDES =================
 #include "Spartan.h"
 #include "ILogger.h"
-#include <cstdarg>
+#include <thread>
+#include <fstream>
+#include <condition_variable>
+#include <algorithm>
 #include "../World/Entity.h"
-//==========================
+//============================
 
 //= NAMESPACES ===============
 using namespace std;
@@ -37,104 +40,434 @@ namespace Genome
     ofstream Log::m_fout;
     mutex Log::m_mutex_log;
     vector<LogCmd> Log::m_log_buffer;
-    string Log::m_log_file_name = "log.txt";
-    bool Log::m_log_to_file     = true; // start logging to file (unless changed by the user, e.g. Renderer initialization was successful, so logging can happen on screen)
-    bool Log::m_first_log       = true;
-   
-    // Everything resolves to this
-    void Log::Write(const char* text, const LogType type)
+    string Log::m_log_file_name     = "log.txt";
+    atomic<bool> Log::m_log_to_file = { true }; // start logging to file (unless changed by the user, e.g. Renderer initialization was successful, so logging can happen on screen)
+    bool Log::m_first_log           = true;
+
+    // Logs are recorded back to back into a ring buffer, a record doesn't wrap around (the end is skipped if it doesn't fit)
+    struct LogRecord
     {
-        if (!text)
+        uint32_t size       = 0; // including the arguments and the strings which follow, 0 marks skipped space
+        uint32_t arg_count  = 0;
+        LogType type        = LogType::Info;
+        uint64_t sequence   = 0; // orders the logs of different threads
+        const char* function;
+        const char* format;
+    };
+
+    static const uint32_t log_buffer_size       = 64 * 1024; // per thread
+    static const uint32_t log_record_size_max   = 4 * 1024;  // longer string arguments are truncated
+    static const uint32_t log_record_alignment  = alignof(LogRecord);
+
+    // Single producer (the owning thread), single consumer (the logging thread)
+    struct LogBuffer
+    {
+        alignas(64) atomic<uint64_t> head   = 0; // bytes written
+        alignas(64) atomic<uint64_t> tail   = 0; // bytes consumed
+        atomic<bool> is_orphaned            = false; // the owning thread has exited
+        alignas(LogRecord) uint8_t data[log_buffer_size];
+    };
+
+    // Owns the buffers and the thread which formats and writes out what they contain
+    // Set while the calling thread holds Log::m_mutex_log and writes out, a log from within (e.g. a logger which logs) mustn't lock again
+    static thread_local bool log_is_outputting = false;
+
+    class LogWriter
+    {
+    public:
+        LogWriter()
         {
-            LOG_ERROR_INVALID_PARAMETER();
-            return;
+            m_thread = thread(&LogWriter::ThreadLoop, this);
         }
 
-        lock_guard<mutex> guard(m_mutex_log);
+        ~LogWriter()
+        {
+            {
+                lock_guard<mutex> lock(m_mutex_wake);
+                m_stopping = true;
+            }
+            m_condition_var.notify_one();
+            m_thread.join();
+
+            // Whatever was logged while stopping, nothing is left to fill a gap now
+            Drain(true);
+        }
 
-        const bool log_to_file = m_logger.expired() || m_log_to_file;
+        shared_ptr<LogBuffer> CreateBuffer()
+        {
+            auto buffer = make_shared<LogBuffer>();
 
-        if (log_to_file)
+            lock_guard<mutex> lock(m_mutex_buffers);
+            m_buffers.emplace_back(buffer);
+            return buffer;
+        }
+
+        void WakeUp()                           { m_condition_var.notify_one(); }
+        bool IsWriterThread()           const   { return this_thread::get_id() == m_thread.get_id(); }
+        uint64_t GetSequenceNext()              { return m_sequence.fetch_add(1, memory_order_relaxed); }
+        uint64_t GetSequenceCount()     const   { return m_sequence.load(memory_order_relaxed); }
+        uint64_t GetSequenceWritten()   const   { return m_sequence_written.load(memory_order_acquire); }
+
+        // A sequence is handed out before its record is published, so unless write_all is set only the records which follow on
+        // from the ones already written are, the rest stay in their buffers until the gap before them is filled.
+        void Drain(const bool write_all = false)
         {
-            m_log_buffer.emplace_back(text, type);
-            LogToFile(text, type);
+            vector<shared_ptr<LogBuffer>> buffers;
+            {
+                lock_guard<mutex> lock(m_mutex_buffers);
+                buffers = m_buffers;
+            }
+
+            // Collect everything which has been committed so far
+            struct Pending { const LogRecord* record; uint64_t sequence; uint32_t buffer; uint64_t end; };
+            vector<Pending> pending;
+            vector<uint64_t> tails(buffers.size());
+            for (uint32_t i = 0; i < static_cast<uint32_t>(buffers.size()); i++)
+            {
+                LogBuffer& buffer   = *buffers[i];
+                const uint64_t head = buffer.head.load(memory_order_acquire);
+                tails[i]            = buffer.tail.load(memory_order_relaxed);
+
+                for (uint64_t position = tails[i]; position < head;)
+                {
+                    const LogRecord* record = reinterpret_cast<const LogRecord*>(&buffer.data[position % log_buffer_size]);
+                    if (record->size == 0)
+                    {
+                        position += log_buffer_size - (position % log_buffer_size); // skipped space at the end
+                        continue;
+                    }
+
+                    position += record->size;
+                    pending.push_back({ record, record->sequence, i, position });
+                }
+            }
+
+            // Format and write out, in the order they were logged in
+            sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) { return a.sequence < b.sequence; });
+            uint64_t sequence_written = m_sequence_written.load(memory_order_relaxed);
+            {
+                lock_guard<mutex> guard(Log::m_mutex_log);
+                log_is_outputting = true;
+                for (const Pending& entry : pending)
+                {
+                    if (!write_all && entry.sequence != sequence_written)
+                        break;
+
+                    LogType type;
+                    const string text = Format(entry.record, &type);
+                    Log::Output(text, type);
+                    sequence_written    = max(sequence_written, entry.sequence + 1);
+                    tails[entry.buffer] = entry.end;
+                }
+                Log::m_fout.flush();
+                log_is_outputting = false;
+            }
+
+            // Hand the space of what was written back to the producers
+            for (uint32_t i = 0; i < static_cast<uint32_t>(buffers.size()); i++)
+            {
+                buffers[i]->tail.store(tails[i], memory_order_release);
+            }
+            m_sequence_written.store(sequence_written, memory_order_release);
+
+            // Forget the buffers of threads which have exited, once they are empty
+            {
+                lock_guard<mutex> lock(m_mutex_buffers);
+                m_buffers.erase(remove_if(m_buffers.begin(), m_buffers.end(), [](const shared_ptr<LogBuffer>& buffer)
+                {
+                    return buffer->is_orphaned.load(memory_order_acquire) && buffer->tail.load(memory_order_relaxed) == buffer->head.load(memory_order_acquire);
+                }), m_buffers.end());
+            }
         }
-        else
+
+        // Expands a printf style format with the captured arguments. Every conversion is formatted with the type the argument was
+        // captured as (e.g. %d of an unsigned is printed as a 64-bit integer), so a mismatching conversion can't read garbage.
+        static string Format(const LogRecord* record, LogType* type)
         {
-            FlushBuffer();
-            LogString(text, type);
+            *type = record->type;
+
+            const LogArg* args      = reinterpret_cast<const LogArg*>(record + 1);
+            uint32_t arg_index      = 0;
+            auto next_arg           = [&]() -> const LogArg* { return arg_index < record->arg_count ? &args[arg_index++] : nullptr; };
+
+            string text;
+            if (record->function)
+            {
+                text = record->function;
+                text += ": ";
+            }
+
+            char buffer[512];
+            for (const char* c = record->format; *c; c++)
+            {
+                if (*c != '%')
+                {
+                    text += *c;
+                    continue;
+                }
+
+                if (*(c + 1) == '%')
+                {
+                    text += '%';
+                    c++;
+                    continue;
+                }
+
+                // Flags, width and precision are kept, length modifiers are replaced according to the argument
+                string spec = "%";
+                const char* s = c + 1;
+                for (; *s && strchr("-+ #0123456789.*", *s); s++)
+                {
+                    if (*s == '*')
+                    {
+                        const LogArg* arg = next_arg();
+                        spec += to_string(arg ? (arg->kind == LogArg::Kind::Double ? static_cast<int64_t>(arg->d) : arg->i) : 0);
+                        continue;
+                    }
+
+                    spec += *s;
+                }
+                for (; *s && strchr("hlLqjzt", *s); s++);
+                if (!*s)
+                    break;
+
+                c = s;
+                const char conversion = *s;
+                const LogArg* arg     = next_arg();
+                if (!arg)
+                    continue;
+
+                switch (conversion)
+                {
+                    case 'd': case 'i':
+                        snprintf(buffer, sizeof(buffer), (spec + "lld").c_str(), static_cast<long long>(arg->kind == LogArg::Kind::Double ? static_cast<int64_t>(arg->d) : arg->i));
+                        break;
+                    case 'u': case 'x': case 'X': case 'o':
+                        snprintf(buffer, sizeof(buffer), (spec + "ll" + conversion).c_str(), static_cast<unsigned long long>(arg->kind == LogArg::Kind::Double ? static_cast<uint64_t>(arg->d) : arg->u));
+                        break;
+                    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                        snprintf(buffer, sizeof(buffer), (spec + conversion).c_str(), arg->kind == LogArg::Kind::Double ? arg->d : arg->kind == LogArg::Kind::Int ? static_cast<double>(arg->i) : static_cast<double>(arg->u));
+                        break;
+                    case 'c':
+                        snprintf(buffer, sizeof(buffer), (spec + "c").c_str(), static_cast<int>(arg->i));
+                        break;
+                    case 's':
+                        snprintf(buffer, sizeof(buffer), (spec + "s").c_str(), arg->kind == LogArg::Kind::String ? arg->s : "(invalid)");
+                        if (arg->kind == LogArg::Kind::String && spec == "%")
+                        {
+                            text += arg->s; // not limited by the buffer
+                            continue;
+                        }
+                        break;
+                    case 'p':
+                        snprintf(buffer, sizeof(buffer), (spec + "p").c_str(), arg->p);
+                        break;
+                    default:
+                        buffer[0] = 0;
+                        break;
+                }
+
+                text += buffer;
+            }
+
+            return text;
         }
-    }
 
-    void Log::WriteFInfo(const char* text, ...)
+    private:
+        void ThreadLoop()
+        {
+            while (true)
+            {
+                {
+                    unique_lock<mutex> lock(m_mutex_wake);
+                    m_condition_var.wait_for(lock, chrono::milliseconds(10), [this]() { return m_stopping; });
+                    if (m_stopping)
+                        return;
+                }
+
+                Drain();
+            }
+        }
+
+        thread m_thread;
+        bool m_stopping = false;
+        mutex m_mutex_wake;
+        condition_variable m_condition_var;
+        vector<shared_ptr<LogBuffer>> m_buffers;
+        mutex m_mutex_buffers;
+        atomic<uint64_t> m_sequence         = 0;
+        atomic<uint64_t> m_sequence_written = 0;
+    };
+
+    // Null while the program starts up or shuts down, logs are written out directly then
+    static atomic<LogWriter*> log_writer = nullptr;
+
+    static LogWriter* GetLogWriter()
     {
-        char buffer[1024];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text, args);
-        va_end(args);
+        static LogWriter writer;
+        static struct Registration
+        {
+            Registration()  { log_writer.store(&writer, memory_order_release); }
+            ~Registration() { log_writer.store(nullptr, memory_order_release); }
+        } registration;
 
-        Write(buffer, LogType::Info);
+        return log_writer.load(memory_order_acquire);
     }
 
-    void Log::WriteFWarning(const char* text, ...)
+    // The buffer of the calling thread, it's handed over to the writer when the thread exits
+    struct LogBufferOwner
     {
-        char buffer[1024];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text, args);
-        va_end(args);
+        ~LogBufferOwner()
+        {
+            if (buffer)
+            {
+                buffer->is_orphaned.store(true, memory_order_release);
+            }
+        }
 
-        Write(buffer, LogType::Warning);
-    }
+        shared_ptr<LogBuffer> buffer;
+    };
+    static thread_local LogBufferOwner log_buffer_owner;
 
-    void Log::WriteFError(const char* text, ...)
+    void Log::Push(const LogType type, const char* function, const char* format, const LogArg* args, const uint32_t arg_count)
     {
-        char buffer[1024];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text, args);
-        va_end(args);
+        LogWriter* writer = GetLogWriter();
+
+        // Measure the record, arguments are followed by the strings they point to
+        uint32_t size = sizeof(LogRecord) + arg_count * sizeof(LogArg);
+        for (uint32_t i = 0; i < arg_count; i++)
+        {
+            if (args[i].kind == LogArg::Kind::String)
+            {
+                size += static_cast<uint32_t>(min(strlen(args[i].s), static_cast<size_t>(log_record_size_max))) + 1;
+            }
+        }
+        size = min(size, log_record_size_max + static_cast<uint32_t>(sizeof(LogRecord) + arg_count * sizeof(LogArg)));
+        size = (size + log_record_alignment - 1) & ~(log_record_alignment - 1);
+
+        // The logging thread itself (e.g. a logger which logs), startup and shutdown, and absurd argument counts are written out directly
+        if (!writer || writer->IsWriterThread() || size > log_buffer_size / 4)
+        {
+            vector<uint8_t> storage(size + log_record_alignment);
+            LogRecord* record   = new (storage.data()) LogRecord();
+            record->arg_count   = arg_count;
+            record->type        = type;
+            record->function    = function;
+            record->format      = format;
+            memcpy(record + 1, args, arg_count * sizeof(LogArg));
+
+            LogType type_out;
+            const string text = LogWriter::Format(record, &type_out);
+
+            // Already holding the lock, this log comes from within the output of another one
+            if (log_is_outputting)
+            {
+                Output(text, type_out);
+                return;
+            }
+
+            lock_guard<mutex> guard(m_mutex_log);
+            log_is_outputting = true;
+            Output(text, type_out);
+            log_is_outputting = false;
+            return;
+        }
+
+        if (!log_buffer_owner.buffer)
+        {
+            log_buffer_owner.buffer = writer->CreateBuffer();
+        }
+        LogBuffer& buffer = *log_buffer_owner.buffer;
+
+        // Skip the end of the buffer if the record doesn't fit there
+        uint64_t head           = buffer.head.load(memory_order_relaxed);
+        const uint32_t offset   = static_cast<uint32_t>(head % log_buffer_size);
+        const uint32_t skip     = (offset + size > log_buffer_size) ? log_buffer_size - offset : 0;
+
+        // Wait for the logging thread to make room, this only happens if a thread logs a lot in a very short time
+        while (head + skip + size - buffer.tail.load(memory_order_acquire) > log_buffer_size)
+        {
+            writer->WakeUp();
+            this_thread::yield();
+        }
+
+        if (skip != 0)
+        {
+            reinterpret_cast<LogRecord*>(&buffer.data[offset])->size = 0;
+            head += skip;
+        }
+
+        // Write the record
+        uint8_t* data       = &buffer.data[head % log_buffer_size];
+        LogRecord* record   = new (data) LogRecord();
+        record->size        = size;
+        record->arg_count   = arg_count;
+        record->type        = type;
+        record->sequence    = writer->GetSequenceNext();
+        record->function    = function;
+        record->format      = format;
+
+        LogArg* record_args = reinterpret_cast<LogArg*>(record + 1);
+        char* strings       = reinterpret_cast<char*>(record_args + arg_count);
+        char* strings_end   = reinterpret_cast<char*>(data + size);
+        for (uint32_t i = 0; i < arg_count; i++)
+        {
+            record_args[i] = args[i];
+
+            if (args[i].kind == LogArg::Kind::String)
+            {
+                const size_t length = min(strlen(args[i].s), static_cast<size_t>(strings_end - strings - 1));
+                memcpy(strings, args[i].s, length);
+                strings[length]  = 0;
+                record_args[i].s = strings;
+                strings += length + 1;
+            }
+        }
+
+        buffer.head.store(head + size, memory_order_release);
 
-        Write(buffer, LogType::Error);
+        // Errors are written out right away, the program might be about to go down
+        if (type == LogType::Error)
+        {
+            writer->WakeUp();
+        }
     }
 
-    void Log::Write(const string& text, const LogType type)
+    void Log::Flush()
     {
-        Write(text.c_str(), type);
+        LogWriter* writer = GetLogWriter();
+        if (!writer || writer->IsWriterThread())
+            return;
+
+        // Everything up to the last record handed out (a record logged after this point doesn't have to be waited for)
+        const uint64_t sequence = writer->GetSequenceCount();
+        while (writer->GetSequenceWritten() < sequence)
+        {
+            writer->WakeUp();
+            this_thread::yield();
+        }
     }
 
-    void Log::WriteFInfo(const string text, ...)
+    void Log::SetLogger(const weak_ptr<ILogger>& logger)
     {
-        char buffer[2048];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text.c_str(), args);
-        va_end(args);
-
-        Write(buffer, LogType::Info);
+        lock_guard<mutex> guard(m_mutex_log);
+        m_logger = logger;
     }
 
-    void Log::WriteFWarning(const string text, ...)
+    void Log::Write(const char* text, const LogType type)
     {
-        char buffer[2048];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text.c_str(), args);
-        va_end(args);
+        if (!text)
+        {
+            LOG_ERROR_INVALID_PARAMETER();
+            return;
+        }
 
-        Write(buffer, LogType::Warning);
+        WriteF(type, nullptr, "%s", text);
     }
 
-    void Log::WriteFError(const string text, ...)
+    void Log::Write(const string& text, const LogType type)
     {
-        char buffer[2048];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text.c_str(), args);
-        va_end(args);
-
-        Write(buffer, LogType::Error);
+        Write(text.c_str(), type);
     }
 
     void Log::Write(const weak_ptr<Entity>& entity, const LogType type)
@@ -172,17 +505,35 @@ namespace Genome
         Write(value.ToString(), type);
     }
 
+    // Everything resolves to this, on the logging thread
+    void Log::Output(const string& text, const LogType type)
+    {
+        const bool log_to_file = m_logger.expired() || m_log_to_file.load(memory_order_relaxed);
+
+        if (log_to_file)
+        {
+            m_log_buffer.emplace_back(text, type);
+            LogToFile(text, type);
+        }
+        else
+        {
+            FlushBuffer();
+            LogString(text.c_str(), type);
+        }
+    }
+
     void Log::FlushBuffer()
     {
         if (m_logger.expired() || m_log_buffer.empty())
             return;
 
-         // Log everything from memory to the logger implementation
-        for (const auto& log : m_log_buffer)
+         // Log everything from memory to the logger implementation, the buffer is taken first as the logger can log too
+        vector<LogCmd> log_buffer;
+        log_buffer.swap(m_log_buffer);
+        for (const auto& log : log_buffer)
         {
             LogString(log.text.c_str(), log.type);
         }
-        m_log_buffer.clear();
     }
 
     void Log::LogString(const char* text, const LogType type)
@@ -193,37 +544,27 @@ namespace Genome
             return;
         }
 
-        m_logger.lock()->Log(string(text), static_cast<uint32_t>(type));
-    }
-
-    void Log::LogToFile(const char* text, const LogType type)
-    {
-        if (!text)
+        if (shared_ptr<ILogger> logger = m_logger.lock())
         {
-            LOG_ERROR_INVALID_PARAMETER();
-            return;
+            logger->Log(string(text), static_cast<uint32_t>(type));
         }
+    }
 
-        const string prefix        = (type == LogType::Info) ? "Info:" : (type == LogType::Warning) ? "Warning:" : "Error:";
-        const auto final_text    = prefix + " " + text;
+    void Log::LogToFile(const string& text, const LogType type)
+    {
+        const char* prefix = (type == LogType::Info) ? "Info: " : (type == LogType::Warning) ? "Warning: " : "Error: ";
 
-        // Delete the previous log file (if it exists)
+        // Replace the previous log file (if it exists), the file then stays open
         if (m_first_log)
         {
             FileSystem::Delete(m_log_file_name);
+            m_fout.open(m_log_file_name, ofstream::out | ofstream::trunc);
             m_first_log = false;
         }
 
-        // Open/Create a log file to write the error message to
-        m_fout.open(m_log_file_name, ofstream::out | ofstream::app);
-
         if (m_fout.is_open())
         {
-            // Write out the error message
-            m_fout << final_text << endl;
-
-            // Close the file
-            m_fout.close();
+            m_fout << prefix << text << '\n';
         }
     }
 }
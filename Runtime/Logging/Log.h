@@ -19,6 +19,7 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+
 #pragma once
 
 //= INCLUDES ===========================
@@ -26,15 +27,41 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <memory>
 #include <mutex>
 #include <vector>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
 #include "../Core/Spartan_Definitions.h"
 #include "ILogger.h"
 //======================================
 
+// Compile time verbosity, logs above SP_LOG_LEVEL compile to nothing (their arguments aren't evaluated either)
+#define SP_LOG_LEVEL_NONE       0
+#define SP_LOG_LEVEL_ERROR      1
+#define SP_LOG_LEVEL_WARNING    2
+#define SP_LOG_LEVEL_INFO       3
+#ifndef SP_LOG_LEVEL
+#define SP_LOG_LEVEL SP_LOG_LEVEL_INFO
+#endif
+
 namespace Genome
 {
-    #define LOG_INFO(text, ...)        { Genome::Log::WriteFInfo(std::string(__FUNCTION__)    + ": " + std::string(text), __VA_ARGS__); }
-    #define LOG_WARNING(text, ...)    { Genome::Log::WriteFWarning(std::string(__FUNCTION__) + ": " + std::string(text), __VA_ARGS__); }
-    #define LOG_ERROR(text, ...)    { Genome::Log::WriteFError(std::string(__FUNCTION__)   + ": " + std::string(text), __VA_ARGS__); }
+    // The text must be a string literal, it's formatted later, on the logging thread
+    #if SP_LOG_LEVEL >= SP_LOG_LEVEL_INFO
+    #define LOG_INFO(text, ...)         { Genome::Log::WriteF(Genome::LogType::Info, __FUNCTION__, "" text, ##__VA_ARGS__); }
+    #else
+    #define LOG_INFO(text, ...)         {}
+    #endif
+    #if SP_LOG_LEVEL >= SP_LOG_LEVEL_WARNING
+    #define LOG_WARNING(text, ...)      { Genome::Log::WriteF(Genome::LogType::Warning, __FUNCTION__, "" text, ##__VA_ARGS__); }
+    #else
+    #define LOG_WARNING(text, ...)      {}
+    #endif
+    #if SP_LOG_LEVEL >= SP_LOG_LEVEL_ERROR
+    #define LOG_ERROR(text, ...)        { Genome::Log::WriteF(Genome::LogType::Error, __FUNCTION__, "" text, ##__VA_ARGS__); }
+    #else
+    #define LOG_ERROR(text, ...)        {}
+    #endif
 
     // Standard errors
     #define LOG_ERROR_GENERIC_FAILURE()        LOG_ERROR("Failed.")
@@ -74,6 +101,75 @@ namespace Genome
         LogType type;
     };
 
+    // An argument of a log, as captured by the calling thread. Strings are copied, everything else is kept by value.
+    struct LogArg
+    {
+        enum class Kind : uint8_t
+        {
+            Int,
+            Uint,
+            Double,
+            Pointer,
+            String
+        };
+
+        Kind kind = Kind::Int;
+        union
+        {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const void* p;
+            const char* s;
+        };
+
+        template <typename T>
+        static LogArg From(const T& value)
+        {
+            LogArg arg;
+
+            if constexpr (std::is_same_v<T, std::string>)
+            {
+                arg.kind = Kind::String;
+                arg.s    = value.c_str();
+            }
+            else if constexpr (std::is_convertible_v<const T&, const char*>)
+            {
+                arg.kind = Kind::String;
+                arg.s    = value ? static_cast<const char*>(value) : "(null)";
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                arg.kind = Kind::Int;
+                arg.i    = static_cast<int64_t>(value);
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                arg.kind = Kind::Double;
+                arg.d    = static_cast<double>(value);
+            }
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            {
+                arg.kind = Kind::Int;
+                arg.i    = static_cast<int64_t>(value);
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                arg.kind = Kind::Uint;
+                arg.u    = static_cast<uint64_t>(value);
+            }
+            else
+            {
+                static_assert(std::is_pointer_v<T>, "Unsupported log argument type");
+                arg.kind = Kind::Pointer;
+                arg.p    = static_cast<const void*>(value);
+            }
+
+            return arg;
+        }
+    };
+
+    // Logs are written into a lock-free buffer of the calling thread, a logging thread formats them and writes them out in batches
     class GENOME_CLASS Log
     {
         friend class ILogger;
@@ -81,17 +177,20 @@ namespace Genome
         Log() = default;
 
         // Set a logger to be used (if not set, logging will done in a text file.
-        static void SetLogger(const std::weak_ptr<ILogger>& logger) { m_logger = logger; }
+        static void SetLogger(const std::weak_ptr<ILogger>& logger);
+
+        // Format (printf style) and arguments are captured, formatting happens on the logging thread. The format and the function
+        // name must outlive the program (string literals do), string arguments are copied.
+        template <typename... Args>
+        static void WriteF(const LogType type, const char* function, const char* format, const Args&... args)
+        {
+            const std::array<LogArg, sizeof...(Args)> log_args = { LogArg::From(args)... };
+            Push(type, function, format, log_args.data(), static_cast<uint32_t>(log_args.size()));
+        }
 
         // Alpha
         static void Write(const char* text, const LogType type);
-        static void WriteFInfo(const char* text, ...);
-        static void WriteFWarning(const char* text, ...);
-        static void WriteFError(const char* text, ...);
         static void Write(const std::string& text, const LogType type);
-        static void WriteFInfo(const std::string text, ...);
-        static void WriteFWarning(const std::string text, ...);
-        static void WriteFError(const std::string text, ...);
 
         // Numeric
         template <class T, class = typename std::enable_if<
@@ -124,12 +223,20 @@ namespace Genome
         static void Write(const std::weak_ptr<Entity>& entity, LogType type);
         static void Write(const std::shared_ptr<Entity>& entity, LogType type);
 
-        static bool m_log_to_file;     
+        // Blocks until everything logged so far has been written out
+        static void Flush();
+
+        static std::atomic<bool> m_log_to_file;
 
     private:
+        static void Push(LogType type, const char* function, const char* format, const LogArg* args, uint32_t arg_count);
+
+        // Logging thread
+        friend class LogWriter;
+        static void Output(const std::string& text, LogType type);
         static void FlushBuffer();
         static void LogString(const char* text, LogType type);
-        static void LogToFile(const char* text, LogType type);
+        static void LogToFile(const std::string& text, LogType type);
 
         static std::mutex m_mutex_log;
         static std::weak_ptr<ILogger> m_logger;
@@ -94,6 +94,10 @@ namespace Genome
         m_renderer = m_context->GetSubsystem<Renderer>();
         m_profiler = m_context->GetSubsystem<Profiler>();
 
+        // Metrics
+        m_metric_bodies     = m_profiler->RegisterGauge("physics/collision_objects");
+        m_metric_step_time  = m_profiler->RegisterHistogram("physics/step_time", "ms");
+
         // Get version
         const auto major = to_string(btGetVersion() / 100);
         const auto minor = to_string(btGetVersion()).erase(0, 1);
@@ -116,6 +120,8 @@ namespace Genome
     {
         if (!m_world)
             return;
+
+        m_profiler->GaugeSet(m_metric_bodies, static_cast<double>(m_world->getNumCollisionObjects()));
         
         // Debug draw
         if (m_renderer->GetOptions() & Render_Debug_Physics)
@@ -143,9 +149,21 @@ namespace Genome
         }
 
         // Step the physics world. 
+        const Stopwatch stopwatch;
         m_simulating = true;
         m_world->stepSimulation(delta_time_sec, max_substeps, internal_time_step);
         m_simulating = false;
+        m_profiler->HistogramRecord(m_metric_step_time, stopwatch.GetElapsedTimeMs());
+    }
+
+    TickDependencies Physics::GetTickDependencies() const
+    {
+        // Writes rigid body transforms back to the world, debug draw goes into the renderer's line buffers
+        TickDependencies dependencies;
+        dependencies.reads          = Tick_Resource_Time | Tick_Resource_Renderer;
+        dependencies.writes         = Tick_Resource_Physics | Tick_Resource_World | Tick_Resource_Renderer;
+        dependencies.main_thread    = false;
+        return dependencies;
     }
 
     void Physics::AddBody(btRigidBody* body) const
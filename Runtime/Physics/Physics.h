@@ -21,10 +21,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ==================
+//= INCLUDES ====================
 #include "../Core/ISubsystem.h"
 #include "../Math/Vector3.h"
-//=============================
+#include "../Profiling/Metrics.h"
+//===============================
 
 //= FORWARD DECLARATIONS =================
 class btBroadphaseInterface;
@@ -52,10 +53,12 @@ namespace Genome
         Physics(Context* context);
         ~Physics();
 
-        //= Subsystem =======================
+        //= Subsystem =================================================================
         bool Initialize() override;
         void Tick(float delta_time) override;
-        //===================================
+        TickDependencies GetTickDependencies() const override;
+        InitDependencies GetInitDependencies() const override { return InitAfter<>(); }
+        //=============================================================================
 
         // Rigid body
         void AddBody(btRigidBody* body) const;
@@ -94,6 +97,10 @@ namespace Genome
         float m_internal_fps        = 60.0f;
         Math::Vector3 m_gravity     = Math::Vector3(0.0f, -9.81f, 0.0f);
         bool m_simulating           = false;
+
+        // Metrics
+        MetricId m_metric_bodies    = MetricRegistry::capacity;
+        MetricId m_metric_step_time = MetricRegistry::capacity;
         //==============================================================
     };
 }
@@ -0,0 +1,106 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ====================
+#include "Spartan.h"
+#include "AllocationTracker.h"
+//===============================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Genome
+{
+    // The totals of a thread, on a cache line of their own so that threads don't contend
+    struct alignas(64) AllocationSlot
+    {
+        atomic<uint64_t> count = 0;
+        atomic<uint64_t> bytes = 0;
+    };
+
+    // A slot per thread, threads past the last one share it. Plain arrays and PODs, so none of it allocates or needs constructing at
+    // runtime, operator new can be called before main() and during thread creation.
+    static const uint32_t allocation_slot_count = 256;
+    static AllocationSlot allocation_slots[allocation_slot_count];
+    static atomic<uint32_t> allocation_slot_next = 0;
+    static atomic<bool> allocation_tracking      = false;
+    static thread_local AllocationSlot* allocation_slot = nullptr;
+
+    static AllocationSlot* allocation_get_slot()
+    {
+        if (!allocation_slot)
+        {
+            const uint32_t index    = allocation_slot_next.fetch_add(1, memory_order_relaxed);
+            allocation_slot         = &allocation_slots[min(index, allocation_slot_count - 1)];
+        }
+
+        return allocation_slot;
+    }
+
+    void AllocationTracker::Count(const size_t size)
+    {
+        if (!allocation_tracking.load(memory_order_relaxed))
+            return;
+
+        AllocationSlot* slot = allocation_get_slot();
+        if (slot == &allocation_slots[allocation_slot_count - 1])
+        {
+            slot->count.fetch_add(1, memory_order_relaxed);
+            slot->bytes.fetch_add(size, memory_order_relaxed);
+        }
+        else
+        {
+            // Only this thread writes, so there is no need for a read-modify-write
+            slot->count.store(slot->count.load(memory_order_relaxed) + 1, memory_order_relaxed);
+            slot->bytes.store(slot->bytes.load(memory_order_relaxed) + size, memory_order_relaxed);
+        }
+    }
+
+    void AllocationTracker::SetEnabled(const bool enabled)
+    {
+        allocation_tracking.store(enabled, memory_order_relaxed);
+    }
+
+    bool AllocationTracker::IsEnabled()
+    {
+        return allocation_tracking.load(memory_order_relaxed);
+    }
+
+    AllocationCount AllocationTracker::GetThread()
+    {
+        const AllocationSlot* slot = allocation_get_slot();
+        return { slot->count.load(memory_order_relaxed), slot->bytes.load(memory_order_relaxed) };
+    }
+
+    AllocationCount AllocationTracker::GetTotal()
+    {
+        AllocationCount total;
+        const uint32_t slot_count = min(allocation_slot_next.load(memory_order_relaxed), allocation_slot_count);
+        for (uint32_t i = 0; i < slot_count; i++)
+        {
+            total.count += allocation_slots[i].count.load(memory_order_relaxed);
+            total.bytes += allocation_slots[i].bytes.load(memory_order_relaxed);
+        }
+
+        return total;
+    }
+}
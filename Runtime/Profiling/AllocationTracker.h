@@ -0,0 +1,58 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <cstdint>
+#include "../Core/Spartan_Definitions.h"
+//================================
+
+namespace Genome
+{
+    // Heap allocations (through operator new), running totals which only grow.
+    // The difference between two reads is what was allocated in between.
+    struct AllocationCount
+    {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+
+        AllocationCount operator-(const AllocationCount& other) const { return { count - other.count, bytes - other.bytes }; }
+        AllocationCount& operator+=(const AllocationCount& other) { count += other.count; bytes += other.bytes; return *this; }
+    };
+
+    // Counts the allocations of every thread. An executable built with SP_TRACK_ALLOCATIONS replaces the global operator new/delete
+    // (see AllocationTracker_Operators.h), but counting is opt-in, until it's enabled an allocation costs a branch more than it would otherwise.
+    class GENOME_CLASS AllocationTracker
+    {
+    public:
+        static void SetEnabled(bool enabled);
+        static bool IsEnabled();
+
+        // The calling thread's totals, cheap enough to read around every time block
+        static AllocationCount GetThread();
+        // The totals of all threads
+        static AllocationCount GetTotal();
+
+        // Called by the replaced operator new
+        static void Count(size_t size);
+    };
+}
@@ -0,0 +1,113 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =================
+#include <cstdlib>
+#include <new>
+#include "AllocationTracker.h"
+//============================
+
+// The global operator new/delete which AllocationTracker counts with. The runtime doesn't replace them itself, an executable which
+// is built with SP_TRACK_ALLOCATIONS includes this in one of its source files (and only one).
+#if SP_TRACK_ALLOCATIONS == 1
+namespace Genome
+{
+    static void* allocation_allocate(size_t size)
+    {
+        AllocationTracker::Count(size);
+        return malloc(size != 0 ? size : 1);
+    }
+
+    static void* allocation_allocate_aligned(size_t size, const size_t alignment)
+    {
+        AllocationTracker::Count(size);
+        size = size != 0 ? size : 1;
+#ifdef _MSC_VER
+        return _aligned_malloc(size, alignment);
+#else
+        return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    }
+
+    static void allocation_free_aligned(void* pointer)
+    {
+#ifdef _MSC_VER
+        _aligned_free(pointer);
+#else
+        free(pointer);
+#endif
+    }
+}
+
+//= GLOBAL OPERATOR NEW/DELETE ======================================================================================
+void* operator new(size_t size)
+{
+    if (void* pointer = Genome::allocation_allocate(size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if (void* pointer = Genome::allocation_allocate(size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    if (void* pointer = Genome::allocation_allocate_aligned(size, static_cast<size_t>(alignment)))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    if (void* pointer = Genome::allocation_allocate_aligned(size, static_cast<size_t>(alignment)))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept                                  { return Genome::allocation_allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept                                { return Genome::allocation_allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept      { return Genome::allocation_allocate_aligned(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept    { return Genome::allocation_allocate_aligned(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* pointer) noexcept                                                     { free(pointer); }
+void operator delete[](void* pointer) noexcept                                                   { free(pointer); }
+void operator delete(void* pointer, size_t) noexcept                                             { free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept                                           { free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept                              { free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept                            { free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept                                   { Genome::allocation_free_aligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept                                 { Genome::allocation_free_aligned(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept                           { Genome::allocation_free_aligned(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept                         { Genome::allocation_free_aligned(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept            { Genome::allocation_free_aligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept          { Genome::allocation_free_aligned(pointer); }
+//===================================================================================================================
+#endif
@@ -0,0 +1,311 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =======
+#include "Spartan.h"
+#include "Metrics.h"
+#include <cmath>
+//==================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Genome
+{
+    // Buckets: one for anything below 2^exponent_min, then sub_bucket_count per power of two, up to 2^(exponent_min + octave_count)
+    static const int histogram_exponent_min         = -10;
+    static const uint32_t histogram_octave_count    = 32;
+    static const uint32_t histogram_sub_bucket_count = 8;
+    static const uint32_t histogram_bucket_count    = 1 + histogram_octave_count * histogram_sub_bucket_count;
+
+    static uint32_t histogram_bucket(const double value)
+    {
+        if (!(value >= ldexp(1.0, histogram_exponent_min))) // also catches NaN
+            return 0;
+
+        // value = mantissa * 2^exponent, with the mantissa in [0.5, 1)
+        int exponent            = 0;
+        const double mantissa   = frexp(value, &exponent);
+        const int octave        = exponent - 1 - histogram_exponent_min;
+        if (octave >= static_cast<int>(histogram_octave_count))
+            return histogram_bucket_count - 1;
+
+        const uint32_t sub_bucket = static_cast<uint32_t>((mantissa * 2.0 - 1.0) * histogram_sub_bucket_count);
+        return 1 + static_cast<uint32_t>(octave) * histogram_sub_bucket_count + min(sub_bucket, histogram_sub_bucket_count - 1);
+    }
+
+    // Where in a bucket a value is assumed to be, 0.5 being the middle
+    static double histogram_bucket_value(uint32_t bucket, const double fraction)
+    {
+        if (bucket == 0)
+            return 0.0;
+
+        bucket--;
+        const int octave            = static_cast<int>(bucket / histogram_sub_bucket_count) + histogram_exponent_min;
+        const uint32_t sub_bucket   = bucket % histogram_sub_bucket_count;
+        return ldexp(1.0 + (sub_bucket + fraction) / histogram_sub_bucket_count, octave);
+    }
+
+    // A histogram of a thread, only that thread writes to it
+    struct MetricHistogram
+    {
+        atomic<uint64_t> buckets[histogram_bucket_count] = {};
+        atomic<double> sum = 0.0;
+    };
+
+    // The counters and histograms of a thread, histograms are allocated the first time the thread records into them
+    struct MetricShard
+    {
+        ~MetricShard()
+        {
+            for (atomic<MetricHistogram*>& histogram : histograms)
+            {
+                delete histogram.load(memory_order_relaxed);
+            }
+        }
+
+        atomic<int64_t> counters[MetricRegistry::capacity]                 = {};
+        atomic<MetricHistogram*> histograms[MetricRegistry::capacity]      = {};
+    };
+
+    // The calling thread's shard, per registry (so a new one starts clean)
+    static atomic<uint64_t> metric_registry_instance_count = 0;
+    struct MetricShardSlot
+    {
+        uint64_t registry_id = 0;
+        MetricShard* shard   = nullptr;
+    };
+    static thread_local MetricShardSlot metric_shard_slot;
+
+    MetricRegistry::MetricRegistry()
+    {
+        m_instance_id = ++metric_registry_instance_count;
+        m_values.reserve(capacity);
+    }
+
+    MetricRegistry::~MetricRegistry()
+    {
+        for (MetricShard* shard : m_shards)
+        {
+            delete shard;
+        }
+        m_shards.clear();
+    }
+
+    MetricId MetricRegistry::Register(const string& name, const MetricType type, const string& unit /*= ""*/)
+    {
+        lock_guard<mutex> lock(m_mutex_register);
+
+        const uint32_t count = m_count.load(memory_order_relaxed);
+        for (MetricId id = 0; id < count; id++)
+        {
+            if (m_info[id].name == name)
+            {
+                if (m_info[id].type != type)
+                {
+                    LOG_ERROR("Metric \"%s\" is already registered as a different type", name.c_str());
+                }
+
+                return id;
+            }
+        }
+
+        if (count == capacity)
+        {
+            LOG_ERROR("Can't register metric \"%s\", the registry is full", name.c_str());
+            return capacity;
+        }
+
+        m_info[count].name  = name;
+        m_info[count].unit  = unit;
+        m_info[count].type  = type;
+        m_count.store(count + 1, memory_order_release);
+
+        return count;
+    }
+
+    void MetricRegistry::CounterAdd(const MetricId id, const int64_t value /*= 1*/)
+    {
+        if (id >= capacity)
+            return;
+
+        // Only this thread writes, so there is no need for a read-modify-write
+        atomic<int64_t>& counter = GetShard()->counters[id];
+        counter.store(counter.load(memory_order_relaxed) + value, memory_order_relaxed);
+    }
+
+    void MetricRegistry::GaugeSet(const MetricId id, const double value)
+    {
+        if (id >= capacity)
+            return;
+
+        m_gauges[id].store(value, memory_order_relaxed);
+    }
+
+    void MetricRegistry::HistogramRecord(const MetricId id, const double value)
+    {
+        if (id >= capacity)
+            return;
+
+        MetricShard* shard          = GetShard();
+        MetricHistogram* histogram  = shard->histograms[id].load(memory_order_relaxed);
+        if (!histogram)
+        {
+            histogram = new MetricHistogram();
+            shard->histograms[id].store(histogram, memory_order_release);
+        }
+
+        atomic<uint64_t>& bucket = histogram->buckets[histogram_bucket(value)];
+        bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+        histogram->sum.store(histogram->sum.load(memory_order_relaxed) + value, memory_order_relaxed);
+    }
+
+    void MetricRegistry::UpdateFrame()
+    {
+        // Present the metrics which were registered since the last update
+        const uint32_t count = m_count.load(memory_order_acquire);
+        for (uint32_t id = static_cast<uint32_t>(m_values.size()); id < count; id++)
+        {
+            MetricValue& value  = m_values.emplace_back();
+            value.name          = m_info[id].name;
+            value.unit          = m_info[id].unit;
+            value.type          = m_info[id].type;
+        }
+
+        // Sum the counters of every thread
+        m_counter_sums.assign(count, 0);
+        {
+            lock_guard<mutex> lock(m_mutex_shards);
+            for (MetricShard* shard : m_shards)
+            {
+                for (uint32_t id = 0; id < count; id++)
+                {
+                    m_counter_sums[id] += shard->counters[id].load(memory_order_relaxed);
+                }
+            }
+        }
+
+        for (uint32_t id = 0; id < count; id++)
+        {
+            MetricValue& value = m_values[id];
+
+            if (value.type == MetricType::Counter)
+            {
+                value.value = static_cast<double>(m_counter_sums[id] - value.total);
+                value.total = m_counter_sums[id];
+            }
+            else if (value.type == MetricType::Gauge)
+            {
+                value.value = m_gauges[id].load(memory_order_relaxed);
+            }
+        }
+    }
+
+    void MetricRegistry::UpdateHistograms()
+    {
+        const uint32_t count = static_cast<uint32_t>(m_values.size());
+        m_histogram_buckets_previous.resize(count);
+        m_histogram_sums_previous.resize(count, 0.0);
+
+        for (uint32_t id = 0; id < count; id++)
+        {
+            MetricValue& value = m_values[id];
+            if (value.type != MetricType::Histogram)
+                continue;
+
+            // Merge the histograms of every thread, they only grow so the difference to the last update is the interval
+            m_histogram_buckets.assign(histogram_bucket_count, 0);
+            double sum = 0.0;
+            {
+                lock_guard<mutex> lock(m_mutex_shards);
+                for (MetricShard* shard : m_shards)
+                {
+                    if (MetricHistogram* histogram = shard->histograms[id].load(memory_order_acquire))
+                    {
+                        for (uint32_t bucket = 0; bucket < histogram_bucket_count; bucket++)
+                        {
+                            m_histogram_buckets[bucket] += histogram->buckets[bucket].load(memory_order_relaxed);
+                        }
+                        sum += histogram->sum.load(memory_order_relaxed);
+                    }
+                }
+            }
+
+            vector<uint64_t>& previous = m_histogram_buckets_previous[id];
+            previous.resize(histogram_bucket_count, 0);
+            value.count = 0;
+            for (uint32_t bucket = 0; bucket < histogram_bucket_count; bucket++)
+            {
+                const uint64_t total            = m_histogram_buckets[bucket];
+                m_histogram_buckets[bucket]     = total - previous[bucket];
+                previous[bucket]                = total;
+                value.count                     += m_histogram_buckets[bucket];
+            }
+            value.value                     = value.count != 0 ? (sum - m_histogram_sums_previous[id]) / static_cast<double>(value.count) : 0.0;
+            m_histogram_sums_previous[id]   = sum;
+
+            // Percentiles, the first bucket which reaches them
+            const uint64_t rank_p50 = static_cast<uint64_t>(ceil(value.count * 0.50));
+            const uint64_t rank_p95 = static_cast<uint64_t>(ceil(value.count * 0.95));
+            const uint64_t rank_p99 = static_cast<uint64_t>(ceil(value.count * 0.99));
+            value.p50 = value.p95 = value.p99 = value.max = 0.0;
+            uint64_t rank = 0;
+            for (uint32_t bucket = 0; bucket < histogram_bucket_count; bucket++)
+            {
+                const uint64_t bucket_count = m_histogram_buckets[bucket];
+                if (bucket_count == 0)
+                    continue;
+
+                const uint64_t rank_previous = rank;
+                rank += bucket_count;
+                const double bucket_value = histogram_bucket_value(bucket, 0.5);
+                if (rank_previous < rank_p50 && rank >= rank_p50) value.p50 = bucket_value;
+                if (rank_previous < rank_p95 && rank >= rank_p95) value.p95 = bucket_value;
+                if (rank_previous < rank_p99 && rank >= rank_p99) value.p99 = bucket_value;
+                value.max = histogram_bucket_value(bucket, 1.0);
+            }
+        }
+    }
+
+    const MetricValue& MetricRegistry::GetValue(const MetricId id) const
+    {
+        static const MetricValue empty;
+        return id < m_values.size() ? m_values[id] : empty;
+    }
+
+    MetricShard* MetricRegistry::GetShard()
+    {
+        if (metric_shard_slot.registry_id != m_instance_id)
+        {
+            MetricShard* shard = new MetricShard();
+            {
+                lock_guard<mutex> lock(m_mutex_shards);
+                m_shards.emplace_back(shard);
+            }
+
+            metric_shard_slot.registry_id   = m_instance_id;
+            metric_shard_slot.shard         = shard;
+        }
+
+        return metric_shard_slot.shard;
+    }
+}
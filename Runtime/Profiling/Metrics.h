@@ -0,0 +1,137 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ===========================
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../Core/Spartan_Definitions.h"
+//======================================
+
+namespace Genome
+{
+    struct MetricShard;
+    using MetricId = uint32_t;
+
+    enum class MetricType : uint8_t
+    {
+        Counter,    // added to, presented per frame (e.g. draw calls)
+        Gauge,      // set, the last value is presented (e.g. the number of rigid bodies)
+        Histogram   // recorded, presented as percentiles over the update interval (e.g. load latencies)
+    };
+
+    // The metrics of the engine itself, they are registered (in this order) before any other, so their ids are known up front
+    enum class Metric : MetricId
+    {
+        RendererMeshesRendered,
+        RhiDraw,
+        RhiDispatch,
+        RhiBindingsBufferIndex,
+        RhiBindingsBufferVertex,
+        RhiBindingsBufferConstant,
+        RhiBindingsSampler,
+        RhiBindingsTextureSampled,
+        RhiBindingsTextureStorage,
+        RhiBindingsShaderVertex,
+        RhiBindingsShaderPixel,
+        RhiBindingsShaderCompute,
+        RhiBindingsRenderTarget,
+        RhiBindingsPipeline,
+        RhiBindingsDescriptorSet,
+        RhiPipelineBarriers,
+        ThreadingTasksSpilled,
+        Count
+    };
+
+    // A metric, as last presented
+    struct MetricValue
+    {
+        std::string name;
+        std::string unit;
+        MetricType type = MetricType::Counter;
+        double value    = 0.0;  // counters: during the last frame, gauges: the last value set, histograms: the mean
+        int64_t total   = 0;    // counters: since registration
+        uint64_t count  = 0;    // histograms: values recorded during the last update interval
+        double p50      = 0.0;  // histograms, over the last update interval
+        double p95      = 0.0;
+        double p99      = 0.0;
+        double max      = 0.0;
+    };
+
+    // Named counters, gauges and histograms which any subsystem can register and publish, from any thread.
+    // Every thread updates a shard of its own (no locks, no contention), the main thread sums the shards when it presents them.
+    // Histograms are log-linear (HDR style), 8 buckets per power of two, so a percentile is within ~6% of the recorded value.
+    class GENOME_CLASS MetricRegistry
+    {
+    public:
+        static const uint32_t capacity = 256;
+
+        MetricRegistry();
+        ~MetricRegistry();
+
+        // Registering a name twice returns the same metric. Returns capacity (which updates ignore) if there is no room left.
+        MetricId Register(const std::string& name, MetricType type, const std::string& unit = "");
+        const char* GetName(MetricId id) const { return id < capacity ? m_info[id].name.c_str() : ""; }
+
+        // Can be called from any thread
+        void CounterAdd(MetricId id, int64_t value = 1);
+        void GaugeSet(MetricId id, double value);
+        void HistogramRecord(MetricId id, double value);
+
+        // Main thread, counters and gauges are presented every frame, histograms every update interval
+        void UpdateFrame();
+        void UpdateHistograms();
+        const std::vector<MetricValue>& GetValues() const { return m_values; }
+        const MetricValue& GetValue(MetricId id) const;
+
+    private:
+        MetricShard* GetShard();
+
+        // Registration, a slot is written once (under the mutex) before the count which publishes it
+        struct MetricInfo
+        {
+            std::string name;
+            std::string unit;
+            MetricType type = MetricType::Counter;
+        };
+        MetricInfo m_info[capacity];
+        std::atomic<uint32_t> m_count = 0;
+        std::mutex m_mutex_register;
+
+        // Gauges are set, not added to, so they don't need shards
+        std::atomic<double> m_gauges[capacity] = {};
+
+        // A shard per thread which ever updated a metric, they live as long as the registry
+        std::vector<MetricShard*> m_shards;
+        std::mutex m_mutex_shards;
+        uint64_t m_instance_id = 0;
+
+        // Presented, by the main thread
+        std::vector<MetricValue> m_values;
+        std::vector<int64_t> m_counter_sums;
+        std::vector<std::vector<uint64_t>> m_histogram_buckets_previous;
+        std::vector<double> m_histogram_sums_previous;
+        std::vector<uint64_t> m_histogram_buckets;
+    };
+}
@@ -3,9 +3,11 @@
 #include "Profiler.h"
 #include "../Rendering/Renderer.h"
 #include "../Resource/ResourceCache.h"
+#include "../Threading/Threading.h"
 #include "../RHI/RHI_Device.h"
 #include "../RHI/RHI_CommandList.h"
 #include "../RHI/RHI_Implementation.h"
+#include <fstream>
 //====================================
 
 //= NAMESPACES =====
@@ -14,20 +16,170 @@ using namespace std;
 
 namespace Genome
 {
+    // A thread's begin (named) or end (unnamed) of a CPU time block
+    struct ProfilerEvent
+    {
+        const char* name;
+        chrono::steady_clock::time_point time;
+        AllocationCount allocations; // the thread's totals at the time
+    };
+
+    // Events are written into chunks which are chained as needed, so a thread never waits and never drops events
+    struct ProfilerChunk
+    {
+        static const uint32_t capacity = 4096;
+
+        ProfilerEvent events[capacity];
+        atomic<uint32_t> count      = 0; // published by the thread which writes
+        atomic<ProfilerChunk*> next = nullptr;
+    };
+
+    // The events of a single thread. The thread writes, the main thread reads (when the frame ends), no locks.
+    class ProfilerThread
+    {
+    public:
+        ProfilerThread()
+        {
+            m_chunk_write   = new ProfilerChunk();
+            m_chunk_read    = m_chunk_write;
+        }
+
+        ~ProfilerThread()
+        {
+            while (m_chunk_read)
+            {
+                ProfilerChunk* next = m_chunk_read->next.load(memory_order_acquire);
+                delete m_chunk_read;
+                m_chunk_read = next;
+            }
+
+            delete m_chunk_spare.load(memory_order_acquire);
+        }
+
+        // Writing, by the thread itself
+        void Write(const char* name, const chrono::steady_clock::time_point& time, const AllocationCount& allocations)
+        {
+            if (m_write_count == ProfilerChunk::capacity)
+            {
+                // Reuse the chunk the reader handed back, if there is one
+                ProfilerChunk* chunk = m_chunk_spare.exchange(nullptr, memory_order_acquire);
+                if (chunk)
+                {
+                    chunk->count.store(0, memory_order_relaxed);
+                    chunk->next.store(nullptr, memory_order_relaxed);
+                }
+                else
+                {
+                    chunk = new ProfilerChunk();
+                }
+
+                m_chunk_write->next.store(chunk, memory_order_release);
+                m_chunk_write   = chunk;
+                m_write_count   = 0;
+            }
+
+            m_chunk_write->events[m_write_count++] = { name, time, allocations };
+            m_chunk_write->count.store(m_write_count, memory_order_release);
+        }
+
+        // Reading, by the main thread
+        template <typename Function>
+        void Read(Function&& function)
+        {
+            while (true)
+            {
+                const uint32_t count = m_chunk_read->count.load(memory_order_acquire);
+                for (; m_read_index < count; m_read_index++)
+                {
+                    function(m_chunk_read->events[m_read_index]);
+                }
+
+                ProfilerChunk* next = count == ProfilerChunk::capacity ? m_chunk_read->next.load(memory_order_acquire) : nullptr;
+                if (!next)
+                    return;
+
+                // The writer has moved on, hand the chunk back to it
+                ProfilerChunk* chunk    = m_chunk_read;
+                ProfilerChunk* expected = nullptr;
+                m_chunk_read            = next;
+                m_read_index            = 0;
+                if (!m_chunk_spare.compare_exchange_strong(expected, chunk, memory_order_release))
+                {
+                    delete chunk;
+                }
+            }
+        }
+
+        // Whether each open scope of the thread was recorded as an event, as a GPU block, or not at all
+        enum class Scope : uint8_t { Skipped, Cpu, Gpu };
+        static const uint32_t scope_depth_max = 64;
+        uint8_t scopes[scope_depth_max] = {};
+        uint32_t scope_depth            = 0;
+
+        // Merging, by the main thread
+        struct Open
+        {
+            const char* name;
+            chrono::steady_clock::time_point start;
+            AllocationCount allocations;
+            uint32_t index; // of the block which was merged for it
+        };
+        vector<Open> open;
+        thread::id id;
+        string name;
+
+    private:
+        ProfilerChunk* m_chunk_write            = nullptr;
+        uint32_t m_write_count                  = 0;
+        ProfilerChunk* m_chunk_read             = nullptr;
+        uint32_t m_read_index                   = 0;
+        atomic<ProfilerChunk*> m_chunk_spare    = nullptr;
+    };
+
+    // The calling thread's events, per profiler (so a new one starts clean)
+    static atomic<uint64_t> profiler_instance_count = 0;
+    struct ProfilerThreadSlot
+    {
+        uint64_t profiler_id = 0;
+        shared_ptr<ProfilerThread> thread;
+    };
+    static thread_local ProfilerThreadSlot profiler_thread_slot;
+
     Profiler::Profiler(Context* context) : ISubsystem(context)
     {
-        m_time_blocks_read.reserve(m_time_block_capacity);
-        m_time_blocks_read.resize(m_time_block_capacity);
-        m_time_blocks_write.reserve(m_time_block_capacity);
-        m_time_blocks_write.resize(m_time_block_capacity);
+        m_thread_id_main    = this_thread::get_id();
+        m_instance_id       = ++profiler_instance_count;
+        m_time_blocks_merge.reserve(256);
+        m_time_block_parents.reserve(256);
+        m_time_blocks_read.reserve(256);
+
+        // The metrics of the engine itself, in the order of Metric
+        const MetricId metric_first = RegisterCounter("renderer/meshes_rendered");
+        RegisterCounter("rhi/draw");
+        RegisterCounter("rhi/dispatch");
+        RegisterCounter("rhi/bindings/buffer_index");
+        RegisterCounter("rhi/bindings/buffer_vertex");
+        RegisterCounter("rhi/bindings/buffer_constant");
+        RegisterCounter("rhi/bindings/sampler");
+        RegisterCounter("rhi/bindings/texture_sampled");
+        RegisterCounter("rhi/bindings/texture_storage");
+        RegisterCounter("rhi/bindings/shader_vertex");
+        RegisterCounter("rhi/bindings/shader_pixel");
+        RegisterCounter("rhi/bindings/shader_compute");
+        RegisterCounter("rhi/bindings/render_target");
+        RegisterCounter("rhi/bindings/pipeline");
+        RegisterCounter("rhi/bindings/descriptor_set");
+        RegisterCounter("rhi/pipeline_barriers");
+        const MetricId metric_last = RegisterCounter("threading/tasks_spilled");
+        SP_ASSERT(metric_first == static_cast<MetricId>(Metric::RendererMeshesRendered) && metric_last == static_cast<MetricId>(Metric::ThreadingTasksSpilled));
     }
 
     Profiler::~Profiler()
     {
-        if (m_poll) OnFrameEnd();
         m_time_blocks_write.clear();
+        m_time_blocks_merge.clear();
         m_time_blocks_read.clear();
-        ClearRhiMetrics();
+        m_threads.clear();
     }
 
     bool Profiler::Initialize()
@@ -35,6 +187,7 @@ namespace Genome
         m_resource_manager = m_context->GetSubsystem<ResourceCache>();
         m_renderer = m_context->GetSubsystem<Renderer>();
         m_timer = m_context->GetSubsystem<Timer>();
+        m_threading = m_context->GetSubsystem<Threading>();
 
         return true;
     }
@@ -44,31 +197,28 @@ namespace Genome
         if (!m_renderer)
             return;
 
-        RHI_Device* rhi_device = m_renderer->GetRhiDevice().get();
-        if (!rhi_device || !rhi_device->GetContextRhi()->profiler)
-            return;
-
-        if (m_increase_capacity)
+        // Tasks which had to be heap allocated
         {
-            OnFrameEnd();
-
-            const uint32_t new_size = m_time_block_count + 100;
-            m_time_blocks_read.reserve(new_size);
-            m_time_blocks_read.resize(new_size);
-            m_time_blocks_write.reserve(new_size);
-            m_time_blocks_write.resize(new_size);
-            LOG_WARNING("Time block list has grown to fit %d commands. Consider making the capacity larger to avoid re-allocations.", m_time_block_count + 1);
-            m_increase_capacity = false;
-            m_poll = true;
+            const uint64_t tasks_spilled_total  = m_threading->GetTasksSpilled();
+            CounterAdd(Metric::ThreadingTasksSpilled, static_cast<int64_t>(tasks_spilled_total - m_threading_tasks_spilled_total));
+            m_threading_tasks_spilled_total     = tasks_spilled_total;
         }
-        else
+
+        // Counters and gauges, what was published since the last tick is the frame
+        m_metric_registry.UpdateFrame();
+
+        RHI_Device* rhi_device      = m_renderer->GetRhiDevice().get();
+        const bool is_rhi_profiling = rhi_device && rhi_device->GetContextRhi()->profiler;
+
+        // Threads record whenever the profiler is enabled, so their events are consumed every frame (even if the RHI can't profile)
+        if (m_profile.load(memory_order_relaxed) || IsCapturingTrace() || IsCapturingHitches())
         {
-            if (m_profile && m_poll)
-            {
-                OnFrameEnd();
-            }
+            OnFrameEnd(is_rhi_profiling);
         }
 
+        if (!is_rhi_profiling)
+            return;
+
         // Compute timings
         {
             // Detect stutters
@@ -87,7 +237,7 @@ namespace Genome
                 if (!time_block.IsComplete())
                     continue;
 
-                if (!time_block.GetParent() && time_block.GetType() == TimeBlockType::Cpu)
+                if (!time_block.GetParent() && time_block.GetType() == TimeBlockType::Cpu && time_block.GetThreadId() == m_thread_id_main)
                 {
                     m_time_cpu_last += time_block.GetDuration();
                 }
@@ -114,6 +264,21 @@ namespace Genome
             m_time_frame_min = Math::Min(m_time_frame_min, m_time_frame_last);
             m_time_frame_max = Math::Max(m_time_frame_max, m_time_frame_last);
 
+            // Only time the thread pool while someone is looking
+            m_threading->SetStatsEnabled(m_profile);
+
+            // Heap allocations of every thread
+            if (AllocationTracker::IsEnabled())
+            {
+                const AllocationCount allocations_total = AllocationTracker::GetTotal();
+                m_allocations_last                      = allocations_total - m_allocations_total;
+                m_allocations_total                     = allocations_total;
+            }
+            else
+            {
+                m_allocations_last = AllocationCount();
+            }
+
             // FPS
             {
                 m_frames_since_last_fps_computation++;
@@ -144,6 +309,13 @@ namespace Genome
         if (m_poll)
         {
             AcquireGpuData();
+            UpdateFramePacingMetrics();
+            m_metric_registry.UpdateHistograms();
+
+            if (m_profile)
+            {
+                UpdateThreadingMetrics();
+            }
 
             // Create a string version of the rhi metrics
             if (m_renderer->GetOptions() & Render_Debug_PerformanceMetrics)
@@ -151,13 +323,31 @@ namespace Genome
                 UpdateRhiMetricsString();
             }
         }
-
-        ClearRhiMetrics();
     }
 
-    void Profiler::OnFrameEnd()
+    void Profiler::OnFrameEnd(const bool resolve_gpu)
     {
-        // Clear time blocks
+        const bool is_capturing_trace   = IsCapturingTrace();
+        const bool is_capturing_hitches = IsCapturingHitches();
+
+        m_time_blocks_merge.clear();
+        m_time_block_parents.clear();
+
+        // CPU, from every thread
+        {
+            vector<shared_ptr<ProfilerThread>> threads;
+            {
+                lock_guard<mutex> lock(m_mutex_threads);
+                threads = m_threads;
+            }
+
+            for (const shared_ptr<ProfilerThread>& thread : threads)
+            {
+                MergeThread(thread.get());
+            }
+        }
+
+        // GPU, the blocks are only dropped if the RHI can't profile
         {
             uint32_t pass_index_gpu = 0;
 
@@ -165,21 +355,42 @@ namespace Genome
             {
                 TimeBlock& time_block = m_time_blocks_write[i];
 
+                if (!resolve_gpu)
+                {
+                    time_block.Reset();
+                    continue;
+                }
+
                 if (time_block.IsComplete())
                 {
                     // Must not happen when TimeBlockEnd() ends as D3D11 waits
                     // too much for the results to be ready, which increases CPU time.
                     time_block.ComputeDuration(pass_index_gpu);
-                    if (time_block.GetType() == TimeBlockType::Gpu)
+                    pass_index_gpu += 2;
+
+                    // Parents come before their children
+                    uint32_t parent = numeric_limits<uint32_t>::max();
+                    for (uint32_t j = i; j-- > 0;)
                     {
-                        pass_index_gpu += 2;
+                        if (&m_time_blocks_write[j] == time_block.GetParent())
+                        {
+                            parent = static_cast<uint32_t>(m_time_blocks_merge.size()) - (i - j);
+                            break;
+                        }
                     }
 
-                    m_time_blocks_read[i] = time_block;
+                    TimeBlock& merged = m_time_blocks_merge.emplace_back();
+                    merged.Set(time_block.GetName(), TimeBlockType::Gpu, time_block.GetTreeDepth(), thread::id(), "gpu", time_block.GetStart());
+                    merged.SetEnd(time_block.GetEnd(), time_block.GetDuration(), time_block.GetStartGpuMs());
+                    m_time_block_parents.emplace_back(parent);
                 }
                 else
                 {
                     LOG_WARNING("TimeBlockEnd() was not called for time block \"%s\"", time_block.GetName());
+
+                    // Keep the indices of the blocks which follow in line with the ones above
+                    m_time_blocks_merge.emplace_back();
+                    m_time_block_parents.emplace_back(numeric_limits<uint32_t>::max());
                 }
 
                 time_block.Reset();
@@ -187,37 +398,300 @@ namespace Genome
 
             m_time_block_count = 0;
         }
+
+        // The list is complete, so the parents can be pointed to
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_time_blocks_merge.size()); i++)
+        {
+            if (m_time_block_parents[i] != numeric_limits<uint32_t>::max())
+            {
+                m_time_blocks_merge[i].SetParent(&m_time_blocks_merge[m_time_block_parents[i]]);
+            }
+        }
+
+        // The frame as trace events, for a trace and for the hitch ring
+        const chrono::steady_clock::time_point frame_end = chrono::steady_clock::now();
+        if (is_capturing_trace || is_capturing_hitches)
+        {
+            RecordTraceFrame();
+
+            if (is_capturing_trace)
+            {
+                lock_guard<mutex> lock(m_mutex_trace);
+                m_trace_events.insert(m_trace_events.end(), m_frame_events.begin(), m_frame_events.end());
+                m_trace_counters.insert(m_trace_counters.end(), m_frame_counters.begin(), m_frame_counters.end());
+            }
+
+            if (is_capturing_hitches)
+            {
+                RecordHitchFrame(static_cast<float>(chrono::duration<double, milli>(frame_end - m_frame_start).count()));
+            }
+        }
+        m_frame_start = frame_end;
+
+        // Present the frame, if it's one which is polled
+        if (m_poll || is_capturing_trace)
+        {
+            m_time_blocks_read.swap(m_time_blocks_merge);
+        }
+
+        if (is_capturing_trace && m_trace_frames_remaining.fetch_sub(1) == 1)
+        {
+            vector<TraceEvent> events;
+            vector<TraceCounter> counters;
+            {
+                lock_guard<mutex> lock(m_mutex_trace);
+                events.swap(m_trace_events);
+                counters.swap(m_trace_counters);
+            }
+
+            WriteTrace(move(events), move(counters), m_trace_file_path);
+        }
     }
 
-    void Profiler::TimeBlockStart(const char* func_name, TimeBlockType type, RHI_CommandList* cmd_list /*= nullptr*/)
+    void Profiler::RecordTraceFrame()
     {
-        if (!m_profile || !m_poll)
+        m_frame_events.clear();
+        m_frame_counters.clear();
+
+        // GPU timestamps are on a clock of their own, so the GPU blocks of a frame are placed relative to when the first one was recorded
+        chrono::steady_clock::time_point gpu_origin;
+        double gpu_origin_ms = -1.0;
+
+        for (const TimeBlock& time_block : m_time_blocks_merge)
+        {
+            if (!time_block.IsComplete())
+                continue;
+
+            TraceEvent& event   = m_frame_events.emplace_back();
+            event.name          = time_block.GetName();
+            event.thread_id     = time_block.GetThreadId();
+            event.start         = time_block.GetStart();
+            event.end           = time_block.GetEnd();
+
+            if (time_block.GetType() == TimeBlockType::Gpu)
+            {
+                if (gpu_origin_ms < 0.0)
+                {
+                    gpu_origin      = time_block.GetStart();
+                    gpu_origin_ms   = time_block.GetStartGpuMs();
+                }
+
+                const chrono::duration<double, milli> offset(time_block.GetStartGpuMs() - gpu_origin_ms);
+                const chrono::duration<double, milli> duration(time_block.GetDuration());
+                event.category  = "gpu";
+                event.start     = gpu_origin + chrono::duration_cast<chrono::steady_clock::duration>(offset);
+                event.end       = event.start + chrono::duration_cast<chrono::steady_clock::duration>(duration);
+            }
+        }
+
+        // Resource loads
+        {
+            lock_guard<mutex> lock(m_mutex_load_events);
+            for (TraceEvent& event : m_load_events)
+            {
+                m_frame_events.emplace_back(move(event));
+            }
+            m_load_events.clear();
+        }
+
+        // Counters and gauges, the registry was updated with those of the frame before this was called
+        const chrono::steady_clock::time_point start = m_frame_start != chrono::steady_clock::time_point() ? m_frame_start : chrono::steady_clock::now();
+        m_frame_counters.push_back({ "frame_ms", start, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() });
+        const vector<MetricValue>& metrics = m_metric_registry.GetValues();
+        for (MetricId id = 0; id < static_cast<MetricId>(metrics.size()); id++)
+        {
+            if (metrics[id].type != MetricType::Histogram)
+            {
+                m_frame_counters.push_back({ m_metric_registry.GetName(id), start, metrics[id].value });
+            }
+        }
+        if (AllocationTracker::IsEnabled())
+        {
+            // Updated by Tick() after this, so this is the frame before
+            m_frame_counters.push_back({ "allocations", start, static_cast<double>(m_allocations_last.count) });
+        }
+    }
+
+    void Profiler::RecordHitchFrame(const float frame_ms)
+    {
+        lock_guard<mutex> lock(m_mutex_hitch);
+        if (m_hitch_frames.empty())
+            return;
+
+        // Into the ring, the frame's vectors are swapped in, so the ones of the frame it replaces are reused
+        HitchFrame& frame = m_hitch_frames[m_hitch_frame_index];
+        frame.events.swap(m_frame_events);
+        frame.counters.swap(m_frame_counters);
+        m_hitch_frame_index     = (m_hitch_frame_index + 1) % static_cast<uint32_t>(m_hitch_frames.size());
+        m_hitch_frames_recorded = Math::Min(m_hitch_frames_recorded + 1, static_cast<uint32_t>(m_hitch_frames.size()));
+
+        // A hitch, record a few frames which follow it (to see how it recovered) before writing out
+        if (m_hitch_frames_remaining == 0)
+        {
+            // The first frame can span the time since recording started
+            if (frame_ms <= m_hitch_threshold_ms || m_hitch_frames_recorded == 1)
+                return;
+
+            m_hitch_ms                  = frame_ms;
+            m_hitch_frames_remaining    = Math::Min(10u, static_cast<uint32_t>(m_hitch_frames.size()) / 4);
+            LOG_WARNING("Hitch of %.1f ms, capturing...", frame_ms);
+        }
+
+        if (m_hitch_frames_remaining != 0 && --m_hitch_frames_remaining != 0)
+            return;
+
+        // Oldest to newest
+        vector<TraceEvent> events;
+        vector<TraceCounter> counters;
+        const uint32_t frame_count = static_cast<uint32_t>(m_hitch_frames.size());
+        for (uint32_t i = 0; i < m_hitch_frames_recorded; i++)
+        {
+            const HitchFrame& hitch_frame = m_hitch_frames[(m_hitch_frame_index + frame_count - m_hitch_frames_recorded + i) % frame_count];
+            events.insert(events.end(), hitch_frame.events.begin(), hitch_frame.events.end());
+            counters.insert(counters.end(), hitch_frame.counters.begin(), hitch_frame.counters.end());
+        }
+
+        // Start over, so that the next capture doesn't repeat the frames of this one
+        m_hitch_frames_recorded = 0;
+
+        WriteTrace(move(events), move(counters), "hitch_" + to_string(++m_hitch_count) + "_" + to_string(static_cast<uint32_t>(m_hitch_ms)) + "ms.json");
+    }
+
+    void Profiler::SetHitchCapture(const bool enabled, const float threshold_ms /*= 50.0f*/, const uint32_t frame_count /*= 120*/)
+    {
+        if (enabled && (threshold_ms <= 0.0f || frame_count == 0))
+        {
+            LOG_ERROR_INVALID_PARAMETER();
             return;
+        }
+
+        lock_guard<mutex> lock(m_mutex_hitch);
+
+        m_hitch_threshold_ms        = threshold_ms;
+        m_hitch_frame_index         = 0;
+        m_hitch_frames_recorded     = 0;
+        m_hitch_frames_remaining    = 0;
+        m_hitch_frames.clear();
+        if (enabled)
+        {
+            m_hitch_frames.resize(frame_count);
+        }
+        m_hitch_frames.shrink_to_fit();
 
-        const bool can_profile_cpu = (type == TimeBlockType::Cpu) && m_profile_cpu;
-        const bool can_profile_gpu = (type == TimeBlockType::Gpu) && m_profile_gpu;
+        m_hitch_capture.store(enabled, memory_order_relaxed);
+    }
 
-        if (!can_profile_cpu && !can_profile_gpu)
+    void Profiler::RecordResourceLoad(const string& file_path, const chrono::steady_clock::time_point& start)
+    {
+        if (!IsCapturingTrace() && !IsCapturingHitches())
             return;
 
-        // Last incomplete block of the same type, is the parent
-        TimeBlock* time_block_parent = GetLastIncompleteTimeBlock(type);
+        TraceEvent event;
+        event.name      = "Load";
+        event.category  = "load";
+        event.thread_id = this_thread::get_id();
+        event.start     = start;
+        event.end       = chrono::steady_clock::now();
+        event.detail    = file_path;
+
+        lock_guard<mutex> lock(m_mutex_load_events);
+        m_load_events.emplace_back(move(event));
+    }
+
+    void Profiler::MergeThread(ProfilerThread* thread)
+    {
+        const uint32_t none = numeric_limits<uint32_t>::max();
+
+        if (thread->name.empty() && m_threading)
+        {
+            thread->name = m_threading->GetThreadName(thread->id);
+        }
+
+        // Blocks which are still open from previous frames continue in this one
+        for (uint32_t i = 0; i < static_cast<uint32_t>(thread->open.size()); i++)
+        {
+            ProfilerThread::Open& open = thread->open[i];
+            open.index = static_cast<uint32_t>(m_time_blocks_merge.size());
+            m_time_blocks_merge.emplace_back().Set(open.name, TimeBlockType::Cpu, i, thread->id, thread->name.c_str(), open.start);
+            m_time_block_parents.emplace_back(i != 0 ? thread->open[i - 1].index : none);
+        }
+
+        thread->Read([this, thread, none](const ProfilerEvent& event)
+        {
+            // Begin
+            if (event.name)
+            {
+                const uint32_t depth = static_cast<uint32_t>(thread->open.size());
+                m_time_block_parents.emplace_back(depth != 0 ? thread->open.back().index : none);
+                thread->open.push_back({ event.name, event.time, event.allocations, static_cast<uint32_t>(m_time_blocks_merge.size()) });
+                m_time_blocks_merge.emplace_back().Set(event.name, TimeBlockType::Cpu, depth, thread->id, thread->name.c_str(), event.time);
+                return;
+            }
+
+            // End
+            if (thread->open.empty())
+                return;
+
+            const ProfilerThread::Open& open                = thread->open.back();
+            const chrono::duration<double, milli> duration  = event.time - open.start;
+            m_time_blocks_merge[open.index].SetEnd(event.time, static_cast<float>(duration.count()));
+            m_time_blocks_merge[open.index].SetAllocations(event.allocations - open.allocations);
+            thread->open.pop_back();
+        });
+    }
+
+    void Profiler::TimeBlockStart(const char* func_name, TimeBlockType type, RHI_CommandList* cmd_list /*= nullptr*/)
+    {
+        ProfilerThread* thread          = GetThread();
+        const bool is_capturing_trace   = IsCapturingTrace();
+        ProfilerThread::Scope scope     = ProfilerThread::Scope::Skipped;
 
-        if (TimeBlock* time_block = GetNewTimeBlock())
+        if (type == TimeBlockType::Cpu)
         {
-            time_block->Begin(func_name, type, time_block_parent, cmd_list, m_renderer->GetRhiDevice());
+            if (m_profile_cpu && (m_profile.load(memory_order_relaxed) || is_capturing_trace || IsCapturingHitches()))
+            {
+                thread->Write(func_name, chrono::steady_clock::now(), AllocationTracker::GetThread());
+                scope = ProfilerThread::Scope::Cpu;
+            }
         }
+        else if (type == TimeBlockType::Gpu && thread->id == m_thread_id_main)
+        {
+            if (m_profile_gpu && ((m_profile.load(memory_order_relaxed) && m_poll) || is_capturing_trace || IsCapturingHitches()))
+            {
+                // Last incomplete block, is the parent
+                TimeBlock* time_block_parent = GetLastIncompleteTimeBlock();
+                GetNewTimeBlock()->Begin(func_name, type, time_block_parent, cmd_list, m_renderer->GetRhiDevice());
+                scope = ProfilerThread::Scope::Gpu;
+            }
+        }
+
+        // Remember what was done, so TimeBlockEnd() does the same (scopes deeper than that are CPU only)
+        if (thread->scope_depth < ProfilerThread::scope_depth_max)
+        {
+            thread->scopes[thread->scope_depth] = static_cast<uint8_t>(scope);
+        }
+        thread->scope_depth++;
     }
 
     void Profiler::TimeBlockEnd()
     {
-        // If the capacity 
-        if (m_increase_capacity)
+        ProfilerThread* thread = GetThread();
+        if (thread->scope_depth == 0)
             return;
 
-        if (TimeBlock* time_block = GetLastIncompleteTimeBlock())
+        thread->scope_depth--;
+        const ProfilerThread::Scope scope = thread->scope_depth < ProfilerThread::scope_depth_max ? static_cast<ProfilerThread::Scope>(thread->scopes[thread->scope_depth]) : ProfilerThread::Scope::Cpu;
+
+        if (scope == ProfilerThread::Scope::Cpu)
+        {
+            thread->Write(nullptr, chrono::steady_clock::now(), AllocationTracker::GetThread());
+        }
+        else if (scope == ProfilerThread::Scope::Gpu)
         {
-            time_block->End();
+            if (TimeBlock* time_block = GetLastIncompleteTimeBlock())
+            {
+                time_block->End();
+            }
         }
     }
 
@@ -237,30 +711,193 @@ namespace Genome
         m_time_gpu_last = 0.0f;
     }
 
+    void Profiler::CaptureTrace(const uint32_t frame_count /*= 10*/, const string& file_path /*= "trace.json"*/)
+    {
+        if (frame_count == 0 || file_path.empty())
+        {
+            LOG_ERROR_INVALID_PARAMETER();
+            return;
+        }
+
+        if (IsCapturingTrace())
+        {
+            LOG_WARNING("A trace is already being captured");
+            return;
+        }
+
+        // Time blocks are only processed when the RHI supports profiling
+        RHI_Device* rhi_device = m_renderer ? m_renderer->GetRhiDevice().get() : nullptr;
+        if (!rhi_device || !rhi_device->GetContextRhi()->profiler)
+        {
+            LOG_WARNING("Profiling is not supported, can't capture a trace");
+            return;
+        }
+
+        {
+            lock_guard<mutex> lock(m_mutex_trace);
+            m_trace_events.clear();
+            m_trace_counters.clear();
+        }
+
+        m_trace_file_path = file_path;
+        m_trace_frames_remaining.store(frame_count);
+        LOG_INFO("Capturing a trace of %d frames...", frame_count);
+    }
+
+    // Names are function names and pass names, but make sure they can't break the JSON
+    static string trace_escape(const char* text)
+    {
+        string escaped;
+        for (const char* c = text ? text : "unnamed"; *c; c++)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                escaped += '\\';
+            }
+
+            if (static_cast<unsigned char>(*c) >= 0x20)
+            {
+                escaped += *c;
+            }
+        }
+
+        return escaped;
+    }
+
+    void Profiler::WriteTrace(vector<TraceEvent> events, vector<TraceCounter> counters, const string& file_path)
+    {
+        // Every thread gets a track, named the way the thread pool names it, the main thread comes first and the GPU last
+        vector<thread::id> thread_ids       = { m_thread_id_main };
+        vector<string> thread_names         = { m_threading->GetThreadName(m_thread_id_main) };
+        bool has_gpu                        = false;
+        for (const TraceEvent& event : events)
+        {
+            if (event.thread_id == thread::id())
+            {
+                has_gpu = true;
+            }
+            else if (find(thread_ids.begin(), thread_ids.end(), event.thread_id) == thread_ids.end())
+            {
+                thread_ids.emplace_back(event.thread_id);
+                thread_names.emplace_back(m_threading->GetThreadName(event.thread_id));
+            }
+        }
+        if (has_gpu)
+        {
+            thread_ids.emplace_back(thread::id());
+            thread_names.emplace_back("gpu");
+        }
+
+        // Formatting and writing can take a while, so it happens off the main thread
+        m_threading->AddTask([events = move(events), counters = move(counters), thread_ids = move(thread_ids), thread_names = move(thread_names), file_path]()
+        {
+            ofstream fout(file_path, ofstream::out | ofstream::trunc);
+            if (!fout.is_open())
+            {
+                LOG_ERROR("Failed to open \"%s\" for writing", file_path.c_str());
+                return;
+            }
+
+            chrono::steady_clock::time_point origin = chrono::steady_clock::time_point::max();
+            for (const TraceEvent& event : events)
+            {
+                origin = min(origin, event.start);
+            }
+            for (const TraceCounter& counter : counters)
+            {
+                origin = min(origin, counter.time);
+            }
+
+            fout << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+            // Tracks
+            for (uint32_t tid = 0; tid < static_cast<uint32_t>(thread_ids.size()); tid++)
+            {
+                fout << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid << ",\"args\":{\"name\":\"" << trace_escape(thread_names[tid].c_str()) << "\"}},\n";
+                fout << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid << ",\"args\":{\"sort_index\":" << tid << "}}";
+                fout << (tid + 1 < thread_ids.size() || !events.empty() || !counters.empty() ? ",\n" : "\n");
+            }
+
+            // Time blocks and loads, as complete events in microseconds
+            char buffer[128];
+            for (uint32_t i = 0; i < static_cast<uint32_t>(events.size()); i++)
+            {
+                const TraceEvent& event = events[i];
+                const uint32_t tid      = static_cast<uint32_t>(find(thread_ids.begin(), thread_ids.end(), event.thread_id) - thread_ids.begin());
+                const double start_us   = chrono::duration<double, micro>(event.start - origin).count();
+                const double duration   = chrono::duration<double, micro>(event.end - event.start).count();
+
+                snprintf(buffer, sizeof(buffer), "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f", tid, start_us, max(duration, 0.0));
+                fout << "{\"name\":\"" << trace_escape(event.name) << "\",\"cat\":\"" << event.category << buffer;
+                if (!event.detail.empty())
+                {
+                    fout << ",\"args\":{\"detail\":\"" << trace_escape(event.detail.c_str()) << "\"}";
+                }
+                fout << (i + 1 < events.size() || !counters.empty() ? "},\n" : "}\n");
+            }
+
+            // Counters, a track each
+            for (uint32_t i = 0; i < static_cast<uint32_t>(counters.size()); i++)
+            {
+                const TraceCounter& counter = counters[i];
+                const double time_us        = chrono::duration<double, micro>(counter.time - origin).count();
+
+                snprintf(buffer, sizeof(buffer), "\",\"ph\":\"C\",\"pid\":0,\"ts\":%.3f,\"args\":{\"value\":%.3f}}", time_us, counter.value);
+                fout << "{\"name\":\"" << trace_escape(counter.name) << buffer;
+                fout << (i + 1 < counters.size() ? ",\n" : "\n");
+            }
+
+            fout << "]}\n";
+            fout.close();
+
+            LOG_INFO("Trace with %d time blocks written to \"%s\"", static_cast<uint32_t>(events.size()), file_path.c_str());
+        }, nullptr, Task_Lane::Io);
+    }
+
+    const TickGraph& Profiler::GetTickGraph(const TickType tick_group) const
+    {
+        return m_context->GetTickGraph(tick_group);
+    }
+
+    ProfilerThread* Profiler::GetThread()
+    {
+        // First time on this thread
+        if (profiler_thread_slot.profiler_id != m_instance_id)
+        {
+            shared_ptr<ProfilerThread> thread = make_shared<ProfilerThread>();
+            thread->id = this_thread::get_id();
+
+            {
+                lock_guard<mutex> lock(m_mutex_threads);
+                m_threads.emplace_back(thread);
+            }
+
+            profiler_thread_slot.profiler_id    = m_instance_id;
+            profiler_thread_slot.thread         = thread;
+        }
+
+        return profiler_thread_slot.thread.get();
+    }
+
     TimeBlock* Profiler::GetNewTimeBlock()
     {
-        // Increase capacity if needed
+        // Grow as needed, the blocks are reused from frame to frame
         if (m_time_block_count >= static_cast<uint32_t>(m_time_blocks_write.size()))
         {
-            m_increase_capacity = true;
-            return nullptr;
+            m_time_blocks_write.emplace_back();
         }
 
-        // Return a time block
         return &m_time_blocks_write[m_time_block_count++];
     }
 
-    TimeBlock* Profiler::GetLastIncompleteTimeBlock(TimeBlockType type /*= TimeBlock_Undefined*/)
+    TimeBlock* Profiler::GetLastIncompleteTimeBlock()
     {
         for (int i = m_time_block_count - 1; i >= 0; i--)
         {
             TimeBlock& time_block = m_time_blocks_write[i];
 
-            if (type == time_block.GetType() || type == TimeBlockType::Undefined)
-            {
-                if (!time_block.IsComplete())
-                    return &time_block;
-            }
+            if (!time_block.IsComplete())
+                return &time_block;
         }
 
         return nullptr;
@@ -279,16 +916,90 @@ namespace Genome
         }
     }
 
+    void Profiler::UpdateThreadingMetrics()
+    {
+        const float interval_ns = m_threading_stopwatch.GetElapsedTimeMs() * 1000000.0f;
+        m_threading_stopwatch.Start();
+
+        // Threads
+        m_threading->GetThreadStats(m_thread_stats);
+        m_thread_stats_previous.resize(m_thread_stats.size());
+        m_thread_metrics.resize(m_thread_stats.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_thread_stats.size()); i++)
+        {
+            const ThreadStats& current = m_thread_stats[i];
+            ThreadStats& previous      = m_thread_stats_previous[i];
+
+            // The stats start from zero when the pool is resized
+            if (current.tasks_executed < previous.tasks_executed || current.sleeps < previous.sleeps)
+            {
+                previous = ThreadStats();
+            }
+
+            ThreadMetrics& metrics  = m_thread_metrics[i];
+            metrics.name            = current.name;
+            metrics.busy            = Math::Clamp(static_cast<float>(current.time_busy_ns - previous.time_busy_ns) / interval_ns, 0.0f, 1.0f);
+            metrics.asleep          = Math::Clamp(static_cast<float>(current.time_asleep_ns - previous.time_asleep_ns) / interval_ns, 0.0f, 1.0f - metrics.busy);
+            metrics.tasks_executed  = current.tasks_executed - previous.tasks_executed;
+            metrics.tasks_stolen    = current.tasks_stolen - previous.tasks_stolen;
+            metrics.sleeps          = current.sleeps - previous.sleeps;
+
+            previous = current;
+        }
+
+        // Queues
+        for (uint32_t lane = 0; lane < lane_count; lane++)
+        {
+            const QueueLatencyHistogram histogram = m_threading->GetQueueLatency(static_cast<Task_Lane>(lane));
+            for (uint32_t i = 0; i < queue_latency_bucket_count; i++)
+            {
+                const uint64_t previous         = histogram[i] >= m_queue_latency_previous[lane][i] ? m_queue_latency_previous[lane][i] : 0;
+                m_queue_latency[lane][i]        = histogram[i] - previous;
+                m_queue_latency_previous[lane][i] = histogram[i];
+            }
+
+            m_queue_depth_peak[lane] = m_threading->GetQueueDepthPeak(static_cast<Task_Lane>(lane), true);
+        }
+    }
+
+    void Profiler::UpdateFramePacingMetrics()
+    {
+        const FramePacingStats& current     = m_timer->GetFramePacingStats();
+        const FramePacingStats& previous    = m_frame_pacing_previous;
+        const double time_waited_ms         = (current.time_slept_ms - previous.time_slept_ms) + (current.time_spun_ms - previous.time_spun_ms);
+
+        m_frame_pacing.frames               = static_cast<uint32_t>(current.frames - previous.frames);
+        m_frame_pacing.deadlines_missed     = static_cast<uint32_t>(current.deadlines_missed - previous.deadlines_missed);
+        m_frame_pacing.jitter_ms            = m_frame_pacing.frames != 0 ? static_cast<float>((current.jitter_ms - previous.jitter_ms) / m_frame_pacing.frames) : 0.0f;
+        m_frame_pacing.spinning             = time_waited_ms > 0.0 ? static_cast<float>((current.time_spun_ms - previous.time_spun_ms) / time_waited_ms) : 0.0f;
+        m_frame_pacing.sleep_overhead_ms    = static_cast<float>(m_timer->GetSleepOverheadMs());
+
+        m_frame_pacing_previous = current;
+    }
+
     void Profiler::UpdateRhiMetricsString()
     {
         const auto texture_count = m_resource_manager->GetResourceCount(ResourceType::Texture) + m_resource_manager->GetResourceCount(ResourceType::Texture2d) + m_resource_manager->GetResourceCount(ResourceType::TextureCube);
         const auto material_count = m_resource_manager->GetResourceCount(ResourceType::Material);
 
+        // The workers come first in the thread metrics
+        const uint32_t worker_count = Math::Min(m_threading->GetThreadCount(), static_cast<uint32_t>(m_thread_metrics.size()));
+        float workers_busy          = 0.0f;
+        for (uint32_t i = 0; i < worker_count; i++)
+        {
+            workers_busy += m_thread_metrics[i].busy;
+        }
+        workers_busy = worker_count != 0 ? workers_busy / static_cast<float>(worker_count) : 0.0f;
+
+        // Counters of the last frame
+        const auto metric = [this](const Metric metric) { return static_cast<int>(GetMetricValue(metric).value); };
+
         static const char* text =
             // Times
             "FPS:\t\t%.2f\n"
             "Frame:\t%d\n"
             "Time:\t%.2f ms\n"
+            "Pacing:\t%.2f ms jitter, %d/%d missed, %.0f%% spinning, %.2f ms wake-up\n"
             "\n"
             // Detailed times
             "\t\tavg\t\tmin\t\tmax\t\tlast\n"
@@ -327,7 +1038,12 @@ namespace Genome
             "Render target:\t%d\n"
             "Pipeline:\t\t\t%d\n"
             "Descriptor set:\t%d\n"
-            "Pipeline barrier:\t%d";
+            "Pipeline barrier:\t%d\n"
+            "\n"
+            // Threading
+            "Tasks spilled:\t\t%d (total: %llu)\n"
+            "Workers busy:\t\t%.0f%%\n"
+            "Queue peak:\t\t%d/%d/%d/%d (high/normal/background/io)";
 
         static char buffer[2048];
         sprintf_s
@@ -338,6 +1054,7 @@ namespace Genome
             m_fps,
             m_renderer->GetFrameNum(),
             m_time_frame_last,
+            m_frame_pacing.jitter_ms, m_frame_pacing.deadlines_missed, m_frame_pacing.frames, m_frame_pacing.spinning * 100.0f, m_frame_pacing.sleep_overhead_ms,
             m_time_frame_avg, m_time_frame_min, m_time_frame_max, m_time_frame_last,
             m_time_cpu_avg, m_time_cpu_min, m_time_cpu_max, m_time_cpu_last,
             m_time_gpu_avg, m_time_gpu_min, m_time_gpu_max, m_time_gpu_last,
@@ -352,26 +1069,35 @@ namespace Genome
             static_cast<int>(m_renderer->GetViewport().width), static_cast<int>(m_renderer->GetViewport().height),
 
             // Renderer
-            m_renderer_meshes_rendered,
+            metric(Metric::RendererMeshesRendered),
             texture_count,
             material_count,
 
             // RHI
-            m_rhi_draw,
-            m_rhi_dispatch,
-            m_rhi_bindings_buffer_index,
-            m_rhi_bindings_buffer_vertex,
-            m_rhi_bindings_buffer_constant,
-            m_rhi_bindings_sampler,
-            m_rhi_bindings_texture_sampled,
-            m_rhi_bindings_texture_storage,
-            m_rhi_bindings_shader_vertex,
-            m_rhi_bindings_shader_pixel,
-            m_rhi_bindings_shader_compute,
-            m_rhi_bindings_render_target,
-            m_rhi_bindings_pipeline,
-            m_rhi_bindings_descriptor_set,
-            m_rhi_pipeline_barriers
+            metric(Metric::RhiDraw),
+            metric(Metric::RhiDispatch),
+            metric(Metric::RhiBindingsBufferIndex),
+            metric(Metric::RhiBindingsBufferVertex),
+            metric(Metric::RhiBindingsBufferConstant),
+            metric(Metric::RhiBindingsSampler),
+            metric(Metric::RhiBindingsTextureSampled),
+            metric(Metric::RhiBindingsTextureStorage),
+            metric(Metric::RhiBindingsShaderVertex),
+            metric(Metric::RhiBindingsShaderPixel),
+            metric(Metric::RhiBindingsShaderCompute),
+            metric(Metric::RhiBindingsRenderTarget),
+            metric(Metric::RhiBindingsPipeline),
+            metric(Metric::RhiBindingsDescriptorSet),
+            metric(Metric::RhiPipelineBarriers),
+
+            // Threading
+            metric(Metric::ThreadingTasksSpilled),
+            static_cast<unsigned long long>(GetMetricValue(Metric::ThreadingTasksSpilled).total),
+            workers_busy * 100.0f,
+            m_queue_depth_peak[static_cast<uint32_t>(Task_Lane::High)],
+            m_queue_depth_peak[static_cast<uint32_t>(Task_Lane::Normal)],
+            m_queue_depth_peak[static_cast<uint32_t>(Task_Lane::Background)],
+            m_queue_depth_peak[static_cast<uint32_t>(Task_Lane::Io)]
         );
 
         m_metrics = string(buffer);
@@ -3,10 +3,17 @@
 //= INCLUDES ===========================
 #include <string>
 #include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
 #include "TimeBlock.h"
+#include "Metrics.h"
 #include "../Core/ISubsystem.h"
 #include "../Core/Stopwatch.h"
+#include "../Core/Timer.h"
 #include "../Core/Spartan_Definitions.h"
+#include "../Threading/Threading.h"
 //======================================
 
 #define TIME_BLOCK_START_NAMED(profiler, name)  profiler->TimeBlockStart(name, Genome::TimeBlockType::Cpu, nullptr);
@@ -21,6 +28,49 @@ namespace Genome
     class Renderer;
     class Variant;
     class Timer;
+    class TickGraph;
+    class ProfilerThread;
+    enum class TickType;
+
+    // How a thread of the pool spent the last update interval
+    struct ThreadMetrics
+    {
+        std::string name;
+        float busy              = 0.0f; // fraction of the interval spent executing tasks
+        float asleep            = 0.0f; // fraction of the interval spent sleeping, the rest was spent looking for work
+        uint64_t tasks_executed = 0;
+        uint64_t tasks_stolen   = 0;
+        uint64_t sleeps         = 0;
+    };
+
+    // How well the frame limiter kept the pace over the last update interval
+    struct FramePacingMetrics
+    {
+        uint32_t frames             = 0;    // frames which were limited
+        uint32_t deadlines_missed   = 0;
+        float jitter_ms             = 0.0f; // average absolute difference between the frame time and the target frame time
+        float spinning              = 0.0f; // fraction of the limiter's waiting which was spent spinning instead of sleeping
+        float sleep_overhead_ms     = 0.0f; // how late the OS wakes the limiter up
+    };
+
+    // A time block (or a resource load) of a trace capture
+    struct TraceEvent
+    {
+        const char* name        = nullptr;
+        const char* category    = "cpu";    // cpu, gpu or load
+        std::thread::id thread_id;          // default (no thread) for GPU blocks
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+        std::string detail;                 // e.g. the file a resource was loaded from
+    };
+
+    // A value of a frame (e.g. the number of draw calls) of a trace capture, a track per name
+    struct TraceCounter
+    {
+        const char* name = nullptr;
+        std::chrono::steady_clock::time_point time; // when the frame started
+        double value     = 0.0;
+    };
 
     class GENOME_CLASS Profiler : public ISubsystem
     {
@@ -28,18 +78,21 @@ namespace Genome
         Profiler(Context* context);
         ~Profiler();
 
-        //= Subsystem =======================
+        //= Subsystem =====================================================================
         bool Initialize() override;
         void Tick(float delta_time) override;
-        //===================================
+        InitDependencies GetInitDependencies() const override { return InitAfter<>(true); }
+        //=================================================================================
+
+        void OnFrameEnd(bool resolve_gpu);
 
-        void OnFrameEnd();
+        // Can be called from any thread, every thread records into buffers of its own. GPU blocks can only be recorded by the main thread.
         void TimeBlockStart(const char* func_name, TimeBlockType type, RHI_CommandList* cmd_list = nullptr);
         void TimeBlockEnd();
         void ResetMetrics();
 
         // Properties
-        void SetEnabled(const bool enabled) { m_profile = enabled; }
+        void SetEnabled(const bool enabled) { m_profile.store(enabled, std::memory_order_relaxed); }
         const std::string& GetMetrics()                 const { return m_metrics; }
         const std::vector<TimeBlock>& GetTimeBlocks()   const { return m_time_blocks_read; }
         float GetTimeCpuLast()                          const { return m_time_cpu_last; }
@@ -54,25 +107,52 @@ namespace Genome
         bool IsCpuStuttering()                          const { return m_is_stuttering_cpu; }
         bool IsGpuStuttering()                          const { return m_is_stuttering_gpu; }
 
-        // Metrics - RHI
-        uint32_t m_rhi_draw = 0;
-        uint32_t m_rhi_dispatch = 0;
-        uint32_t m_rhi_bindings_buffer_index = 0;
-        uint32_t m_rhi_bindings_buffer_vertex = 0;
-        uint32_t m_rhi_bindings_buffer_constant = 0;
-        uint32_t m_rhi_bindings_sampler = 0;
-        uint32_t m_rhi_bindings_texture_sampled = 0;
-        uint32_t m_rhi_bindings_shader_vertex = 0;
-        uint32_t m_rhi_bindings_shader_pixel = 0;
-        uint32_t m_rhi_bindings_shader_compute = 0;
-        uint32_t m_rhi_bindings_render_target = 0;
-        uint32_t m_rhi_bindings_texture_storage = 0;
-        uint32_t m_rhi_bindings_descriptor_set = 0;
-        uint32_t m_rhi_bindings_pipeline = 0;
-        uint32_t m_rhi_pipeline_barriers = 0;
-
-        // Metrics - Renderer
-        uint32_t m_renderer_meshes_rendered = 0;
+        // Heap allocations, counting them is opt-in (see AllocationTracker)
+        void SetTrackAllocations(const bool enabled)            { AllocationTracker::SetEnabled(enabled); }
+        bool GetTrackAllocations()                        const { return AllocationTracker::IsEnabled(); }
+        const AllocationCount& GetAllocationsLast()       const { return m_allocations_last; } // of every thread, during the last frame
+
+        // Subsystem ticks of the last frame, per tick group
+        const TickGraph& GetTickGraph(const TickType tick_group) const;
+
+        // Thread pool, measured over the last update interval
+        const std::vector<ThreadMetrics>& GetThreadMetrics()                const { return m_thread_metrics; }
+        const QueueLatencyHistogram& GetQueueLatency(const Task_Lane lane)  const { return m_queue_latency[static_cast<uint32_t>(lane)]; }
+        uint32_t GetQueueDepthPeak(const Task_Lane lane)                    const { return m_queue_depth_peak[static_cast<uint32_t>(lane)]; }
+
+        // Frame limiter, measured over the last update interval
+        const FramePacingMetrics& GetFramePacing()                          const { return m_frame_pacing; }
+
+        // Records the time blocks of every thread and of the GPU for a number of frames, then writes them out (on an I/O thread) as
+        // a Chrome trace, which can be opened with chrome://tracing or ui.perfetto.dev.
+        void CaptureTrace(uint32_t frame_count = 10, const std::string& file_path = "trace.json");
+        bool IsCapturingTrace() const { return m_trace_frames_remaining.load(std::memory_order_relaxed) != 0; }
+
+        // Keeps the last frame_count frames (time blocks, RHI counters and resource loads) in a ring. When a frame takes longer than
+        // threshold_ms, the ring is written out as a Chrome trace (hitch_<n>_<ms>ms.json) once a few more frames are in, so that a
+        // stutter can be looked at after the fact. Hitches which happen while one is written out are part of it.
+        void SetHitchCapture(bool enabled, float threshold_ms = 50.0f, uint32_t frame_count = 120);
+        bool IsCapturingHitches() const { return m_hitch_capture.load(std::memory_order_relaxed); }
+
+        // Can be called from any thread, resource loads show up in traces and hitch captures
+        void RecordResourceLoad(const std::string& file_path, const std::chrono::steady_clock::time_point& start);
+
+        // Named metrics which any subsystem can publish (see MetricRegistry), they show up in the profiler, in traces and in benchmarks.
+        // Register once (e.g. when initializing) and keep the id, updating can be done from any thread.
+        MetricId RegisterCounter(const std::string& name, const std::string& unit = "")     { return m_metric_registry.Register(name, MetricType::Counter, unit); }
+        MetricId RegisterGauge(const std::string& name, const std::string& unit = "")       { return m_metric_registry.Register(name, MetricType::Gauge, unit); }
+        MetricId RegisterHistogram(const std::string& name, const std::string& unit = "")   { return m_metric_registry.Register(name, MetricType::Histogram, unit); }
+        void CounterAdd(const MetricId id, const int64_t value = 1)                         { m_metric_registry.CounterAdd(id, value); }
+        void CounterAdd(const Metric metric, const int64_t value = 1)                       { m_metric_registry.CounterAdd(static_cast<MetricId>(metric), value); }
+        void GaugeSet(const MetricId id, const double value)                                { m_metric_registry.GaugeSet(id, value); }
+        void HistogramRecord(const MetricId id, const double value)                         { m_metric_registry.HistogramRecord(id, value); }
+        const std::vector<MetricValue>& GetMetricValues()                             const { return m_metric_registry.GetValues(); }
+        const MetricValue& GetMetricValue(const MetricId id)                          const { return m_metric_registry.GetValue(id); }
+        const MetricValue& GetMetricValue(const Metric metric)                        const { return m_metric_registry.GetValue(static_cast<MetricId>(metric)); }
+
+        // Metrics - Allocations
+        AllocationCount m_allocations_last;
+        AllocationCount m_allocations_total;
 
         // Metrics - Time
         float m_time_frame_avg = 0.0f;
@@ -89,42 +169,37 @@ namespace Genome
         float m_time_gpu_last = 0.0f;
 
     private:
-        void ClearRhiMetrics()
-        {
-            m_rhi_draw = 0;
-            m_rhi_dispatch = 0;
-            m_renderer_meshes_rendered = 0;
-            m_rhi_bindings_buffer_index = 0;
-            m_rhi_bindings_buffer_vertex = 0;
-            m_rhi_bindings_buffer_constant = 0;
-            m_rhi_bindings_sampler = 0;
-            m_rhi_bindings_texture_sampled = 0;
-            m_rhi_bindings_shader_vertex = 0;
-            m_rhi_bindings_shader_pixel = 0;
-            m_rhi_bindings_shader_compute = 0;
-            m_rhi_bindings_render_target = 0;
-            m_rhi_bindings_texture_storage = 0;
-            m_rhi_bindings_descriptor_set = 0;
-            m_rhi_bindings_pipeline = 0;
-            m_rhi_pipeline_barriers = 0;
-        }
-
+        ProfilerThread* GetThread();
+        void MergeThread(ProfilerThread* thread);
         TimeBlock* GetNewTimeBlock();
-        TimeBlock* GetLastIncompleteTimeBlock(TimeBlockType type = TimeBlockType::Undefined);
+        TimeBlock* GetLastIncompleteTimeBlock();
         void AcquireGpuData();
+        void UpdateThreadingMetrics();
+        void UpdateFramePacingMetrics();
         void UpdateRhiMetricsString();
+        void RecordTraceFrame();
+        void RecordHitchFrame(float frame_ms);
+        void WriteTrace(std::vector<TraceEvent> events, std::vector<TraceCounter> counters, const std::string& file_path);
 
         // Profiling options
-        bool m_profile = false;
+        std::atomic<bool> m_profile = false;
         bool m_profile_cpu = true; // cheap
         bool m_profile_gpu = true; // expensive
         float m_profiling_interval_sec = 0.3f;
         float m_time_since_profiling_sec = m_profiling_interval_sec;
 
-        // Time blocks (double buffered)
-        uint32_t m_time_block_capacity = 200;
+        // CPU time blocks, recorded as events by every thread and turned into time blocks (merged) when the frame ends
+        std::vector<std::shared_ptr<ProfilerThread>> m_threads;
+        std::mutex m_mutex_threads;
+        uint64_t m_instance_id = 0;
+
+        // GPU time blocks, recorded by the main thread (a deque, so that parents stay put while it grows)
         uint32_t m_time_block_count = 0;
-        std::vector<TimeBlock> m_time_blocks_write;
+        std::deque<TimeBlock> m_time_blocks_write;
+
+        // Time blocks of the last frame which was polled, merged from all of the above
+        std::vector<TimeBlock> m_time_blocks_merge;
+        std::vector<uint32_t> m_time_block_parents;
         std::vector<TimeBlock> m_time_blocks_read;
 
         // FPS
@@ -140,6 +215,54 @@ namespace Genome
         uint32_t m_gpu_memory_available = 0;
         uint32_t m_gpu_memory_used = 0;
 
+        // Thread pool
+        static constexpr uint32_t lane_count = static_cast<uint32_t>(Task_Lane::Count);
+        std::vector<ThreadStats> m_thread_stats;
+        std::vector<ThreadStats> m_thread_stats_previous;
+        std::vector<ThreadMetrics> m_thread_metrics;
+        QueueLatencyHistogram m_queue_latency[lane_count]           = {};
+        QueueLatencyHistogram m_queue_latency_previous[lane_count]  = {};
+        uint32_t m_queue_depth_peak[lane_count]                     = {};
+        Stopwatch m_threading_stopwatch;
+
+        // Metrics
+        MetricRegistry m_metric_registry;
+        uint64_t m_threading_tasks_spilled_total = 0;
+
+        // Frame pacing
+        FramePacingMetrics m_frame_pacing;
+        FramePacingStats m_frame_pacing_previous;
+
+        // Trace capture
+        std::atomic<uint32_t> m_trace_frames_remaining = 0;
+        std::string m_trace_file_path;
+        std::vector<TraceEvent> m_trace_events;
+        std::vector<TraceCounter> m_trace_counters;
+        std::mutex m_mutex_trace;
+
+        // The trace events and counters of the frame which just ended, and the resource loads which happened during it
+        std::vector<TraceEvent> m_frame_events;
+        std::vector<TraceCounter> m_frame_counters;
+        std::vector<TraceEvent> m_load_events;
+        std::mutex m_mutex_load_events;
+        std::chrono::steady_clock::time_point m_frame_start;
+
+        // Hitch capture, a ring of the last frames
+        struct HitchFrame
+        {
+            std::vector<TraceEvent> events;
+            std::vector<TraceCounter> counters;
+        };
+        std::vector<HitchFrame> m_hitch_frames;
+        std::atomic<bool> m_hitch_capture   = false;
+        float m_hitch_threshold_ms          = 50.0f;
+        uint32_t m_hitch_frame_index        = 0; // where the next frame goes
+        uint32_t m_hitch_frames_recorded    = 0;
+        uint32_t m_hitch_frames_remaining   = 0; // after a hitch, frames to record before writing out
+        uint32_t m_hitch_count              = 0;
+        float m_hitch_ms                    = 0.0f;
+        std::mutex m_mutex_hitch;
+
         // Stutter detection
         float m_stutter_delta_ms = 0.5f;
         bool m_is_stuttering_cpu = false;
@@ -148,13 +271,13 @@ namespace Genome
         // Misc
         bool m_poll = false;
         std::string m_metrics = "N/A";
-        bool m_increase_capacity = 0.0f;
-        bool m_allow_time_block_end = true;
+        std::thread::id m_thread_id_main;
 
         // Dependencies
         ResourceCache* m_resource_manager = nullptr;
         Renderer* m_renderer = nullptr;
         Timer* m_timer = nullptr;
+        Threading* m_threading = nullptr;
     };
 
     class ScopedTimeBlock
@@ -49,11 +49,9 @@ namespace Genome
         m_type              = type;
         m_max_tree_depth    = Math::Max(m_max_tree_depth, m_tree_depth);
 
-        if (type == TimeBlockType::Cpu)
-        {
-            m_start = chrono::high_resolution_clock::now();
-        }
-        else if (type == TimeBlockType::Gpu)
+        m_start = chrono::steady_clock::now();
+
+        if (type == TimeBlockType::Gpu)
         {
             // Create required queries
             if (!m_query_disjoint)
@@ -72,11 +70,9 @@ namespace Genome
 
     void TimeBlock::End()
     {
-        if (m_type == TimeBlockType::Cpu)
-        {
-            m_end = chrono::high_resolution_clock::now();
-        }
-        else if (m_type == TimeBlockType::Gpu)
+        m_end = chrono::steady_clock::now();
+
+        if (m_type == TimeBlockType::Gpu)
         {
             if (m_cmd_list)
             {
@@ -87,6 +83,26 @@ namespace Genome
         m_is_complete = true;
     }
 
+    void TimeBlock::Set(const char* name, const TimeBlockType type, const uint32_t tree_depth, const thread::id thread_id, const char* thread_name, const chrono::steady_clock::time_point& start)
+    {
+        m_name              = name;
+        m_type              = type;
+        m_parent            = nullptr;
+        m_tree_depth        = tree_depth;
+        m_thread_id         = thread_id;
+        m_thread_name       = thread_name;
+        m_start             = start;
+        m_max_tree_depth    = Math::Max(m_max_tree_depth, m_tree_depth);
+    }
+
+    void TimeBlock::SetEnd(const chrono::steady_clock::time_point& end, const float duration, const double start_gpu_ms /*= 0.0*/)
+    {
+        m_end           = end;
+        m_duration      = duration;
+        m_start_gpu_ms  = start_gpu_ms;
+        m_is_complete   = true;
+    }
+
     void TimeBlock::ComputeDuration(const uint32_t pass_index)
     {
         if (!m_is_complete)
@@ -104,7 +120,7 @@ namespace Genome
         {
             if (m_cmd_list)
             {
-                m_duration = m_cmd_list->Timestamp_GetDuration(m_query_disjoint, m_query_start, m_query_end, pass_index);
+                m_duration = m_cmd_list->Timestamp_GetDuration(m_query_disjoint, m_query_start, m_query_end, pass_index, &m_start_gpu_ms);
             }
         }
     }
@@ -115,6 +131,10 @@ namespace Genome
         m_parent            = nullptr;
         m_tree_depth        = 0;
         m_duration          = 0.0f;
+        m_start_gpu_ms      = 0.0;
+        m_thread_id         = thread::id();
+        m_thread_name       = nullptr;
+        m_allocations       = AllocationCount();
         m_max_tree_depth    = 0;
         m_type              = TimeBlockType::Undefined;
         m_is_complete       = false;
@@ -24,6 +24,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <chrono>
 #include <memory>
+#include <thread>
+#include "AllocationTracker.h"
 #include "..\RHI\RHI_Definition.h"
 //================================
 
@@ -48,6 +50,13 @@ namespace Genome
         void End();
         void ComputeDuration(const uint32_t pass_index);
         void Reset();
+
+        // For blocks which were timed elsewhere and are only presented, e.g. the events a thread recorded
+        void Set(const char* name, TimeBlockType type, uint32_t tree_depth, std::thread::id thread_id, const char* thread_name, const std::chrono::steady_clock::time_point& start);
+        void SetEnd(const std::chrono::steady_clock::time_point& end, float duration, double start_gpu_ms = 0.0);
+        void SetParent(const TimeBlock* parent) { m_parent = parent; }
+        void SetAllocations(const AllocationCount& allocations) { m_allocations = allocations; }
+
         TimeBlockType GetType()         const { return m_type; }
         const char* GetName()           const { return m_name; }
         const TimeBlock* GetParent()    const { return m_parent; }
@@ -55,6 +64,16 @@ namespace Genome
         uint32_t GetTreeDepthMax()      const { return m_max_tree_depth; }
         float GetDuration()             const { return m_duration; }
         bool IsComplete()               const { return m_is_complete; }
+        std::thread::id GetThreadId()   const { return m_thread_id; }
+        const char* GetThreadName()     const { return m_thread_name; }
+
+        // Heap allocations the thread made during the block (including its children), zero unless allocations are tracked
+        const AllocationCount& GetAllocations() const { return m_allocations; }
+
+        // When the block was recorded on the CPU, and for GPU blocks, when it started executing (on the GPU's clock)
+        const std::chrono::steady_clock::time_point& GetStart() const { return m_start; }
+        const std::chrono::steady_clock::time_point& GetEnd()   const { return m_end; }
+        double GetStartGpuMs()                                  const { return m_start_gpu_ms; }
 
     private:    
         static uint32_t FindTreeDepth(const TimeBlock* time_block, uint32_t depth = 0);
@@ -67,12 +86,16 @@ namespace Genome
         uint32_t m_tree_depth       = 0;
         bool m_is_complete          = false;
         RHI_Device* m_rhi_device    = nullptr;
+        std::thread::id m_thread_id;
+        const char* m_thread_name   = nullptr;
+        AllocationCount m_allocations;
 
         // CPU timing
         std::chrono::steady_clock::time_point m_start;
         std::chrono::steady_clock::time_point m_end;
     
         // GPU timing
+        double m_start_gpu_ms       = 0.0;
         void* m_query_disjoint      = nullptr;
         void* m_query_start         = nullptr;
         void* m_query_end           = nullptr;
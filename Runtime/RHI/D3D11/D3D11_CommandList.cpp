@@ -134,7 +134,7 @@ namespace Genome
             {
                 device_context->VSSetShader(shader, nullptr, 0);
 
-                m_profiler->m_rhi_bindings_shader_vertex++;
+                m_profiler->CounterAdd(Metric::RhiBindingsShaderVertex);
             }
         }
 
@@ -152,7 +152,7 @@ namespace Genome
             {
                 device_context->PSSetShader(shader, nullptr, 0);
 
-                m_profiler->m_rhi_bindings_shader_pixel++;
+                m_profiler->CounterAdd(Metric::RhiBindingsShaderPixel);
             }
         }
 
@@ -170,7 +170,7 @@ namespace Genome
             {
                 device_context->CSSetShader(shader, nullptr, 0);
 
-                m_profiler->m_rhi_bindings_shader_compute++;
+                m_profiler->CounterAdd(Metric::RhiBindingsShaderCompute);
             }
         }
 
@@ -309,7 +309,7 @@ namespace Genome
                         depth_stencil
                     );
 
-                    m_profiler->m_rhi_bindings_render_target++;
+                    m_profiler->CounterAdd(Metric::RhiBindingsRenderTarget);
                 }
             }
         }
@@ -324,7 +324,7 @@ namespace Genome
         ClearPipelineStateRenderTargets(pipeline_state);
 
         m_renderer->SetGlobalSamplersAndConstantBuffers(this);
-        m_profiler->m_rhi_bindings_pipeline++;
+        m_profiler->CounterAdd(Metric::RhiBindingsPipeline);
 
         return true;
     }
@@ -436,7 +436,7 @@ namespace Genome
     bool RHI_CommandList::Draw(const uint32_t vertex_count)
     {
         m_rhi_device->GetContextRhi()->device_context->Draw(static_cast<UINT>(vertex_count), 0);
-        m_profiler->m_rhi_draw++;
+        m_profiler->CounterAdd(Metric::RhiDraw);
 
         return true;
     }
@@ -450,7 +450,7 @@ namespace Genome
             static_cast<INT>(vertex_offset)
         );
 
-        m_profiler->m_rhi_draw++;
+        m_profiler->CounterAdd(Metric::RhiDraw);
 
         return true;
     }
@@ -461,7 +461,7 @@ namespace Genome
         ID3D11DeviceContext4* device_context = m_rhi_device->GetContextRhi()->device_context;
 
         device_context->Dispatch(x, y, z);
-        m_profiler->m_rhi_dispatch++;
+        m_profiler->CounterAdd(Metric::RhiDispatch);
 
         // Make sure to clean the compute shader UAV slots after dispatching.
         // If we try to bind the resource but it's still bound as a computer shader output the runtime will automatically set the ID3D11ShaderResourceView to null.
@@ -516,7 +516,7 @@ namespace Genome
 
         // Set
         device_context->IASetVertexBuffers(0, 1, &vertex_buffer, &stride, offsets);
-        m_profiler->m_rhi_bindings_buffer_vertex++;
+        m_profiler->CounterAdd(Metric::RhiBindingsBufferVertex);
     }
 
     void RHI_CommandList::SetBufferIndex(const RHI_IndexBuffer* buffer, const uint64_t offset /*= 0*/)
@@ -543,7 +543,7 @@ namespace Genome
 
         // Set
         device_context->IASetIndexBuffer(index_buffer, format, static_cast<UINT>(offset));
-        m_profiler->m_rhi_bindings_buffer_index++;
+        m_profiler->CounterAdd(Metric::RhiBindingsBufferIndex);
     }
 
     bool RHI_CommandList::SetConstantBuffer(const uint32_t slot, const uint8_t scope, RHI_ConstantBuffer* constant_buffer) const
@@ -561,7 +561,7 @@ namespace Genome
             if (set_buffer != buffer)
             {
                 device_context->VSSetConstantBuffers(slot, range, reinterpret_cast<ID3D11Buffer* const*>(range > 1 ? buffer : &buffer_array));
-                m_profiler->m_rhi_bindings_buffer_constant++;
+                m_profiler->CounterAdd(Metric::RhiBindingsBufferConstant);
             }
         }
 
@@ -573,7 +573,7 @@ namespace Genome
             if (set_buffer != buffer)
             {
                 device_context->PSSetConstantBuffers(slot, range, reinterpret_cast<ID3D11Buffer* const*>(range > 1 ? buffer : &buffer_array));
-                m_profiler->m_rhi_bindings_buffer_constant++;
+                m_profiler->CounterAdd(Metric::RhiBindingsBufferConstant);
             }
         }
 
@@ -585,7 +585,7 @@ namespace Genome
             if (set_buffer != buffer)
             {
                 device_context->CSSetConstantBuffers(slot, range, reinterpret_cast<ID3D11Buffer* const*>(range > 1 ? buffer : &buffer_array));
-                m_profiler->m_rhi_bindings_buffer_constant++;
+                m_profiler->CounterAdd(Metric::RhiBindingsBufferConstant);
             }
         }
 
@@ -607,7 +607,7 @@ namespace Genome
             if (set_sampler != sampler_array[0])
             {
                 device_context->CSSetSamplers(start_slot, range, reinterpret_cast<ID3D11SamplerState* const*>(&sampler_array));
-                m_profiler->m_rhi_bindings_sampler++;
+                m_profiler->CounterAdd(Metric::RhiBindingsSampler);
             }
         }
         else
@@ -618,7 +618,7 @@ namespace Genome
             if (set_sampler != sampler_array[0])
             {
                 device_context->PSSetSamplers(start_slot, range, reinterpret_cast<ID3D11SamplerState* const*>(&sampler_array));
-                m_profiler->m_rhi_bindings_sampler++;
+                m_profiler->CounterAdd(Metric::RhiBindingsSampler);
             }
         }
     }
@@ -642,7 +642,7 @@ namespace Genome
             if (set_uav != uav_array[0])
             {
                 device_context->CSSetUnorderedAccessViews(start_slot, range, reinterpret_cast<ID3D11UnorderedAccessView* const*>(&uav_array), nullptr);
-                m_profiler->m_rhi_bindings_texture_storage++;
+                m_profiler->CounterAdd(Metric::RhiBindingsTextureStorage);
             }
         }
         // Textures
@@ -659,7 +659,7 @@ namespace Genome
                 if (set_srv != srv_array[0])
                 {
                     device_context->PSSetShaderResources(start_slot, range, reinterpret_cast<ID3D11ShaderResourceView* const*>(&srv_array));
-                    m_profiler->m_rhi_bindings_texture_sampled++;
+                    m_profiler->CounterAdd(Metric::RhiBindingsTextureSampled);
                 }
             }
             else if (scope & RHI_Shader_Compute)
@@ -670,7 +670,7 @@ namespace Genome
                 if (set_srv != srv_array[0])
                 {
                     device_context->CSSetShaderResources(start_slot, range, reinterpret_cast<ID3D11ShaderResourceView* const*>(&srv_array));
-                    m_profiler->m_rhi_bindings_texture_sampled++;
+                    m_profiler->CounterAdd(Metric::RhiBindingsTextureSampled);
                 }
             }
         }
@@ -719,7 +719,7 @@ namespace Genome
         return true;
     }
 
-    float RHI_CommandList::Timestamp_GetDuration(void* query_disjoint, void* query_start, void* query_end, const uint32_t pass_index)
+    float RHI_CommandList::Timestamp_GetDuration(void* query_disjoint, void* query_start, void* query_end, const uint32_t pass_index, double* start_ms /*= nullptr*/)
     {
         if (!query_disjoint || !query_start || !query_end)
         {
@@ -753,6 +753,11 @@ namespace Genome
         const uint64_t delta        = end_time - start_time;
         const double duration_ms    = (delta * 1000.0) / static_cast<double>(disjoint_data.Frequency);
 
+        if (start_ms)
+        {
+            *start_ms = (start_time * 1000.0) / static_cast<double>(disjoint_data.Frequency);
+        }
+
         return static_cast<float>(duration_ms);
     }
 
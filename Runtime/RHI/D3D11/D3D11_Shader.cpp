@@ -128,11 +128,11 @@ namespace Genome
                 const auto is_error = line.find("error") != string::npos;
                 if (is_error)
                 {
-                    LOG_ERROR(line);
+                    LOG_ERROR("%s", line.c_str());
                 }
                 else
                 {
-                    LOG_WARNING(line);
+                    LOG_WARNING("%s", line.c_str());
                 }
             }
 
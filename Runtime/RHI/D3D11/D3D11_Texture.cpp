@@ -241,6 +241,12 @@ namespace Genome
         m_layout = new_layout;
     }
 
+    bool RHI_Texture::IsUploaded()
+    {
+        // Textures are created with their data, so there is nothing to wait for
+        return true;
+    }
+
     bool RHI_Texture2D::CreateResourceGpu()
     {
         if (!m_rhi_device || !m_rhi_device->GetContextRhi()->device)
@@ -164,7 +164,7 @@ namespace Genome
         return true;
     }
 
-    float RHI_CommandList::Timestamp_GetDuration(void* query_disjoint, void* query_start, void* query_end, const uint32_t pass_index)
+    float RHI_CommandList::Timestamp_GetDuration(void* query_disjoint, void* query_start, void* query_end, const uint32_t pass_index, double* start_ms /*= nullptr*/)
     {
         return 0.0f;
     }
@@ -42,6 +42,11 @@ namespace Genome
     void RHI_Texture::SetLayout(const RHI_Image_Layout new_layout, RHI_CommandList* command_list /*= nullptr*/)
     {
         
+    }
+
+    bool RHI_Texture::IsUploaded()
+    {
+        return true;
     }
 
 	bool RHI_Texture2D::CreateResourceGpu()
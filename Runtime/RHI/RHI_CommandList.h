@@ -103,7 +103,7 @@ namespace Genome
         // Timestamps
         bool Timestamp_Start(void* query_disjoint = nullptr, void* query_start = nullptr);
         bool Timestamp_End(void* query_disjoint = nullptr, void* query_end = nullptr);
-        float Timestamp_GetDuration(void* query_disjoint, void* query_start, void* query_end, const uint32_t pass_index);
+        float Timestamp_GetDuration(void* query_disjoint, void* query_start, void* query_end, const uint32_t pass_index, double* start_ms = nullptr); // start_ms is on the GPU's clock
 
         static uint32_t Gpu_GetMemory(RHI_Device* rhi_device);
         static uint32_t Gpu_GetMemoryUsed(RHI_Device* rhi_device);
@@ -109,21 +109,21 @@ namespace Genome
     template <typename T>
     void RHI_Shader::CompileAsync(const RHI_Shader_Type type, const string& shader)
     {
-        m_context->GetSubsystem<Threading>()->AddTask([this, type, shader]()
+        m_compilation = m_context->GetSubsystem<Threading>()->AddTask([this, type, shader]()
         {
             Compile<T>(type, shader);
-        });
+        }, Task_Lane::Background);
     }
 
     void RHI_Shader::WaitForCompilation()
     {
-        // Wait
-        while (m_compilation_state == Shader_Compilation_State::Compiling)
+        // Wait, this thread helps with other tasks (e.g. other shaders) in the meantime
+        if (m_compilation.IsValid() && !m_compilation.IsReady())
         {
             LOG_INFO("Waiting for shader \"%s\" to compile...", m_name.c_str());
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            m_compilation.Wait();
         }
-        
+
         // Log error in case of failure
         if (m_compilation_state != Shader_Compilation_State::Succeeded)
         {
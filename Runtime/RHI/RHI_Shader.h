@@ -29,6 +29,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Core/SpartanObject.h"
 #include "RHI_Vertex.h"
 #include "RHI_Descriptor.h"
+#include "../Threading/Threading.h"
 #include <atomic>
 //================================
 
@@ -88,6 +89,7 @@ namespace Genome
         std::vector<RHI_Descriptor> m_descriptors;
         std::shared_ptr<RHI_InputLayout> m_input_layout;
         std::atomic<Shader_Compilation_State> m_compilation_state   = Shader_Compilation_State::Idle;
+        Future<void> m_compilation;
         RHI_Shader_Type m_shader_type                               = RHI_Shader_Unknown;
         RHI_Vertex_Type m_vertex_type                               = RHI_Vertex_Type_Unknown;
 
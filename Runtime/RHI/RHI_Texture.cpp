@@ -110,6 +110,18 @@ namespace Genome
     }
 
     bool RHI_Texture::LoadFromFile(const string& path)
+    {
+        // The steps the resource cache spreads over threads, in a row
+        return LoadFromFile_Read(path) && LoadFromFile_Import(path) && Upload(path, false);
+    }
+
+    bool RHI_Texture::LoadFromFile_Upload(const string& path)
+    {
+        // Don't wait for the GPU, the resource cache polls IsUploaded()
+        return Upload(path, true);
+    }
+
+    bool RHI_Texture::LoadFromFile_Read(const string& path)
     {
         // Validate file path
         if (!FileSystem::IsFile(path))
@@ -124,13 +136,13 @@ namespace Genome
 
         // Load from disk
         auto texture_data_loaded = false;
-        if (FileSystem::IsEngineTextureFile(path)) // engine format (binary)
+        if (FileSystem::IsEngineTextureFile(path)) // engine format (binary), there is nothing to import
         {
             texture_data_loaded = LoadFromFile_NativeFormat(path);
         }    
-        else if (FileSystem::IsSupportedImageFile(path)) // foreign format (most known image formats)
+        else if (FileSystem::IsSupportedImageFile(path)) // foreign format (most known image formats), imported next
         {
-            texture_data_loaded = LoadFromFile_ForeignFormat(path, m_flags & RHI_Texture_GenerateMipsWhenLoading);
+            texture_data_loaded = FileSystem::ReadFileBytes(path, m_file_data);
         }
 
         // Ensure that we have the data
@@ -141,10 +153,42 @@ namespace Genome
             return false;
         }
 
+        return true;
+    }
+
+    bool RHI_Texture::LoadFromFile_Import(const string& path)
+    {
+        if (!FileSystem::IsEngineTextureFile(path))
+        {
+            // Decode the file which was read
+            ImageImporter* importer = m_context->GetSubsystem<ResourceCache>()->GetImageImporter();
+            const bool imported     = importer->Load(path, m_file_data, this, m_flags & RHI_Texture_GenerateMipsWhenLoading);
+            m_file_data.clear();
+            m_file_data.shrink_to_fit();
+
+            if (!imported)
+            {
+                LOG_ERROR("Failed to load \"%s\".", path.c_str());
+                m_load_state = LoadState::Failed;
+                return false;
+            }
+
+            // Set resource file path so it can be used by the resource cache
+            SetResourceFilePath(path);
+        }
+
         m_mip_count = static_cast<uint32_t>(m_data.size());
 
+        return true;
+    }
+
+    bool RHI_Texture::Upload(const string& path, const bool async)
+    {
         // Create GPU resource
-        if (!m_context->GetSubsystem<Renderer>()->GetRhiDevice()->IsInitialized() || !CreateResourceGpu())
+        m_upload_async = async;
+        const bool created = m_context->GetSubsystem<Renderer>()->GetRhiDevice()->IsInitialized() && CreateResourceGpu();
+        m_upload_async = false;
+        if (!created)
         {
             LOG_ERROR("Failed to create shader resource for \"%s\".", GetResourceFilePathNative().c_str());
             m_load_state = LoadState::Failed;
@@ -152,6 +196,7 @@ namespace Genome
         }
 
         // Only clear texture bytes if that's an engine texture, if not, it's not serialized yet.
+        // The GPU doesn't need them any more, even if it's still uploading, they have been staged.
         if (FileSystem::IsEngineTextureFile(path))
         {
             m_data.clear();
@@ -229,19 +274,6 @@ namespace Genome
         return data;
     }
 
-    bool RHI_Texture::LoadFromFile_ForeignFormat(const string& file_path, const bool generate_mipmaps)
-    {
-        // Load texture
-        ImageImporter* importer = m_context->GetSubsystem<ResourceCache>()->GetImageImporter();    
-        if (!importer->Load(file_path, this, generate_mipmaps))
-            return false;
-
-        // Set resource file path so it can be used by the resource cache
-        SetResourceFilePath(file_path);
-
-        return true;
-    }
-
     bool RHI_Texture::LoadFromFile_NativeFormat(const string& file_path)
     {
         auto file = make_unique<FileStream>(file_path, FileStream_Read);
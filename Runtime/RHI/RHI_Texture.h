@@ -56,10 +56,14 @@ namespace Genome
         RHI_Texture(Context* context);
         ~RHI_Texture();
 
-        //= IResource ===========================================
+        //= IResource ==================================================
         bool SaveToFile(const std::string& file_path) override;
         bool LoadFromFile(const std::string& file_path) override;
-        //=======================================================
+        bool LoadFromFile_Read(const std::string& file_path) override;
+        bool LoadFromFile_Import(const std::string& file_path) override;
+        bool LoadFromFile_Upload(const std::string& file_path) override;
+        bool IsUploaded() override;
+        //==============================================================
 
         auto GetWidth() const                                           { return m_width; }
         void SetWidth(const uint32_t width)                             { m_width = width; }
@@ -126,7 +130,7 @@ namespace Genome
 
     protected:
         bool LoadFromFile_NativeFormat(const std::string& file_path);
-        bool LoadFromFile_ForeignFormat(const std::string& file_path, bool generate_mipmaps);
+        bool Upload(const std::string& file_path, bool async);
         static uint32_t GetChannelCountFromFormat(RHI_Format format);
         virtual bool CreateResourceGpu() { LOG_ERROR("Function not implemented by API"); return false; }
 
@@ -141,12 +145,20 @@ namespace Genome
         uint16_t m_flags            = 0;
         RHI_Viewport m_viewport;
         std::vector<std::vector<std::byte>> m_data;
+        std::vector<std::byte> m_file_data; // a file of a foreign format, between reading and importing it
         std::shared_ptr<RHI_Device> m_rhi_device;
 
+        // An upload which doesn't wait for the GPU, see IsUploaded()
+        bool m_upload_async = false;
+        std::shared_ptr<RHI_Fence> m_upload_fence;
+
         // API
         void* m_resource_view[2]                = { nullptr, nullptr }; // color/depth, stencil
         void* m_resource_view_unorderedAccess   = nullptr;
         void* m_resource                        = nullptr;
+        void* m_upload_cmd_pool                 = nullptr;
+        void* m_upload_cmd_buffer               = nullptr;
+        void* m_upload_staging_buffer           = nullptr;
         std::array<void*, rhi_max_render_target_count> m_resource_view_renderTarget           = { nullptr };
         std::array<void*, rhi_max_render_target_count> m_resource_view_depthStencil           = { nullptr };
         std::array<void*, rhi_max_render_target_count> m_resource_view_depthStencilReadOnly   = { nullptr };
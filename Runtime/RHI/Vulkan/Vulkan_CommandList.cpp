@@ -430,7 +430,7 @@ namespace Genome
             0                                           // firstInstance
         );
 
-        m_profiler->m_rhi_draw++;
+        m_profiler->CounterAdd(Metric::RhiDraw);
 
         return true;
     }
@@ -453,7 +453,7 @@ namespace Genome
             0                                           // firstInstance
         );
 
-        m_profiler->m_rhi_draw++;
+        m_profiler->CounterAdd(Metric::RhiDraw);
 
         return true;
     }
@@ -468,7 +468,7 @@ namespace Genome
             return false;
 
         vkCmdDispatch(static_cast<VkCommandBuffer>(m_cmd_buffer), x, y, z);
-        m_profiler->m_rhi_dispatch++;
+        m_profiler->CounterAdd(Metric::RhiDispatch);
 
         return true;
     }
@@ -532,7 +532,7 @@ namespace Genome
             offsets                                     // pOffsets
         );
 
-        m_profiler->m_rhi_bindings_buffer_vertex++;
+        m_profiler->CounterAdd(Metric::RhiBindingsBufferVertex);
         m_vertex_buffer_id      = buffer->GetId();
         m_vertex_buffer_offset  = offset;
     }
@@ -552,7 +552,7 @@ namespace Genome
             buffer->Is16Bit() ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32 // indexType
         );
 
-        m_profiler->m_rhi_bindings_buffer_index++;
+        m_profiler->CounterAdd(Metric::RhiBindingsBufferIndex);
         m_index_buffer_id       = buffer->GetId();
         m_index_buffer_offset   = offset;
     }
@@ -725,7 +725,7 @@ namespace Genome
         return true;
     }
 
-    float RHI_CommandList::Timestamp_GetDuration(void* query_disjoint, void* query_start, void* query_end, const uint32_t pass_index)
+    float RHI_CommandList::Timestamp_GetDuration(void* query_disjoint, void* query_start, void* query_end, const uint32_t pass_index, double* start_ms /*= nullptr*/)
     {
         if (pass_index + 1 >= m_timestamps.size())
         {
@@ -743,6 +743,11 @@ namespace Genome
         uint64_t duration   = Math::Clamp<uint64_t>(end - start, 0, std::numeric_limits<uint64_t>::max());
         float duration_ms   = static_cast<float>(duration * m_rhi_device->GetContextRhi()->device_properties.limits.timestampPeriod * 1e-6f);
 
+        if (start_ms)
+        {
+            *start_ms = static_cast<double>(start) * m_rhi_device->GetContextRhi()->device_properties.limits.timestampPeriod * 1e-6;
+        }
+
         return duration_ms;
     }
 
@@ -909,7 +914,7 @@ namespace Genome
                 !dynamic_offsets.empty() ? dynamic_offsets.data() : nullptr     // pDynamicOffsets
             );
 
-            m_profiler->m_rhi_bindings_descriptor_set++;
+            m_profiler->CounterAdd(Metric::RhiBindingsDescriptorSet);
         }
 
         return result;
@@ -923,7 +928,7 @@ namespace Genome
             VkPipelineBindPoint pipeline_bind_point = m_pipeline_state->IsCompute() ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS;
 
             vkCmdBindPipeline(static_cast<VkCommandBuffer>(m_cmd_buffer), pipeline_bind_point, vk_pipeline);
-            m_profiler->m_rhi_bindings_pipeline++;
+            m_profiler->CounterAdd(Metric::RhiBindingsPipeline);
             m_pipeline_active = true;
         }
         else
@@ -221,15 +221,15 @@ namespace Genome
                 {
                     if (line.find("error") != string::npos)
                     {
-                        LOG_ERROR(line);
+                        LOG_ERROR("%s", line.c_str());
                     }
                     else if (line.find("warning") != string::npos)
                     {
-                        LOG_WARNING(line);
+                        LOG_WARNING("%s", line.c_str());
                     }
                     else if (!FileSystem::IsEmptyOrWhitespace(line))
                     {
-                        LOG_INFO(line);
+                        LOG_INFO("%s", line.c_str());
                     }
                 }
             }
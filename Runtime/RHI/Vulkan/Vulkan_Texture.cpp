@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI_Device.h"
 #include "../RHI_Texture2D.h"
 #include "../RHI_TextureCube.h"
+#include "../RHI_Fence.h"
 #include "../RHI_CommandList.h"
 #include "../../Profiling/Profiler.h"
 #include "../../Rendering/Renderer.h"
@@ -177,6 +178,85 @@ namespace Genome
         return true;
     }
 
+    // Frees what an upload which doesn't wait used, once the GPU is done with it
+    inline void release_upload(void*& cmd_pool, void*& cmd_buffer, void*& staging_buffer)
+    {
+        if (cmd_buffer)
+        {
+            vulkan_utility::command_buffer::destroy(cmd_pool, cmd_buffer);
+            cmd_buffer = nullptr;
+        }
+
+        if (cmd_pool)
+        {
+            vulkan_utility::command_pool::destroy(cmd_pool);
+        }
+
+        vulkan_utility::buffer::destroy(staging_buffer);
+    }
+
+    // Like stage() followed by the transition to the final layout, but without waiting. The command buffer has a pool
+    // of its own, as it's in flight while others are recorded, the fence signals once the GPU is done with both of them.
+    inline bool stage_async(RHI_Texture* texture, RHI_Image_Layout& texture_layout, const RHI_Image_Layout target_layout, shared_ptr<RHI_Fence>& fence, void*& cmd_pool, void*& cmd_buffer, void*& staging_buffer)
+    {
+        // The texture is uploaded again before the previous upload completed
+        if (cmd_pool)
+        {
+            fence->Wait();
+            release_upload(cmd_pool, cmd_buffer, staging_buffer);
+        }
+
+        // Copy the texture's data to a staging buffer
+        std::vector<VkBufferImageCopy> buffer_image_copies(texture->GetMipCount());
+        if (!copy_to_staging_buffer(texture, buffer_image_copies, staging_buffer))
+            return false;
+
+        // Record
+        bool recorded = vulkan_utility::command_pool::create(cmd_pool, RHI_Queue_Graphics) && vulkan_utility::command_buffer::create(cmd_pool, cmd_buffer, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        if (recorded)
+        {
+            VkCommandBufferBeginInfo begin_info = {};
+            begin_info.sType                    = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            begin_info.flags                    = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            recorded = vulkan_utility::error::check(vkBeginCommandBuffer(static_cast<VkCommandBuffer>(cmd_buffer), &begin_info));
+        }
+
+        // Transition to a layout which can be copied to, copy the staging buffer to the image, and transition to the final layout
+        const RHI_Image_Layout layout = RHI_Image_Layout::Transfer_Dst_Optimal;
+        recorded = recorded && vulkan_utility::image::set_layout(cmd_buffer, texture, layout);
+        if (recorded)
+        {
+            texture_layout = layout;
+
+            vkCmdCopyBufferToImage(
+                static_cast<VkCommandBuffer>(cmd_buffer),
+                static_cast<VkBuffer>(staging_buffer),
+                static_cast<VkImage>(texture->Get_Resource()),
+                vulkan_image_layout[static_cast<uint8_t>(layout)],
+                static_cast<uint32_t>(buffer_image_copies.size()),
+                buffer_image_copies.data()
+            );
+        }
+        recorded = recorded && vulkan_utility::image::set_layout(cmd_buffer, texture, target_layout);
+        recorded = recorded && vulkan_utility::error::check(vkEndCommandBuffer(static_cast<VkCommandBuffer>(cmd_buffer)));
+
+        // Submit, without waiting
+        if (recorded && !fence)
+        {
+            fence = make_shared<RHI_Fence>(vulkan_utility::globals::rhi_device, "texture_upload");
+        }
+        if (!recorded || !fence->Reset() || !vulkan_utility::globals::rhi_device->Queue_Submit(RHI_Queue_Graphics, VK_PIPELINE_STAGE_TRANSFER_BIT, cmd_buffer, nullptr, nullptr, fence.get()))
+        {
+            release_upload(cmd_pool, cmd_buffer, staging_buffer);
+            return false;
+        }
+
+        // Let the texture know about it's new layout
+        texture_layout = target_layout;
+
+        return true;
+    }
+
     inline RHI_Image_Layout GetAppropriateLayout(RHI_Texture* texture)
     {
         RHI_Image_Layout target_layout = RHI_Image_Layout::Preinitialized;
@@ -205,6 +285,7 @@ namespace Genome
 
         // Wait in case it's still in use by the GPU
         m_rhi_device->Queue_WaitAll();
+        IsUploaded(); // frees what an upload which didn't wait used
         
         // Make sure that no descriptor sets refer to this texture.
         // Right now I just reset the descriptor set layout cache, which works but it's not ideal.
@@ -244,12 +325,24 @@ namespace Genome
             if (!vulkan_utility::image::set_layout(static_cast<VkCommandBuffer>(command_list->GetResource_CommandBuffer()), this, new_layout))
                 return;
 
-            m_context->GetSubsystem<Profiler>()->m_rhi_pipeline_barriers++;
+            m_context->GetSubsystem<Profiler>()->CounterAdd(Metric::RhiPipelineBarriers);
         }
 
         m_layout = new_layout;
     }
 
+    bool RHI_Texture::IsUploaded()
+    {
+        if (!m_upload_cmd_pool)
+            return true;
+
+        if (!m_upload_fence->IsSignaled())
+            return false;
+
+        release_upload(m_upload_cmd_pool, m_upload_cmd_buffer, m_upload_staging_buffer);
+        return true;
+    }
+
     bool RHI_Texture2D::CreateResourceGpu()
     {
         // Create image
@@ -259,10 +352,12 @@ namespace Genome
             return false;
         }
 
-        // If the texture has any data, stage it
+        // If the texture has any data, stage it. An upload which doesn't wait transitions to the target layout as well.
+        const RHI_Image_Layout target_layout = GetAppropriateLayout(this);
         if (HasData())
         {
-            if (!stage(this, m_layout))
+            const bool staged = m_upload_async ? stage_async(this, m_layout, target_layout, m_upload_fence, m_upload_cmd_pool, m_upload_cmd_buffer, m_upload_staging_buffer) : stage(this, m_layout);
+            if (!staged)
             {
                 LOG_ERROR("Failed to stage");
                 return false;
@@ -270,26 +365,27 @@ namespace Genome
         }
 
         // Transition to target layout
-        if (VkCommandBuffer cmd_buffer = vulkan_utility::command_buffer_immediate::begin(RHI_Queue_Graphics))
-        {    
-            RHI_Image_Layout target_layout = GetAppropriateLayout(this);
-                
-            // Transition to the final layout
-            if (!vulkan_utility::image::set_layout(cmd_buffer, this, target_layout))
-            {
-                LOG_ERROR("Failed to transition layout");
-                return false;
-            }
+        if (m_layout != target_layout)
+        {
+            if (VkCommandBuffer cmd_buffer = vulkan_utility::command_buffer_immediate::begin(RHI_Queue_Graphics))
+            {    
+                // Transition to the final layout
+                if (!vulkan_utility::image::set_layout(cmd_buffer, this, target_layout))
+                {
+                    LOG_ERROR("Failed to transition layout");
+                    return false;
+                }
         
-            // Flush
-            if (!vulkan_utility::command_buffer_immediate::end(RHI_Queue_Graphics))
-            {
-                LOG_ERROR("Failed to end command buffer");
-                return false;
-            }
+                // Flush
+                if (!vulkan_utility::command_buffer_immediate::end(RHI_Queue_Graphics))
+                {
+                    LOG_ERROR("Failed to end command buffer");
+                    return false;
+                }
 
-            // Update this texture with the new layout
-            m_layout = target_layout;
+                // Update this texture with the new layout
+                m_layout = target_layout;
+            }
         }
 
         // Create image views
@@ -347,6 +443,7 @@ namespace Genome
             return;
 
         m_rhi_device->Queue_WaitAll();
+        IsUploaded(); // frees what an upload which didn't wait used
         m_data.clear();
 
         vulkan_utility::image::view::destroy(m_resource_view[0]);
@@ -368,28 +465,31 @@ namespace Genome
             return false;
         }
 
-        // If the texture has any data, stage it
+        // If the texture has any data, stage it. An upload which doesn't wait transitions to the target layout as well.
+        const RHI_Image_Layout target_layout = GetAppropriateLayout(this);
         if (HasData())
         {
-            if (!stage(this, m_layout))
+            const bool staged = m_upload_async ? stage_async(this, m_layout, target_layout, m_upload_fence, m_upload_cmd_pool, m_upload_cmd_buffer, m_upload_staging_buffer) : stage(this, m_layout);
+            if (!staged)
                 return false;
         }
 
         // Transition to target layout
-        if (VkCommandBuffer cmd_buffer = vulkan_utility::command_buffer_immediate::begin(RHI_Queue_Graphics))
+        if (m_layout != target_layout)
         {
-            RHI_Image_Layout target_layout = GetAppropriateLayout(this);
-
-            // Transition to the final layout
-            if (!vulkan_utility::image::set_layout(cmd_buffer, this, target_layout))
-                return false;
+            if (VkCommandBuffer cmd_buffer = vulkan_utility::command_buffer_immediate::begin(RHI_Queue_Graphics))
+            {
+                // Transition to the final layout
+                if (!vulkan_utility::image::set_layout(cmd_buffer, this, target_layout))
+                    return false;
 
-            // Flush
-            if (!vulkan_utility::command_buffer_immediate::end(RHI_Queue_Graphics))
-                return false;
+                // Flush
+                if (!vulkan_utility::command_buffer_immediate::end(RHI_Queue_Graphics))
+                    return false;
 
-            // Update this texture with the new layout
-            m_layout = target_layout;
+                // Update this texture with the new layout
+                m_layout = target_layout;
+            }
         }
 
         // Create image views
@@ -9,6 +9,7 @@
 #include "../Utilities/Sampling.h"
 #include "../Profiling/Profiler.h"
 #include "../Resource/ResourceCache.h"
+#include "../Threading/Threading.h"
 #include "../World/Entity.h"
 #include "../World/Components/Transform.h"
 #include "../World/Components/Renderable.h"
@@ -61,14 +62,15 @@ namespace Genome
         m_option_values[Renderer_Option_Value::Fog] = 0.1f;
 
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(EventType::WorldResolved, EVENT_HANDLER_VARIANT(RenderablesAcquire));
-        SUBSCRIBE_TO_EVENT(EventType::WorldClear, EVENT_HANDLER(Clear));
+        m_event_world_resolved  = SUBSCRIBE_TO_EVENT(EventType::WorldResolved, EVENT_HANDLER(RenderablesAcquire));
+        m_event_world_clear     = SUBSCRIBE_TO_EVENT(EventType::WorldClear, EVENT_HANDLER(Clear));
     }
 
     Renderer::~Renderer()
     {
         // Unsubscribe from events
-        UNSUBSCRIBE_FROM_EVENT(EventType::WorldResolved, EVENT_HANDLER_VARIANT(RenderablesAcquire));
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_resolved);
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_clear);
 
         m_entities.clear();
         m_camera = nullptr;
@@ -121,6 +123,12 @@ namespace Genome
             }
         }
 
+        // Fonts and textures are read from disk, load them on the I/O threads while everything else is created
+        Threading* threading = m_context->GetSubsystem<Threading>();
+        TaskCounter counter_loads;
+        threading->AddTask([this]() { CreateFonts(); }, &counter_loads, Task_Lane::Io);
+        threading->AddTask([this]() { CreateTextures(); }, &counter_loads, Task_Lane::Io);
+
         // Full-screen quad
         m_viewport_quad = Math::Rectangle(0, 0, window_data.width, window_data.height);
         m_viewport_quad.CreateBuffers(this);
@@ -143,9 +151,8 @@ namespace Genome
         CreateRasterizerStates();
         CreateBlendStates();
         CreateRenderTextures();
-        CreateFonts();
         CreateSamplers();
-        CreateTextures();
+        threading->Wait(counter_loads);
 
         if (!m_initialized)
         {
@@ -281,6 +288,22 @@ namespace Genome
         }
     }
 
+    TickDependencies Renderer::GetTickDependencies() const
+    {
+        // Owns the swapchain, so it stays on the main thread
+        TickDependencies dependencies;
+        dependencies.reads          = Tick_Resource_World | Tick_Resource_Transforms | Tick_Resource_Time | Tick_Resource_Resources | Tick_Resource_Physics;
+        dependencies.writes         = Tick_Resource_Renderer;
+        dependencies.main_thread    = true;
+        return dependencies;
+    }
+
+    InitDependencies Renderer::GetInitDependencies() const
+    {
+        // Creates the swapchain, which belongs to the thread of the window. Fonts and textures need the importers.
+        return InitAfter<ResourceCache>(true);
+    }
+
     void Renderer::SetViewport(float width, float height, float offset_x /*= 0*/, float offset_y /*= 0*/)
     {
         if (m_viewport.width != width || m_viewport.height != height)
@@ -543,7 +566,7 @@ namespace Genome
         return cmd_list->SetConstantBuffer(4, RHI_Shader_Pixel, m_buffer_light_gpu);
     }
 
-    void Renderer::RenderablesAcquire(const Variant& entities_variant)
+    void Renderer::RenderablesAcquire()
     {
         SCOPED_TIME_BLOCK(m_profiler);
 
@@ -551,38 +574,38 @@ namespace Genome
         m_entities.clear();
         m_camera = nullptr;
 
-        vector<shared_ptr<Entity>> entities = entities_variant.Get<vector<shared_ptr<Entity>>>();
-        for (const auto& entity : entities)
+        // Visit the components we are interested in directly, rather than every entity and every component of it
+        World* world = m_context->GetSubsystem<World>();
+
+        for (IComponent* component : world->ComponentGetAll(ComponentType::Renderable))
         {
-            if (!entity || !entity->IsActive())
+            Entity* entity = component->GetEntity();
+            if (!entity->IsActive())
                 continue;
 
-            // Get all the components we are interested in
-            Renderable* renderable = entity->GetComponent<Renderable>();
-            Light* light = entity->GetComponent<Light>();
-            Camera* camera = entity->GetComponent<Camera>();
-
-            if (renderable)
+            bool is_transparent = false;
+            if (const Material* material = static_cast<Renderable*>(component)->GetMaterial())
             {
-                bool is_transparent = false;
-
-                if (const Material* material = renderable->GetMaterial())
-                {
-                    is_transparent = material->GetColorAlbedo().w < 1.0f;
-                }
-
-                m_entities[is_transparent ? Renderer_Object_Transparent : Renderer_Object_Opaque].emplace_back(entity.get());
+                is_transparent = material->GetColorAlbedo().w < 1.0f;
             }
 
-            if (light)
+            m_entities[is_transparent ? Renderer_Object_Transparent : Renderer_Object_Opaque].emplace_back(entity);
+        }
+
+        for (IComponent* component : world->ComponentGetAll(ComponentType::Light))
+        {
+            if (component->GetEntity()->IsActive())
             {
-                m_entities[Renderer_Object_Light].emplace_back(entity.get());
+                m_entities[Renderer_Object_Light].emplace_back(component->GetEntity());
             }
+        }
 
-            if (camera)
+        for (IComponent* component : world->ComponentGetAll(ComponentType::Camera))
+        {
+            if (component->GetEntity()->IsActive())
             {
-                m_entities[Renderer_Object_Camera].emplace_back(entity.get());
-                m_camera = camera->GetPtrShared<Camera>();
+                m_entities[Renderer_Object_Camera].emplace_back(component->GetEntity());
+                m_camera = component->GetPtrShared<Camera>();
             }
         }
 
@@ -8,6 +8,7 @@
 #include "Renderer_Enums.h"
 #include "Material.h"
 #include "../Core/ISubsystem.h"
+#include "../Core/EventSystem.h"
 #include "../Math/Rectangle.h"
 #include "../RHI/RHI_Definition.h"
 #include "../RHI/RHI_Viewport.h"
@@ -24,7 +25,6 @@ namespace Genome
     class Light;
     class ResourceCache;
     class Font;
-    class Variant;
     class Grid;
     class TransformGizmo;
     class Profiler;
@@ -54,10 +54,12 @@ namespace Genome
         Renderer(Context* context);
         ~Renderer();
 
-        //= ISubsystem ======================
+        //= ISubsystem =======================================
         bool Initialize() override;
         void Tick(float delta_time) override;
-        //===================================
+        TickDependencies GetTickDependencies() const override;
+        InitDependencies GetInitDependencies() const override;
+        //====================================================
 
         // Primitive rendering
         void TickPrimitives(const float delta_time);
@@ -204,7 +206,7 @@ namespace Genome
         bool UpdateLightBuffer(RHI_CommandList* cmd_list, const Light* light);
 
         // Misc
-        void RenderablesAcquire(const Variant& renderables);
+        void RenderablesAcquire();
         void RenderablesSort(std::vector<Entity*>* renderables);
 
         // Render targets
@@ -327,6 +329,10 @@ namespace Genome
         std::array<Material*, m_max_material_instances> m_material_instances;
         std::shared_ptr<Camera> m_camera;
 
+        // Events
+        EventToken m_event_world_resolved;
+        EventToken m_event_world_clear;
+
         // Dependencies
         Profiler* m_profiler = nullptr;
         ResourceCache* m_resource_cache = nullptr;
@@ -553,7 +553,7 @@ namespace Genome
 
                 // Render
                 cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
-                m_profiler->m_renderer_meshes_rendered++;
+                m_profiler->CounterAdd(Metric::RendererMeshesRendered);
             }
 
             if (render_pass_active)
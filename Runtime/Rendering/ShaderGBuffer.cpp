@@ -41,6 +41,10 @@ namespace Genome
 
     const ShaderGBuffer* ShaderGBuffer::GenerateVariation(Context* context, const uint16_t flags)
     {
+        // Materials can be loaded by multiple threads at once
+        static mutex mutex_variations;
+        lock_guard<mutex> lock(mutex_variations);
+
         // Return existing shader, if it's already compiled
         if (m_variations.find(flags) != m_variations.end())
             return m_variations.at(flags).get();
@@ -111,6 +111,14 @@ namespace Genome
         virtual bool SaveToFile(const std::string& file_path)    { return true; }
         virtual bool LoadFromFile(const std::string& file_path)  { return true; }
 
+        // Loading in steps, so that the resource cache can overlap loads without a thread waiting on the disk or the GPU.
+        // It reads on the I/O threads, imports on the workers, uploads and then polls IsUploaded(). Resources which
+        // don't split their loading do all of it in LoadFromFile(), when importing.
+        virtual bool LoadFromFile_Read(const std::string& file_path)    { return true; }
+        virtual bool LoadFromFile_Import(const std::string& file_path)  { return LoadFromFile(file_path); }
+        virtual bool LoadFromFile_Upload(const std::string& file_path)  { return true; }
+        virtual bool IsUploaded()                                       { return true; }
+
         // Type
         template <typename T>
         static constexpr ResourceType TypeToEnum();
@@ -107,23 +107,23 @@ namespace Genome::AssimpHelper
         void OnDebug(const char* message) override
         {
 #ifdef DEBUG
-            LOG_INFO(message, LogType::Info);
+            LOG_INFO("%s", message);
 #endif
         }
 
         void OnInfo(const char* message) override
         {
-            LOG_INFO(message, LogType::Info);
+            LOG_INFO("%s", message);
         }
 
         void OnWarn(const char* message) override
         {
-            LOG_WARNING(message, LogType::Warning);
+            LOG_WARNING("%s", message);
         }
 
         void OnError(const char* message) override
         {
-            LOG_ERROR(message, LogType::Error);
+            LOG_ERROR("%s", message);
         }
     };
 
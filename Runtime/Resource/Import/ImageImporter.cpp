@@ -44,7 +44,6 @@ namespace Genome::freeimage_helper
         uint32_t height          = 0;
         uint32_t channel_count   = 0;
         vector<std::byte>* data  = nullptr;
-        bool done                = false;
 
         RescaleJob(const uint32_t width, const uint32_t height, const uint32_t channel_count)
         {
@@ -196,6 +195,46 @@ namespace Genome
             return false;
         }
 
+        return LoadFromBitmap(bitmap, texture, generate_mipmaps);
+    }
+
+    bool ImageImporter::Load(const string& file_path, const vector<std::byte>& file_data, RHI_Texture* texture, const bool generate_mipmaps /*= true*/)
+    {
+        if (!texture || file_data.empty())
+        {
+            LOG_ERROR_INVALID_PARAMETER();
+            return false;
+        }
+
+        // FreeImage only reads from the memory, it just doesn't take it as const
+        FIMEMORY* memory = FreeImage_OpenMemory(reinterpret_cast<BYTE*>(const_cast<std::byte*>(file_data.data())), static_cast<DWORD>(file_data.size()));
+
+        // Acquire image format
+        FREE_IMAGE_FORMAT format = FreeImage_GetFileTypeFromMemory(memory, 0);
+
+        // If the format is unknown, try to work it out from the file path
+        format = (format == FIF_UNKNOWN) ? FreeImage_GetFIFFromFilename(file_path.c_str()) : format;
+        if (!FreeImage_FIFSupportsReading(format)) // If the format is still unknown, give up
+        {
+            LOG_ERROR("Unsupported format");
+            FreeImage_CloseMemory(memory);
+            return false;
+        }
+
+        // Decode the image
+        auto bitmap = FreeImage_LoadFromMemory(format, memory, 0);
+        FreeImage_CloseMemory(memory);
+        if (!bitmap)
+        {
+            LOG_ERROR("Failed to decode \"%s\"", file_path.c_str());
+            return false;
+        }
+
+        return LoadFromBitmap(bitmap, texture, generate_mipmaps);
+    }
+
+    bool ImageImporter::LoadFromBitmap(FIBITMAP* bitmap, RHI_Texture* texture, const bool generate_mipmaps)
+    {
         // Deduce image properties. Important that this is done here, before ApplyBitmapCorrections(),
         // as after that, results for grayscale seem to be always false
         const bool image_is_transparent = FreeImage_IsTransparent(bitmap);
@@ -316,36 +355,19 @@ namespace Genome
         }
 
         // Parallelize mipmap generation using multiple threads (because FreeImage_Rescale() is expensive)
-        auto threading = m_context->GetSubsystem<Threading>();
-        for (auto& job : jobs)
+        m_context->GetSubsystem<Threading>()->ParallelFor(0, static_cast<uint32_t>(jobs.size()), 1, [this, &jobs, &bitmap](uint32_t i_start, uint32_t i_end)
         {
-            threading->AddTask([this, &job, &bitmap]()
+            for (uint32_t i = i_start; i < i_end; i++)
             {
+                RescaleJob& job = jobs[i];
                 FIBITMAP* bitmap_scaled = FreeImage_Rescale(bitmap, job.width, job.height, rescale_filter);
                 if (!GetBitsFromFibitmap(job.data, bitmap_scaled, job.width, job.height, job.channel_count))
                 {
                     LOG_ERROR("Failed to create mip level %dx%d", job.width, job.height);
                 }
                 FreeImage_Unload(bitmap_scaled);
-                job.done = true;
-            });
-        }
-
-        // Wait until all mipmaps have been generated
-        auto ready = false;
-        while (!ready)
-        {
-            ready = true;
-            for (const auto& job : jobs)
-            {
-                if (!job.done)
-                {
-                    ready = false;
-                }
             }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
-        }
+        });
     }
 
     FIBITMAP* ImageImporter::ApplyBitmapCorrections(FIBITMAP* bitmap) const
@@ -41,8 +41,11 @@ namespace Genome
         ~ImageImporter();
 
         bool Load(const std::string& file_path, RHI_Texture* texture, bool generate_mipmaps = true);
+        // Decodes a file which has already been read into memory, the path is only used to tell its format if the data doesn't
+        bool Load(const std::string& file_path, const std::vector<std::byte>& file_data, RHI_Texture* texture, bool generate_mipmaps = true);
 
     private:    
+        bool LoadFromBitmap(FIBITMAP* bitmap, RHI_Texture* texture, bool generate_mipmaps);
         bool GetBitsFromFibitmap(std::vector<std::byte>* data, FIBITMAP* bitmap, uint32_t width, uint32_t height, uint32_t channels) const;
         void GenerateMipmaps(FIBITMAP* bitmap, RHI_Texture* texture, uint32_t width, uint32_t height, uint32_t channels);
         FIBITMAP* ApplyBitmapCorrections(FIBITMAP* bitmap) const;
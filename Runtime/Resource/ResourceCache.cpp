@@ -33,6 +33,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_TextureCube.h"
 #include "../Audio/AudioClip.h"
 #include "../Rendering/Model.h"
+#include "../Profiling/Profiler.h"
 //=================================
 
 //= NAMESPACES ================
@@ -58,15 +59,13 @@ namespace Genome
         SetProjectDirectory("Project/");
 
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(EventType::WorldSave, EVENT_HANDLER(SaveResourcesToFiles));
-        SUBSCRIBE_TO_EVENT(EventType::WorldLoad, EVENT_HANDLER(LoadResourcesFromFiles));
+        m_event_world_save = SUBSCRIBE_TO_EVENT(EventType::WorldSave, EVENT_HANDLER(SaveResourcesToFiles));
     }
 
     ResourceCache::~ResourceCache()
     {
         // Unsubscribe from events
-        UNSUBSCRIBE_FROM_EVENT(EventType::WorldSave, EVENT_HANDLER(SaveResourcesToFiles));
-        UNSUBSCRIBE_FROM_EVENT(EventType::WorldLoad, EVENT_HANDLER(LoadResourcesFromFiles));
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_save);
     }
 
     bool ResourceCache::Initialize()
@@ -76,6 +75,13 @@ namespace Genome
         m_importer_model  = std::make_shared<ModelImporter>(m_context);
         m_importer_font   = std::make_shared<FontImporter>(m_context);
 
+        // Metrics
+        if (Profiler* profiler = m_context->GetSubsystem<Profiler>())
+        {
+            m_metric_loads      = profiler->RegisterCounter("resource/loads");
+            m_metric_load_time  = profiler->RegisterHistogram("resource/load_time", "ms");
+        }
+
         return true;
     }
 
@@ -87,6 +93,8 @@ namespace Genome
             return false;
         }
 
+        std::lock_guard<std::mutex> guard(m_mutex);
+
         for (std::shared_ptr<IResource>& resource : m_resources)
         {
             if (resource_name == resource->GetResourceName())
@@ -96,22 +104,25 @@ namespace Genome
         return false;
     }
 
-    std::shared_ptr<IResource>& ResourceCache::GetByName(const std::string& name, const ResourceType type)
+    std::shared_ptr<IResource> ResourceCache::GetByName(const std::string& name, const ResourceType type)
     {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
         for (std::shared_ptr<IResource>& resource : m_resources)
         {
             if (name == resource->GetResourceName())
                 return resource;
         }
 
-        static std::shared_ptr<IResource> empty;
-        return empty;
+        return nullptr;
     }
 
     std::vector<std::shared_ptr<IResource>> ResourceCache::GetByType(const ResourceType type /*= ResourceType::Unknown*/)
     {
         std::vector<std::shared_ptr<IResource>> resources;
 
+        std::lock_guard<std::mutex> guard(m_mutex);
+
         for (std::shared_ptr<IResource>& resource : m_resources)
         {
             if (resource->GetResourceType() == type || type == ResourceType::Unknown)
@@ -127,6 +138,8 @@ namespace Genome
     {
         uint64_t size = 0;
 
+        std::lock_guard<std::mutex> guard(m_mutex);
+
         for (std::shared_ptr<IResource>& resource : m_resources)
         {
             if (resource->GetResourceType() == type || type == ResourceType::Unknown)
@@ -145,6 +158,8 @@ namespace Genome
     {
         uint64_t size = 0;
 
+        std::lock_guard<std::mutex> guard(m_mutex);
+
         for (std::shared_ptr<IResource>& resource : m_resources)
         {
             if (resource->GetResourceType() == type || type == ResourceType::Unknown)
@@ -159,6 +174,16 @@ namespace Genome
         return size;
     }
 
+    void ResourceCache::RecordLoad(const std::string& file_path, const std::chrono::steady_clock::time_point& start) const
+    {
+        if (Profiler* profiler = m_context->GetSubsystem<Profiler>())
+        {
+            profiler->CounterAdd(m_metric_loads);
+            profiler->HistogramRecord(m_metric_load_time, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            profiler->RecordResourceLoad(file_path, start);
+        }
+    }
+
     void ResourceCache::SaveResourcesToFiles()
     {
         // Start progress report
@@ -203,17 +228,22 @@ namespace Genome
         progress_tracker.SetIsLoading(ProgressType::ResourceCache, false);
     }
 
-    void ResourceCache::LoadResourcesFromFiles()
+    Future<void> ResourceCache::LoadResourcesFromFiles()
     {
+        Threading* threading = m_context->GetSubsystem<Threading>();
+
         // Open resource list file
         auto file_path = GetProjectDirectoryAbsolute() + m_context->GetSubsystem<World>()->GetName() + "_resources.dat";
         auto file = std::make_unique<FileStream>(file_path, FileStream_Read);
         if (!file->IsOpen())
-            return;
+            return threading->WhenAll(std::vector<Future<void>>());
 
         // Load resource count
         const auto resource_count = file->ReadAs<uint32_t>();
 
+        // Start all the loads, so that they overlap on the I/O threads
+        std::vector<Future<std::shared_ptr<IResource>>> loads;
+        loads.reserve(resource_count);
         for (uint32_t i = 0; i < resource_count; i++)
         {
             // Load resource file path
@@ -225,30 +255,33 @@ namespace Genome
             switch (type)
             {
             case ResourceType::Model:
-                Load<Model>(file_path);
+                loads.emplace_back(StartLoad<Model>(file_path));
                 break;
             case ResourceType::Material:
-                Load<Material>(file_path);
+                loads.emplace_back(StartLoad<Material>(file_path));
                 break;
             case ResourceType::Texture:
-                Load<RHI_Texture>(file_path);
+                loads.emplace_back(StartLoad<RHI_Texture>(file_path));
                 break;
             case ResourceType::Texture2d:
-                Load<RHI_Texture2D>(file_path);
+                loads.emplace_back(StartLoad<RHI_Texture2D>(file_path));
                 break;
             case ResourceType::TextureCube:
-                Load<RHI_TextureCube>(file_path);
+                loads.emplace_back(StartLoad<RHI_TextureCube>(file_path));
                 break;
             case ResourceType::Audio:
-                Load<AudioClip>(file_path);
+                loads.emplace_back(StartLoad<AudioClip>(file_path));
                 break;
             }
         }
 
+        return threading->WhenAll(loads);
     }
 
     void ResourceCache::Clear()
     {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
         uint32_t resource_count = static_cast<uint32_t>(m_resources.size());
 
         m_resources.clear();
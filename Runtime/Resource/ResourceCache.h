@@ -21,11 +21,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ==================
+//= INCLUDES ======================
 #include <unordered_map>
 #include "IResource.h"
 #include "../Core/ISubsystem.h"
-//=============================
+#include "../Core/EventSystem.h"
+#include "../Threading/Threading.h"
+#include "../Profiling/Metrics.h"
+//=================================
 
 namespace Genome
 {
@@ -51,12 +54,14 @@ namespace Genome
         ResourceCache(Context* context);
         ~ResourceCache();
 
-        //= Subsystem =============
+        //= Subsystem ==================================================================
         bool Initialize() override;
-        //=========================
+        TickDependencies GetTickDependencies() const override { return { 0, 0, true }; }
+        InitDependencies GetInitDependencies() const override { return InitAfter<>(); }
+        //==============================================================================
 
         // Get by name
-        std::shared_ptr<IResource>& GetByName(const std::string& name, ResourceType type);
+        std::shared_ptr<IResource> GetByName(const std::string& name, ResourceType type);
         template <class T> 
         constexpr std::shared_ptr<T> GetByName(const std::string& name) 
         { 
@@ -70,6 +75,8 @@ namespace Genome
         template <class T>
         std::shared_ptr<T> GetByPath(const std::string& path)
         {
+            std::lock_guard<std::mutex> guard(m_mutex);
+
             for (std::shared_ptr<IResource>& resource : m_resources)
             {
                 if (path == resource->GetResourceFilePathNative())
@@ -101,18 +108,23 @@ namespace Genome
                 return nullptr;
             }
 
-            // Ensure that this resource is not already cached
-            if (IsCached(resource->GetResourceName(), resource->GetResourceType()))
-                return GetByName<T>(resource->GetResourceName());
+            // Cache it, unless it's already cached (checked under the same lock, so that two threads can't both add it)
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
 
-            // Prevent threads from colliding in critical section
-            std::lock_guard<std::mutex> guard(m_mutex);
+                for (std::shared_ptr<IResource>& cached : m_resources)
+                {
+                    if (resource->GetResourceName() == cached->GetResourceName())
+                        return std::static_pointer_cast<T>(cached);
+                }
 
-            // In order to guarantee deserialization, we save it now
+                m_resources.emplace_back(resource);
+            }
+
+            // In order to guarantee deserialization, we save it now (outside of the lock, it's disk I/O)
             resource->SaveToFile(resource->GetResourceFilePathNative());
 
-            // Cache it
-            return std::static_pointer_cast<T>(m_resources.emplace_back(resource));
+            return resource;
         }
         bool IsCached(const std::string& resource_name, ResourceType resource_type);
 
@@ -125,6 +137,8 @@ namespace Genome
             if (!IsCached(resource->GetResourceName(), resource->GetResourceType()))
                 return;
 
+            std::lock_guard<std::mutex> guard(m_mutex);
+
             m_resources.erase(
                 remove_if(
                     m_resources.begin(),
@@ -157,7 +171,10 @@ namespace Genome
             typed->SetResourceFilePath(file_path);
 
             // Load
-            if (!typed || !typed->LoadFromFile(file_path))
+            const std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
+            const bool loaded = typed && typed->LoadFromFile(file_path);
+            RecordLoad(file_path, load_start);
+            if (!loaded)
             {
                 LOG_ERROR("Failed to load \"%s\".", file_path.c_str());
                 return nullptr;
@@ -167,6 +184,20 @@ namespace Genome
             return Cache<T>(typed);
         }
 
+        // Loads a resource without blocking and adds it to the resource cache, the future holds nullptr if loading failed.
+        // Loads of the same file share the work. Continue with Then() rather than waiting, to keep the calling thread free.
+        template <class T>
+        Future<std::shared_ptr<T>> LoadAsync(const std::string& file_path)
+        {
+            return StartLoad<T>(file_path).Then([](const std::shared_ptr<IResource>& resource)
+            {
+                return std::static_pointer_cast<T>(resource);
+            }, Task_Lane::High);
+        }
+
+        // Starts loading the resources the world uses (as saved with it), the future completes once they are all cached
+        Future<void> LoadResourcesFromFiles();
+
         //= MISC =============================================================
         // Memory
         uint64_t GetMemoryUsageCpu(ResourceType type = ResourceType::Unknown);
@@ -191,14 +222,106 @@ namespace Genome
         auto GetFontImporter()                    const { return m_importer_font.get(); }
 
     private:
+        // Starts loading a resource, or joins the load which is already in flight for the same file
+        template <class T>
+        Future<std::shared_ptr<IResource>> StartLoad(const std::string& file_path)
+        {
+            Threading* threading = m_context->GetSubsystem<Threading>();
+            Promise<std::shared_ptr<IResource>> promise(threading);
+
+            if (!FileSystem::Exists(file_path))
+            {
+                LOG_ERROR("\"%s\" doesn't exist.", file_path.c_str());
+                promise.SetValue(nullptr);
+                return promise.GetFuture();
+            }
+
+            // Already loaded
+            const std::string name = FileSystem::GetFileNameNoExtensionFromFilePath(file_path);
+            if (IsCached(name, IResource::TypeToEnum<T>()))
+            {
+                promise.SetValue(GetByName(name, IResource::TypeToEnum<T>()));
+                return promise.GetFuture();
+            }
+
+            // Already loading
+            {
+                std::lock_guard<std::mutex> guard(m_mutex_loads);
+
+                const auto it = m_loads.find(file_path);
+                if (it != m_loads.end())
+                    return it->second;
+
+                m_loads[file_path] = promise.GetFuture();
+            }
+
+            // Read on the I/O threads, import on the workers, then upload and continue once the GPU is done with it
+            std::shared_ptr<T> typed = std::make_shared<T>(m_context);
+            typed->SetResourceFilePath(file_path); // a default file path in case it's not overridden by loading
+            const std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
+            threading->AddTask([typed, file_path]()
+            {
+                return typed->LoadFromFile_Read(file_path);
+            }, Task_Lane::Io)
+            .Then([typed, file_path](const bool& read)
+            {
+                return read && typed->LoadFromFile_Import(file_path);
+            }, Task_Lane::Background)
+            .Then([threading, typed, file_path](const bool& imported)
+            {
+                if (!imported || !typed->LoadFromFile_Upload(file_path))
+                {
+                    Promise<bool> failed(threading);
+                    failed.SetValue(false);
+                    return failed.GetFuture();
+                }
+
+                return threading->WhenSignaled([typed]() { return typed->IsUploaded(); }).Then([]() { return true; });
+            })
+            .Then([this, typed, file_path, load_start, promise](const bool& loaded)
+            {
+                RecordLoad(file_path, load_start);
+
+                // Returned cached reference which is guaranteed to be around after deserialization
+                std::shared_ptr<IResource> resource;
+                if (loaded)
+                {
+                    resource = Cache<T>(typed);
+                }
+                else
+                {
+                    LOG_ERROR("Failed to load \"%s\".", file_path.c_str());
+                }
+
+                {
+                    std::lock_guard<std::mutex> guard(m_mutex_loads);
+                    m_loads.erase(file_path);
+                }
+
+                promise.SetValue(std::move(resource));
+            }, Task_Lane::Io); // caching saves the resource
+
+            return promise.GetFuture();
+        }
+
+        // Lets the profiler show the load in traces and count it
+        void RecordLoad(const std::string& file_path, const std::chrono::steady_clock::time_point& start) const;
+
         // Event handlers
         void SaveResourcesToFiles();
-        void LoadResourcesFromFiles();
 
         // Cache
         std::vector<std::shared_ptr<IResource>> m_resources;
         std::mutex m_mutex;
 
+        // Loads in flight, by file path
+        std::unordered_map<std::string, Future<std::shared_ptr<IResource>>> m_loads;
+        std::mutex m_mutex_loads;
+
+        // Metrics
+        MetricId m_metric_loads     = MetricRegistry::capacity;
+        MetricId m_metric_load_time = MetricRegistry::capacity;
+
         // Directories
         std::unordered_map<ResourceDirectory, std::string> m_standard_resource_directories;
         std::string m_project_directory;
@@ -207,5 +330,8 @@ namespace Genome
         std::shared_ptr<ModelImporter> m_importer_model;
         std::shared_ptr<ImageImporter> m_importer_image;
         std::shared_ptr<FontImporter> m_importer_font;
+
+        // Events
+        EventToken m_event_world_save;
     };
 }
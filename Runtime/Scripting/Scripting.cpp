@@ -49,6 +49,13 @@ namespace Genome
         mono_jit_cleanup(m_domain);
     }
 
+    InitDependencies Scripting::GetInitDependencies() const
+    {
+        // Mono makes the thread which initializes it its main thread, and scripts are called from the main thread.
+        // The scripts directory is known from the moment the resource cache is constructed, so nothing to wait for.
+        return InitAfter<>(true);
+    }
+
     bool Scripting::Initialize()
     {
         resource_cache = m_context->GetSubsystem<ResourceCache>();
@@ -46,9 +46,11 @@ namespace Genome
         Scripting(Context* context);
         ~Scripting();
 
-        //= Subsystem =============
+        //= Subsystem ==================================================================
         bool Initialize() override;
-        //=========================
+        TickDependencies GetTickDependencies() const override { return { 0, 0, true }; }
+        InitDependencies GetInitDependencies() const override;
+        //==============================================================================
 
         uint32_t Load(const std::string& file_path, Script* script_component);
         ScriptInstance* GetScript(const uint32_t id);
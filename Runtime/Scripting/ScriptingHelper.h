@@ -75,12 +75,12 @@ namespace Genome::ScriptingHelper
             const auto is_error = line.find("error") != std::string::npos;
             if (is_error)
             {
-                LOG_ERROR(line);
+                LOG_ERROR("%s", line.c_str());
                 compilation_result = false;
             }
             else
             {
-                LOG_INFO(line);
+                LOG_INFO("%s", line.c_str());
             }
         }
 
@@ -0,0 +1,390 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =========
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstdint>
+//====================
+
+namespace Genome
+{
+    // Chase-Lev work stealing deque.
+    // Only the owning thread may call Push() and Pop(), any thread may call Steal().
+    // The owner works LIFO (hot caches), thieves take the oldest item (FIFO).
+    template <typename T>
+    class WorkStealingQueue
+    {
+    public:
+        WorkStealingQueue(const int64_t capacity = 1024)
+        {
+            m_buffer = new Buffer(capacity);
+            m_top    = 0;
+            m_bottom = 0;
+        }
+
+        ~WorkStealingQueue()
+        {
+            delete m_buffer.load(std::memory_order_relaxed);
+        }
+
+        void Push(T item)
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            const int64_t top    = m_top.load(std::memory_order_acquire);
+            Buffer* buffer       = m_buffer.load(std::memory_order_relaxed);
+
+            // Grow if full, thieves might still be reading the old buffer so it's retired instead of deleted
+            if (bottom - top > buffer->capacity - 1)
+            {
+                Buffer* buffer_new = buffer->Grow(bottom, top);
+                m_buffers_retired.emplace_back(buffer);
+                m_buffer.store(buffer_new, std::memory_order_release);
+                buffer = buffer_new;
+            }
+
+            buffer->Set(bottom, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        bool Pop(T& item)
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            Buffer* buffer       = m_buffer.load(std::memory_order_relaxed);
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top          = m_top.load(std::memory_order_relaxed);
+
+            // Empty
+            if (top > bottom)
+            {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            item = buffer->Get(bottom);
+
+            // Last item, race against thieves
+            if (top == bottom)
+            {
+                const bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return won;
+            }
+
+            return true;
+        }
+
+        bool Steal(T& item)
+        {
+            int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return false;
+
+            Buffer* buffer = m_buffer.load(std::memory_order_acquire);
+            item = buffer->Get(top);
+
+            return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        bool IsEmpty() const
+        {
+            return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+        }
+
+        uint32_t GetSize() const
+        {
+            const int64_t size = m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed);
+            return size > 0 ? static_cast<uint32_t>(size) : 0;
+        }
+
+    private:
+        struct Buffer
+        {
+            Buffer(const int64_t capacity)
+            {
+                this->capacity  = capacity;
+                mask            = capacity - 1;
+                items           = new std::atomic<T>[static_cast<size_t>(capacity)];
+            }
+
+            ~Buffer() { delete[] items; }
+
+            T Get(const int64_t i) const            { return items[i & mask].load(std::memory_order_relaxed); }
+            void Set(const int64_t i, T item)       { items[i & mask].store(item, std::memory_order_relaxed); }
+
+            Buffer* Grow(const int64_t bottom, const int64_t top) const
+            {
+                Buffer* buffer = new Buffer(capacity * 2);
+                for (int64_t i = top; i != bottom; i++)
+                {
+                    buffer->Set(i, Get(i));
+                }
+                return buffer;
+            }
+
+            int64_t capacity    = 0; // must be a power of two
+            int64_t mask        = 0;
+            std::atomic<T>* items = nullptr;
+        };
+
+        alignas(64) std::atomic<int64_t> m_top;
+        alignas(64) std::atomic<int64_t> m_bottom;
+        alignas(64) std::atomic<Buffer*> m_buffer;
+        std::vector<std::unique_ptr<Buffer>> m_buffers_retired; // owner only
+    };
+
+    // Bounded multi-producer/multi-consumer queue (Vyukov).
+    // Used by threads which don't own a WorkStealingQueue to hand work to the pool.
+    template <typename T>
+    class ConcurrentQueue
+    {
+    public:
+        ConcurrentQueue(const uint32_t capacity = 4096)
+        {
+            m_mask  = capacity - 1; // must be a power of two
+            m_cells = std::vector<Cell>(capacity);
+            for (uint32_t i = 0; i < capacity; i++)
+            {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            m_enqueue_pos.store(0, std::memory_order_relaxed);
+            m_dequeue_pos.store(0, std::memory_order_relaxed);
+        }
+
+        bool TryPush(T item)
+        {
+            Cell* cell;
+            size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            while (true)
+            {
+                cell = &m_cells[pos & m_mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t dif    = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+                if (dif == 0)
+                {
+                    if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (dif < 0) // full
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = m_enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->item = item;
+            cell->sequence.store(pos + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        bool TryPop(T& item)
+        {
+            Cell* cell;
+            size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            while (true)
+            {
+                cell = &m_cells[pos & m_mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t dif    = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+                if (dif == 0)
+                {
+                    if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (dif < 0) // empty
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+
+            item = cell->item;
+            cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        uint32_t GetSize() const
+        {
+            const size_t enqueued = m_enqueue_pos.load(std::memory_order_relaxed);
+            const size_t dequeued = m_dequeue_pos.load(std::memory_order_relaxed);
+            return enqueued > dequeued ? static_cast<uint32_t>(enqueued - dequeued) : 0;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            T item;
+        };
+
+        size_t m_mask = 0;
+        std::vector<Cell> m_cells;
+        alignas(64) std::atomic<size_t> m_enqueue_pos;
+        alignas(64) std::atomic<size_t> m_dequeue_pos;
+    };
+
+    // Unbounded multi-producer/single-consumer queue (Vyukov), pushing never blocks and never fails.
+    // Only one thread at a time may call TryPop().
+    template <typename T>
+    class MpscQueue
+    {
+    public:
+        MpscQueue()
+        {
+            m_head.store(&m_stub, std::memory_order_relaxed);
+            m_tail = &m_stub;
+        }
+
+        ~MpscQueue()
+        {
+            T item;
+            while (TryPop(item)) {}
+        }
+
+        void Push(T item)
+        {
+            Push(new Node(std::move(item)));
+        }
+
+        bool TryPop(T& item)
+        {
+            Node* tail = m_tail;
+            Node* next = tail->next.load(std::memory_order_acquire);
+
+            // Skip the stub
+            if (tail == &m_stub)
+            {
+                if (!next)
+                    return false;
+
+                m_tail  = next;
+                tail    = next;
+                next    = next->next.load(std::memory_order_acquire);
+            }
+
+            if (next)
+            {
+                m_tail = next;
+                item   = std::move(tail->item);
+                delete tail;
+                return true;
+            }
+
+            // A producer is in the middle of pushing, its item will be visible shortly
+            if (tail != m_head.load(std::memory_order_acquire))
+                return false;
+
+            // Tail is the last node, put the stub behind it so that it can be popped
+            Push(&m_stub);
+            next = tail->next.load(std::memory_order_acquire);
+            if (next)
+            {
+                m_tail = next;
+                item   = std::move(tail->item);
+                delete tail;
+                return true;
+            }
+
+            return false;
+        }
+
+    private:
+        struct Node
+        {
+            Node() = default;
+            Node(T&& item) : item(std::move(item)) {}
+
+            T item;
+            std::atomic<Node*> next = nullptr;
+        };
+
+        void Push(Node* node)
+        {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+            previous->next.store(node, std::memory_order_release);
+        }
+
+        alignas(64) std::atomic<Node*> m_head;
+        alignas(64) Node* m_tail;
+        Node m_stub;
+    };
+
+    // Fixed capacity pool of uninitialized slots for objects of type T, any thread can allocate and free.
+    // Allocate() returns nullptr when the pool is exhausted, it's up to the caller to fall back to the heap.
+    template <typename T, uint32_t capacity>
+    class FixedPool
+    {
+    public:
+        FixedPool() : m_free(capacity)
+        {
+            m_slots = std::make_unique<Slot[]>(capacity);
+            for (uint32_t i = 0; i < capacity; i++)
+            {
+                m_free.TryPush(i);
+            }
+        }
+
+        void* Allocate()
+        {
+            uint32_t index = 0;
+            return m_free.TryPop(index) ? &m_slots[index] : nullptr;
+        }
+
+        void Free(void* slot)
+        {
+            m_free.TryPush(static_cast<uint32_t>(static_cast<Slot*>(slot) - m_slots.get()));
+        }
+
+        bool Owns(const void* slot) const
+        {
+            const Slot* begin = m_slots.get();
+            return slot >= begin && slot < begin + capacity;
+        }
+
+    private:
+        struct alignas(alignof(T)) Slot
+        {
+            unsigned char bytes[sizeof(T)];
+        };
+
+        std::unique_ptr<Slot[]> m_slots;
+        ConcurrentQueue<uint32_t> m_free; // indices of the free slots
+    };
+}
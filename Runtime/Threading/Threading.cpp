@@ -22,105 +22,854 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =========
 #include "Spartan.h"
 #include "Threading.h"
+#if defined(__linux__)
+#include <pthread.h>
+#endif
 //====================
 
 namespace Genome
 {
+    // Index of the worker the calling thread is, or -1 for any other thread
+    static thread_local int32_t worker_index = -1;
+    // Lane of the task the calling thread is executing
+    static thread_local Task_Lane lane_current = Task_Lane::Normal;
+    // Number of tasks the calling thread is executing (more than one when it helps out from within a task)
+    static thread_local uint32_t task_depth = 0;
+    // True for the I/O threads
+    static thread_local bool is_io_thread = false;
+    // Index of the stats counters of the calling thread, or -1 for threads outside of the pool
+    static thread_local int32_t counters_index = -1;
+
+    static uint64_t GetTimeNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
     Threading::Threading(Context* context) : ISubsystem(context)
     {
         m_stopping                                  = false;
         m_thread_count_support                      = std::thread::hardware_concurrency();
-        m_thread_count                              = m_thread_count_support - 1; // exclude the main (this) thread
         m_thread_names[std::this_thread::get_id()]  = "main";
 
-        for (uint32_t i = 0; i < m_thread_count; i++)
-        {
-            m_threads.emplace_back(std::thread(&Threading::ThreadLoop, this));
-            m_thread_names[m_threads.back().get_id()] = "worker_" + std::to_string(i);
-        }
+        // Exclude the main (this) thread, and keep a worker free of Background tasks for per-frame work
+        const uint32_t thread_count = m_thread_count_support > 1 ? m_thread_count_support - 1 : 0;
+        m_thread_count_background   = thread_count > 1 ? thread_count - 1 : thread_count;
 
-        LOG_INFO("%d threads have been created", m_thread_count);
+        StartThreads(thread_count, 2);
     }
 
     Threading::~Threading()
     {
         Flush(true);
+        StopThreads();
+    }
+
+    void Threading::GetThreadStats(std::vector<ThreadStats>& stats) const
+    {
+        const uint32_t count    = GetThreadCount();
+        const uint32_t count_io = GetThreadCountIo();
+        const uint64_t time_now = GetTimeNs();
+
+        stats.resize(m_thread_counters.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_thread_counters.size()); i++)
+        {
+            const ThreadCounters& counters = *m_thread_counters[i];
 
-        // Put unique lock on task mutex.
-        std::unique_lock<std::mutex> lock(m_mutex_tasks);
+            ThreadStats& thread_stats   = stats[i];
+            thread_stats.name           = i < count ? "worker_" + std::to_string(i) : i < count + count_io ? "io_" + std::to_string(i - count) : "other";
+            thread_stats.time_busy_ns   = counters.time_busy_ns.load(std::memory_order_relaxed);
+            thread_stats.time_asleep_ns = counters.time_asleep_ns.load(std::memory_order_relaxed);
 
-        // Set termination flag to true.
-        m_stopping = true;
+            // Include the sleep which is still going on, or threads which sleep through a whole interval would look busy looking for work
+            const uint64_t time_asleep_since = counters.time_asleep_since.load(std::memory_order_relaxed);
+            if (time_asleep_since != 0 && time_now > time_asleep_since)
+            {
+                thread_stats.time_asleep_ns += time_now - time_asleep_since;
+            }
+            thread_stats.tasks_executed = counters.tasks_executed.load(std::memory_order_relaxed);
+            thread_stats.tasks_stolen   = counters.tasks_stolen.load(std::memory_order_relaxed);
+            thread_stats.sleeps         = counters.sleeps.load(std::memory_order_relaxed);
+        }
+    }
+
+    QueueLatencyHistogram Threading::GetQueueLatency(const Task_Lane lane) const
+    {
+        QueueLatencyHistogram histogram = {};
+
+        for (const std::unique_ptr<ThreadCounters>& counters : m_thread_counters)
+        {
+            for (uint32_t i = 0; i < queue_latency_bucket_count; i++)
+            {
+                histogram[i] += counters->queue_latency[static_cast<uint32_t>(lane)][i].load(std::memory_order_relaxed);
+            }
+        }
+
+        return histogram;
+    }
+
+    uint32_t Threading::GetQueueDepthPeak(const Task_Lane lane, const bool reset)
+    {
+        std::atomic<uint32_t>& peak = m_queue_depth_peak[static_cast<uint32_t>(lane)];
+        return reset ? peak.exchange(0, std::memory_order_relaxed) : peak.load(std::memory_order_relaxed);
+    }
+
+    Threading::ThreadCounters& Threading::GetThreadCounters()
+    {
+        return *m_thread_counters[counters_index != -1 ? counters_index : m_thread_counters.size() - 1];
+    }
+
+    void Threading::SleepBegin(ThreadCounters& counters)
+    {
+        if (m_stats_enabled.load(std::memory_order_relaxed))
+        {
+            counters.time_asleep_since.store(GetTimeNs(), std::memory_order_relaxed);
+        }
+    }
 
-        // Unlock the mutex
-        lock.unlock();
+    void Threading::SleepEnd(ThreadCounters& counters)
+    {
+        counters.sleeps.fetch_add(1, std::memory_order_relaxed);
+
+        const uint64_t time_sleep = counters.time_asleep_since.load(std::memory_order_relaxed);
+        if (time_sleep != 0)
+        {
+            counters.time_asleep_ns.fetch_add(GetTimeNs() - time_sleep, std::memory_order_relaxed);
+            counters.time_asleep_since.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void Threading::SetThreadCount(uint32_t count, const uint32_t count_io)
+    {
+        count = (std::min)(count, m_thread_count_support > 1 ? m_thread_count_support - 1 : 0);
+
+        if (count == GetThreadCount() && count_io == GetThreadCountIo())
+            return;
+
+        StopThreads();
+        StartThreads(count, count_io);
+    }
+
+    void Threading::SetThreadAffinity(const bool enabled)
+    {
+        m_thread_affinity = enabled;
+        ApplyThreadAffinity();
+    }
+
+    Task_Lane Threading::GetLaneCurrent()
+    {
+        return lane_current;
+    }
+
+    void Threading::StartThreads(const uint32_t count, const uint32_t count_io)
+    {
+        m_stopping = false;
+
+        // Create the queues before any thread starts, so that workers can steal from each other right away
+        for (uint32_t i = 0; i < count; i++)
+        {
+            m_queues.emplace_back(std::make_unique<WorkerQueues>());
+        }
+
+        // Same for the stats, the last counters are shared by the threads outside of the pool
+        m_thread_counters.clear();
+        for (uint32_t i = 0; i < count + count_io + 1; i++)
+        {
+            m_thread_counters.emplace_back(std::make_unique<ThreadCounters>());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex_thread_names);
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                m_threads.emplace_back(std::thread(&Threading::ThreadLoop, this, i));
+                m_thread_names[m_threads.back().get_id()] = "worker_" + std::to_string(i);
+            }
+
+            for (uint32_t i = 0; i < count_io; i++)
+            {
+                m_threads_io.emplace_back(std::thread(&Threading::ThreadLoopIo, this, count + i));
+                m_thread_names[m_threads_io.back().get_id()] = "io_" + std::to_string(i);
+            }
+        }
+
+        m_thread_count      = count;
+        m_thread_count_io   = count_io;
+
+        ApplyThreadAffinity();
+
+        LOG_INFO("%d worker and %d I/O threads have been created", count, count_io);
+    }
+
+    void Threading::StopThreads()
+    {
+        // Set termination flag to true.
+        {
+            std::lock_guard<std::mutex> lock_sleep(m_mutex_sleep);
+            std::lock_guard<std::mutex> lock_sleep_io(m_mutex_sleep_io);
+            m_stopping = true;
+        }
 
         // Wake up all threads.
         m_condition_var.notify_all();
+        m_condition_var_io.notify_all();
 
         // Join all threads.
-        for (auto& thread : m_threads)
         {
-            thread.join();
+            std::lock_guard<std::mutex> lock(m_mutex_thread_names);
+
+            for (std::thread& thread : m_threads)
+            {
+                m_thread_names.erase(thread.get_id());
+                thread.join();
+            }
+
+            for (std::thread& thread : m_threads_io)
+            {
+                m_thread_names.erase(thread.get_id());
+                thread.join();
+            }
+        }
+
+        m_thread_count      = 0;
+        m_thread_count_io   = 0;
+
+        // Hand whatever is left in the workers' queues to the shared queues, so that the next workers pick it up
+        for (const std::unique_ptr<WorkerQueues>& queues : m_queues)
+        {
+            for (uint32_t lane = 0; lane < lane_count_cpu; lane++)
+            {
+                Task* task = nullptr;
+                while (queues->lanes[lane].Steal(task))
+                {
+                    if (!m_queue_shared[lane].TryPush(task))
+                    {
+                        m_tasks_queued[lane].fetch_sub(1, std::memory_order_relaxed);
+                        ExecuteTask(task);
+                    }
+                }
+            }
         }
 
         // Empty worker threads.
         m_threads.clear();
+        m_threads_io.clear();
+        m_queues.clear();
+    }
+
+    void Threading::ApplyThreadAffinity()
+    {
+#if defined(__linux__)
+        // The main thread usually runs on the first core, so the workers start from the second
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_threads.size()); i++)
+        {
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+
+            if (m_thread_affinity)
+            {
+                CPU_SET((i + 1) % m_thread_count_support, &cpu_set);
+            }
+            else
+            {
+                for (uint32_t cpu = 0; cpu < m_thread_count_support; cpu++)
+                {
+                    CPU_SET(cpu, &cpu_set);
+                }
+            }
+
+            if (pthread_setaffinity_np(m_threads[i].native_handle(), sizeof(cpu_set_t), &cpu_set) != 0)
+            {
+                LOG_WARNING("Failed to set the affinity of worker %d", i);
+            }
+        }
+#endif
+    }
+
+    void Threading::Wait(const TaskCounter& counter)
+    {
+        // Number of failed attempts to find work before blocking
+        const uint32_t spin_count = 64;
+
+        uint32_t spins = 0;
+        while (!counter.IsDone())
+        {
+            // Help out
+            if (Task* task = AcquireTask())
+            {
+                ExecuteTask(task);
+                spins = 0;
+                continue;
+            }
+
+            if (++spins < spin_count)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // What we wait for might depend on a condition which the main thread polls, and this might be the main thread
+            const bool signals_pending = PollSignals();
+
+            // Nothing left to help with, the remaining tasks are executing elsewhere (or in lanes this thread doesn't serve),
+            // so block until they are done, or until new tasks arrive, in which case we go back to helping. Conditions which
+            // are still pending are polled again shortly.
+            ThreadCounters& counters = GetThreadCounters();
+            SleepBegin(counters);
+            {
+                std::unique_lock<std::mutex> lock(m_mutex_wait);
+                m_threads_waiting.fetch_add(1, std::memory_order_seq_cst);
+                const auto is_awake = [this, &counter] { return counter.IsDone() || HasTasksToHelpWith(); };
+                if (signals_pending)
+                {
+                    m_condition_var_wait.wait_for(lock, std::chrono::milliseconds(1), is_awake);
+                }
+                else
+                {
+                    m_condition_var_wait.wait(lock, is_awake);
+                }
+                m_threads_waiting.fetch_sub(1, std::memory_order_relaxed);
+            }
+            SleepEnd(counters);
+            spins = 0;
+        }
+    }
+
+    void Threading::Tick(float delta_time)
+    {
+        PollSignals();
+    }
+
+    bool Threading::PollSignals()
+    {
+        // Poll without holding the lock, as completing a future runs its continuations, which might add conditions of their own
+        std::vector<std::pair<std::function<bool()>, Promise<void>>> signals;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex_signals);
+            if (m_signals.empty())
+                return false;
+
+            signals.swap(m_signals);
+        }
+
+        std::vector<Promise<void>> signaled;
+        for (auto it = signals.begin(); it != signals.end();)
+        {
+            if (it->first())
+            {
+                signaled.emplace_back(std::move(it->second));
+                it = signals.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+
+        // Put back the ones which are still pending
+        const bool pending = !signals.empty();
+        if (pending)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex_signals);
+            m_signals.insert(m_signals.end(), std::make_move_iterator(signals.begin()), std::make_move_iterator(signals.end()));
+        }
+
+        for (const Promise<void>& promise : signaled)
+        {
+            promise.SetValue();
+        }
+
+        return pending;
+    }
+
+    Future<void> Threading::WhenSignaled(std::function<bool()>&& is_signaled)
+    {
+        Promise<void> promise(this);
+        Future<void> future = promise.GetFuture();
+
+        if (is_signaled())
+        {
+            promise.SetValue();
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_mutex_signals);
+            m_signals.emplace_back(std::move(is_signaled), std::move(promise));
+        }
+
+        return future;
+    }
+
+    void Threading::Signal(TaskCounter& counter)
+    {
+        if (counter.Decrement())
+        {
+            WakeUpWaiting();
+        }
+    }
+
+    Future<void> Threading::WhenAll(const std::vector<FutureStateBase*>& states)
+    {
+        auto state = std::make_shared<FutureState<void>>(this);
+
+        if (states.empty())
+        {
+            state->Complete();
+            return Future<void>(state);
+        }
+
+        // The last future to complete, completes the combined one
+        auto remaining = std::make_shared<std::atomic<uint32_t>>(static_cast<uint32_t>(states.size()));
+        for (FutureStateBase* state_other : states)
+        {
+            state_other->AddContinuation([state, remaining]()
+            {
+                if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    state->Complete();
+                }
+            });
+        }
+
+        return Future<void>(state);
+    }
+
+    const std::string& Threading::GetThreadName(const std::thread::id id /*= std::this_thread::get_id()*/) const
+    {
+        static const std::string unknown = "unknown";
+
+        std::lock_guard<std::mutex> lock(m_mutex_thread_names);
+        auto it = m_thread_names.find(id);
+        return it != m_thread_names.end() ? it->second : unknown;
     }
 
     uint32_t Threading::GetThreadsAvailable() const
     {
-        uint32_t available_threads = m_thread_count;
+        const uint32_t thread_count = GetThreadCount();
+        const uint32_t threads_busy = m_threads_busy.load(std::memory_order_relaxed);
+        return threads_busy < thread_count ? thread_count - threads_busy : 0;
+    }
 
-        for (const auto& task : m_tasks)
+    uint32_t Threading::GetTasksQueued() const
+    {
+        uint32_t count = 0;
+        for (const std::atomic<uint32_t>& tasks_queued : m_tasks_queued)
         {
-            available_threads -= task->IsExecuting() ? 1 : 0;
+            count += tasks_queued.load(std::memory_order_relaxed);
         }
 
-        return available_threads;
+        return count;
     }
 
+
     void Threading::Flush(bool remove_queued /*= false*/)
     {
         // Clear any queued tasks
         if (remove_queued)
         {
-            m_tasks.clear();
+            for (uint32_t lane = 0; lane < lane_count; lane++)
+            {
+                Task* task = nullptr;
+                while (m_queue_shared[lane].TryPop(task) || [this, &task, lane]()
+                {
+                    if (lane < lane_count_cpu)
+                    {
+                        for (auto& queues : m_queues)
+                        {
+                            if (queues->lanes[lane].Steal(task))
+                                return true;
+                        }
+                    }
+                    return false;
+                }())
+                {
+                    m_tasks_queued[lane].fetch_sub(1, std::memory_order_relaxed);
+
+                    // Release anyone waiting on it
+                    if (TaskCounter* counter = task->GetCounter())
+                    {
+                        if (counter->Decrement())
+                        {
+                            WakeUpWaiting();
+                        }
+                    }
+
+                    ReleaseTask(task);
+                }
+            }
+        }
+
+        // The calling thread might be executing a task, in which case it's busy running this very function
+        const uint32_t threads_busy_self = task_depth;
+
+        // Wait for queued and executing tasks, helping out with the former
+        while (GetTasksQueued() != 0 || m_threads_busy.load(std::memory_order_acquire) > threads_busy_self)
+        {
+            if (Task* task = AcquireTask())
+            {
+                ExecuteTask(task);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void Threading::Schedule(Task* task)
+    {
+        const Task_Lane lane        = task->GetLane();
+        const uint32_t lane_index   = static_cast<uint32_t>(lane);
+
+        // Keep the lane from growing without bounds by helping out (or yielding) until there is room. Tasks which add
+        // to their own lane are exempt, as they might be the only ones able to drain it (e.g. with a single I/O thread).
+        if (task_depth == 0 || lane != lane_current)
+        {
+            while (m_tasks_queued[lane_index].load(std::memory_order_relaxed) >= m_queue_depth_max[lane_index])
+            {
+                if (Task* task_other = AcquireTask())
+                {
+                    ExecuteTask(task_other);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        // Count before publishing, so the task can't be executed (and un-counted) before it's counted
+        const uint32_t queued = m_tasks_queued[lane_index].fetch_add(1, std::memory_order_seq_cst) + 1;
+
+        if (m_stats_enabled.load(std::memory_order_relaxed))
+        {
+            task->SetTimeQueued(GetTimeNs());
+
+            uint32_t peak = m_queue_depth_peak[lane_index].load(std::memory_order_relaxed);
+            while (queued > peak && !m_queue_depth_peak[lane_index].compare_exchange_weak(peak, queued, std::memory_order_relaxed));
+        }
+
+        if (worker_index != -1 && lane != Task_Lane::Io)
+        {
+            m_queues[worker_index]->lanes[lane_index].Push(task);
+        }
+        else
+        {
+            // If the shared queue is full, help drain it instead of blocking
+            while (!m_queue_shared[lane_index].TryPush(task))
+            {
+                if (Task* task_other = AcquireTask())
+                {
+                    ExecuteTask(task_other);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        WakeUp(lane);
+    }
+
+    Task* Threading::AcquireTask()
+    {
+        for (uint32_t lane = 0; lane < lane_count_cpu; lane++)
+        {
+            if (Task* task = AcquireTask(static_cast<Task_Lane>(lane)))
+                return task;
+        }
+
+        // I/O threads help with I/O tasks too, so one which waits on another I/O task can't stall the lane
+        if (is_io_thread)
+        {
+            const uint32_t lane_index = static_cast<uint32_t>(Task_Lane::Io);
+
+            Task* task = nullptr;
+            if (m_queue_shared[lane_index].TryPop(task))
+            {
+                m_tasks_queued[lane_index].fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    Task* Threading::AcquireTask(const Task_Lane lane)
+    {
+        const uint32_t lane_index = static_cast<uint32_t>(lane);
+
+        if (m_tasks_queued[lane_index].load(std::memory_order_relaxed) == 0)
+            return nullptr;
+
+        // Only workers run Background tasks, and only a limited number at once. A worker which is already
+        // running one (and is helping from within it) doesn't need another slot.
+        const bool reserve_background = lane == Task_Lane::Background && lane_current != Task_Lane::Background;
+        if (lane == Task_Lane::Background)
+        {
+            if (worker_index == -1)
+                return nullptr;
+
+            if (reserve_background)
+            {
+                uint32_t threads_background = m_threads_background.load(std::memory_order_relaxed);
+                do
+                {
+                    if (threads_background >= m_thread_count_background)
+                        return nullptr;
+                } while (!m_threads_background.compare_exchange_weak(threads_background, threads_background + 1, std::memory_order_relaxed));
+            }
+        }
+
+        Task* task = nullptr;
+        bool found = false;
+
+        // Own queue first (newest task, hot in cache)
+        if (worker_index != -1 && m_queues[worker_index]->lanes[lane_index].Pop(task))
+        {
+            found = true;
+        }
+
+        // Then the shared queue
+        if (!found && m_queue_shared[lane_index].TryPop(task))
+        {
+            found = true;
         }
 
-        // If so, wait for them
-        while (AreTasksRunning())
+        // Then steal from the other workers, starting next to us so that thieves spread out
+        if (!found)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            const uint32_t queue_count = static_cast<uint32_t>(m_queues.size());
+            const uint32_t offset      = worker_index != -1 ? static_cast<uint32_t>(worker_index) + 1 : 0;
+            for (uint32_t i = 0; i < queue_count && !found; i++)
+            {
+                const uint32_t victim = (offset + i) % queue_count;
+                if (static_cast<int32_t>(victim) == worker_index)
+                    continue;
+
+                found = m_queues[victim]->lanes[lane_index].Steal(task);
+            }
+
+            if (found)
+            {
+                GetThreadCounters().tasks_stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        if (!found)
+        {
+            if (reserve_background)
+            {
+                m_threads_background.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            return nullptr;
         }
+
+        m_tasks_queued[lane_index].fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    bool Threading::HasTasksToHelpWith() const
+    {
+        if (m_tasks_queued[static_cast<uint32_t>(Task_Lane::High)].load(std::memory_order_seq_cst) != 0 ||
+            m_tasks_queued[static_cast<uint32_t>(Task_Lane::Normal)].load(std::memory_order_seq_cst) != 0)
+            return true;
+
+        if (is_io_thread && m_tasks_queued[static_cast<uint32_t>(Task_Lane::Io)].load(std::memory_order_seq_cst) != 0)
+            return true;
+
+        if (worker_index == -1 || m_tasks_queued[static_cast<uint32_t>(Task_Lane::Background)].load(std::memory_order_seq_cst) == 0)
+            return false;
+
+        return lane_current == Task_Lane::Background || m_threads_background.load(std::memory_order_seq_cst) < m_thread_count_background;
     }
 
-    void Threading::ThreadLoop()
+    void Threading::ExecuteTask(Task* task)
     {
-        std::shared_ptr<Task> task;
-        while (true)
+        m_threads_busy.fetch_add(1, std::memory_order_relaxed);
+
+        const Task_Lane lane            = task->GetLane();
+        const Task_Lane lane_previous   = lane_current;
+        ThreadCounters& counters        = GetThreadCounters();
+
+        // Queue latency, and the start of the busy time (unless this thread is already busy with an outer task)
+        uint64_t time_start = 0;
+        if (task->GetTimeQueued() != 0 || (task_depth == 0 && m_stats_enabled.load(std::memory_order_relaxed)))
+        {
+            time_start = GetTimeNs();
+
+            if (task->GetTimeQueued() != 0)
+            {
+                const uint64_t latency_us   = (time_start - (std::min)(task->GetTimeQueued(), time_start)) / 1000;
+                uint32_t bucket             = 0;
+                while (bucket < queue_latency_bucket_count - 1 && latency_us >= (1ull << bucket))
+                {
+                    bucket++;
+                }
+                counters.queue_latency[static_cast<uint32_t>(lane)][bucket].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        lane_current = lane;
+        task_depth++;
+
+        task->Execute();
+
+        task_depth--;
+        lane_current = lane_previous;
+
+        counters.tasks_executed.fetch_add(1, std::memory_order_relaxed);
+        if (task_depth == 0 && time_start != 0)
         {
-            // Lock tasks mutex
-            std::unique_lock<std::mutex> lock(m_mutex_tasks);
+            counters.time_busy_ns.fetch_add(GetTimeNs() - time_start, std::memory_order_relaxed);
+        }
+
+        TaskCounter* counter = task->GetCounter();
+        ReleaseTask(task);
 
-            // Check condition on notification
-            m_condition_var.wait(lock, [this] { return !m_tasks.empty() || m_stopping; });
+        // Give back the Background slot this task took (see AcquireTask()), and let another worker have it
+        if (lane == Task_Lane::Background && lane_previous != Task_Lane::Background && worker_index != -1)
+        {
+            m_threads_background.fetch_sub(1, std::memory_order_seq_cst);
+            if (m_tasks_queued[static_cast<uint32_t>(Task_Lane::Background)].load(std::memory_order_seq_cst) != 0)
+            {
+                WakeUp(Task_Lane::Background);
+            }
+        }
 
-            // If m_stopping is true, it's time to shut everything down
-            if (m_stopping && m_tasks.empty())
-                return;
+        // The counter might be owned by the waiting thread, so it must not be touched after the last decrement
+        if (counter && counter->Decrement())
+        {
+            WakeUpWaiting();
+        }
 
-            // Get next task in the queue.
-            task = m_tasks.front();
+        m_threads_busy.fetch_sub(1, std::memory_order_release);
+    }
 
-            // Remove it from the queue.
-            m_tasks.pop_front();
+    void Threading::ReleaseTask(Task* task)
+    {
+        task->~Task();
 
-            // Unlock the mutex
-            lock.unlock();
+        if (m_task_pool.Owns(task))
+        {
+            m_task_pool.Free(task);
+        }
+        else
+        {
+            ::operator delete(task, std::align_val_t(alignof(Task)));
+        }
+    }
+
+    void Threading::WakeUp(const Task_Lane lane)
+    {
+        // Taking the mutex guarantees that a thread which is about to sleep either sees
+        // the new task count or is already waiting on the condition variable and gets notified.
+        if (lane == Task_Lane::Io && m_threads_sleeping_io.load(std::memory_order_seq_cst) != 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex_sleep_io);
+            }
+            m_condition_var_io.notify_one();
+        }
+        else if (lane != Task_Lane::Io && m_threads_sleeping.load(std::memory_order_seq_cst) != 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex_sleep);
+            }
+            m_condition_var.notify_one();
+        }
+        // No idle threads, but a thread blocked in Wait() can help. Not every thread can help with every lane
+        // (e.g. only I/O threads take I/O tasks), so wake them all and let them check.
+        else if (m_threads_waiting.load(std::memory_order_seq_cst) != 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex_wait);
+            }
+            m_condition_var_wait.notify_all();
+        }
+    }
+
+    void Threading::WakeUpWaiting()
+    {
+        // Same reasoning as WakeUp(), waiters re-check their counter under the mutex before blocking
+        if (m_threads_waiting.load(std::memory_order_seq_cst) != 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex_wait);
+            }
+            m_condition_var_wait.notify_all();
+        }
+    }
+
+    void Threading::ThreadLoop(const uint32_t index)
+    {
+        worker_index                = static_cast<int32_t>(index);
+        counters_index              = static_cast<int32_t>(index);
+        ThreadCounters& counters    = GetThreadCounters();
+
+        // Number of failed attempts to find work before going to sleep
+        const uint32_t spin_count = 64;
+
+        while (!m_stopping)
+        {
+            // Look for work, spin for a while before sleeping as new tasks tend to arrive in bursts
+            Task* task = nullptr;
+            for (uint32_t i = 0; i < spin_count && !task; i++)
+            {
+                task = AcquireTask();
+                if (!task)
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            if (task)
+            {
+                ExecuteTask(task);
+                continue;
+            }
+
+            // Sleep until there is work or it's time to shut down
+            SleepBegin(counters);
+            {
+                std::unique_lock<std::mutex> lock(m_mutex_sleep);
+                m_threads_sleeping.fetch_add(1, std::memory_order_seq_cst);
+                m_condition_var.wait(lock, [this] { return HasTasksToHelpWith() || m_stopping; });
+                m_threads_sleeping.fetch_sub(1, std::memory_order_relaxed);
+            }
+            SleepEnd(counters);
+        }
+    }
+
+    void Threading::ThreadLoopIo(const uint32_t index)
+    {
+        is_io_thread    = true;
+        counters_index  = static_cast<int32_t>(index);
+
+        const uint32_t lane_index   = static_cast<uint32_t>(Task_Lane::Io);
+        ThreadCounters& counters    = GetThreadCounters();
+
+        while (!m_stopping)
+        {
+            Task* task = nullptr;
+            if (m_queue_shared[lane_index].TryPop(task))
+            {
+                m_tasks_queued[lane_index].fetch_sub(1, std::memory_order_relaxed);
+                ExecuteTask(task);
+                continue;
+            }
 
-            // Execute the task.
-            task->Execute();
+            // I/O tasks are few and long, so there is no point in spinning
+            SleepBegin(counters);
+            {
+                std::unique_lock<std::mutex> lock(m_mutex_sleep_io);
+                m_threads_sleeping_io.fetch_add(1, std::memory_order_seq_cst);
+                m_condition_var_io.wait(lock, [this, lane_index] { return m_tasks_queued[lane_index].load(std::memory_order_seq_cst) != 0 || m_stopping; });
+                m_threads_sleeping_io.fetch_sub(1, std::memory_order_relaxed);
+            }
+            SleepEnd(counters);
         }
     }
 }
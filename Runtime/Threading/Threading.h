@@ -25,27 +25,270 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include <thread>
 #include <mutex>
-#include <deque>
+#include <atomic>
+#include <condition_variable>
 #include <unordered_map>
 #include <functional>
+#include <optional>
+#include <type_traits>
+#include <new>
+#include <cstddef>
+#include <array>
+#include "TaskQueue.h"
 #include "../Logging/Log.h"
 #include "../Core/ISubsystem.h"
 //=============================
 
 namespace Genome
 {
-    class Task
+    // Lanes decide which threads run a task and in what order. CPU workers prefer High over Normal over Background,
+    // and only a limited number of them run Background tasks at once, so long jobs can't starve per-frame work.
+    // Io tasks run on their own threads, which oversubscribe the cores since they mostly block.
+    enum class Task_Lane : uint8_t
+    {
+        High,       // latency sensitive per-frame work, e.g. subsystem ticks
+        Normal,
+        Background, // long running work, e.g. shader compilation, terrain generation
+        Io,         // blocking I/O, e.g. loading files
+        Count
+    };
+
+    // A counter which tasks decrement when they complete, can be waited on via Threading::Wait()
+    class TaskCounter
+    {
+    public:
+        TaskCounter() = default;
+        TaskCounter(const TaskCounter&) = delete;
+        TaskCounter& operator=(const TaskCounter&) = delete;
+
+        void Increment(const uint32_t count = 1) { m_count.fetch_add(count, std::memory_order_relaxed); }
+        bool Decrement()                         { return m_count.fetch_sub(1, std::memory_order_seq_cst) == 1; } // returns true when it reaches zero
+        bool IsDone()                      const { return m_count.load(std::memory_order_seq_cst) == 0; }
+        uint32_t GetCount()                const { return m_count.load(std::memory_order_acquire); }
+
+    private:
+        std::atomic<uint32_t> m_count = 0;
+    };
+
+    // A type erased task which stores small closures inline, larger ones spill to the heap.
+    // Cache line aligned so that tasks handed to different workers don't share lines.
+    class alignas(64) Task
+    {
+    public:
+        static constexpr size_t storage_size = 64;
+
+        template <typename Function>
+        Task(Function&& function, TaskCounter* counter, Task_Lane lane)
+        {
+            typedef std::decay_t<Function> function_type;
+
+            if constexpr (sizeof(function_type) <= storage_size && alignof(function_type) <= alignof(std::max_align_t))
+            {
+                new (m_storage) function_type(std::forward<Function>(function));
+                m_execute = [](void* storage) { (*static_cast<function_type*>(storage))(); };
+                m_destroy = [](void* storage) { static_cast<function_type*>(storage)->~function_type(); };
+            }
+            else
+            {
+                *reinterpret_cast<function_type**>(m_storage) = new function_type(std::forward<Function>(function));
+                m_execute = [](void* storage) { (**static_cast<function_type**>(storage))(); };
+                m_destroy = [](void* storage) { delete *static_cast<function_type**>(storage); };
+                m_is_spilled = true;
+            }
+
+            m_counter   = counter;
+            m_lane      = lane;
+        }
+
+        ~Task() { m_destroy(m_storage); }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        void Execute()                  { m_execute(m_storage); }
+        TaskCounter* GetCounter() const { return m_counter; }
+        bool IsSpilled()          const { return m_is_spilled; }
+        Task_Lane GetLane()       const { return m_lane; }
+        uint64_t GetTimeQueued()  const { return m_time_queued_ns; }
+        void SetTimeQueued(const uint64_t time_ns) { m_time_queued_ns = time_ns; }
+
+    private:
+        alignas(std::max_align_t) unsigned char m_storage[storage_size];
+        void (*m_execute)(void*)    = nullptr;
+        void (*m_destroy)(void*)    = nullptr;
+        TaskCounter* m_counter      = nullptr;
+        uint64_t m_time_queued_ns   = 0; // only set while stats are enabled
+        Task_Lane m_lane            = Task_Lane::Normal;
+        bool m_is_spilled           = false;
+    };
+
+    class Threading;
+
+    // State shared between a task and the futures which refer to it
+    class FutureStateBase
+    {
+    public:
+        FutureStateBase(Threading* threading) : m_threading(threading) { m_counter.Increment(); }
+        virtual ~FutureStateBase() = default;
+
+        // Runs the continuation once the state completes, or immediately if it already has
+        void AddContinuation(std::function<void()>&& continuation)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_completed)
+                {
+                    m_continuations.emplace_back(std::move(continuation));
+                    return;
+                }
+            }
+
+            continuation();
+        }
+
+        // Releases waiting threads and runs the continuations
+        void Complete();
+
+        bool IsReady()                      const { return m_counter.IsDone(); }
+        Threading* GetThreading()           const { return m_threading; }
+        const TaskCounter& GetCounter()     const { return m_counter; }
+
+    private:
+        Threading* m_threading = nullptr;
+        TaskCounter m_counter;
+        std::mutex m_mutex;
+        std::vector<std::function<void()>> m_continuations;
+        bool m_completed = false;
+    };
+
+    template <typename T>
+    class FutureState : public FutureStateBase
     {
     public:
-        typedef std::function<void()> function_type;
+        using FutureStateBase::FutureStateBase;
 
-        Task(function_type&& function)  { m_function = std::forward<function_type>(function); }
-        void Execute()                  { m_is_executing = true; m_function(); m_is_executing = false; }
-        bool IsExecuting()        const { return m_is_executing; }
+        template <typename Function, typename... Args>
+        void Run(Function& function, Args&... args)
+        {
+            m_value.emplace(function(args...));
+            Complete();
+        }
+
+        template <typename... Args>
+        void SetValue(Args&&... args)
+        {
+            m_value.emplace(std::forward<Args>(args)...);
+            Complete();
+        }
+
+        const T& GetValue() const { return *m_value; }
 
     private:
-        bool m_is_executing = false;
-        function_type m_function;
+        std::optional<T> m_value;
+    };
+
+    template <>
+    class FutureState<void> : public FutureStateBase
+    {
+    public:
+        using FutureStateBase::FutureStateBase;
+
+        template <typename Function, typename... Args>
+        void Run(Function& function, Args&... args)
+        {
+            function(args...);
+            Complete();
+        }
+
+        void SetValue() { Complete(); }
+    };
+
+    template <typename T>
+    class Future;
+
+    // The type of the value a future holds, a continuation which returns a future is unwrapped to the value of that future
+    template <typename T>
+    struct future_value { typedef T type; };
+    template <typename T>
+    struct future_value<Future<T>> { typedef T type; };
+
+    // The type a continuation returns when it's given the value of a Future<T>
+    template <typename T, typename Function>
+    struct continuation_result { typedef std::decay_t<std::invoke_result_t<Function&, const T&>> type; };
+    template <typename Function>
+    struct continuation_result<void, Function> { typedef std::decay_t<std::invoke_result_t<Function&>> type; };
+    // The future Then() returns
+    template <typename T, typename Function>
+    struct continuation_future { typedef Future<typename future_value<typename continuation_result<T, Function>::type>::type> type; };
+
+    // A handle to the result of a task, returned by Threading::AddTask()
+    template <typename T>
+    class Future
+    {
+    public:
+        Future() = default;
+        Future(std::shared_ptr<FutureState<T>> state) : m_state(std::move(state)) {}
+
+        // Returns false for default constructed futures
+        bool IsValid() const { return m_state != nullptr; }
+        // Returns true once the task has completed
+        bool IsReady() const { return m_state && m_state->IsReady(); }
+        // Blocks until the task has completed, the calling thread executes other tasks while waiting
+        void Wait() const;
+
+        // Waits and returns the value the task produced
+        template <typename U = T>
+        std::enable_if_t<!std::is_void_v<U>, const U&> Get() const
+        {
+            Wait();
+            return m_state->GetValue();
+        }
+
+        // Schedules a function which receives the value of this future (if any) as soon as it's ready, returns its future.
+        // If the function returns a future itself, the returned future completes once that one does, so asynchronous
+        // steps can be chained without blocking a thread in between. An invalid one completes it with a default value.
+        // Must be called on a valid future.
+        template <typename Function>
+        typename continuation_future<T, std::decay_t<Function>>::type Then(Function&& function, Task_Lane lane = Task_Lane::Normal) const;
+
+    private:
+        friend class Threading;
+        template <typename U>
+        friend class Future;
+        std::shared_ptr<FutureState<T>> m_state;
+    };
+
+    // A future which isn't completed by a task but by whoever holds the promise, e.g. a callback or a polled condition
+    template <typename T>
+    class Promise
+    {
+    public:
+        Promise(Threading* threading) : m_state(std::make_shared<FutureState<T>>(threading)) {}
+
+        Future<T> GetFuture() const { return Future<T>(m_state); }
+
+        // Completes the future, must be called exactly once
+        template <typename... Args>
+        void SetValue(Args&&... args) const { m_state->SetValue(std::forward<Args>(args)...); }
+
+    private:
+        std::shared_ptr<FutureState<T>> m_state;
+    };
+
+    // How long tasks waited in a queue before a thread picked them up. Bucket i counts the tasks which waited
+    // less than 2^i microseconds, the last bucket counts the rest.
+    static constexpr uint32_t queue_latency_bucket_count = 16;
+    typedef std::array<uint64_t, queue_latency_bucket_count> QueueLatencyHistogram;
+
+    // Statistics of a pool thread, cumulative since the pool was (re)started. Times are only measured while stats are enabled.
+    struct ThreadStats
+    {
+        std::string name;
+        uint64_t time_busy_ns   = 0; // executing tasks, including the time tasks spend waiting on other tasks
+        uint64_t time_asleep_ns = 0; // blocked, waiting for tasks (or for a counter)
+        uint64_t tasks_executed = 0;
+        uint64_t tasks_stolen   = 0; // taken from the queue of another worker
+        uint64_t sleeps         = 0;
     };
 
     class Threading : public ISubsystem
@@ -54,88 +297,383 @@ namespace Genome
         Threading(Context* context);
         ~Threading();
 
-        // Add a task
+        //= ISubsystem ===================================================================
+        void Tick(float delta_time) override;
+        TickDependencies GetTickDependencies() const override { return { 0, 0, true }; }
+        //================================================================================
+
+        // Add a task, returns a future which can be waited on, chained with Then() or combined with WhenAll()
         template <typename Function>
-        void AddTask(Function&& function)
+        Future<std::decay_t<std::invoke_result_t<std::decay_t<Function>&>>> AddTask(Function&& function, Task_Lane lane = Task_Lane::Normal)
         {
-            if (m_threads.empty())
+            typedef std::decay_t<std::invoke_result_t<std::decay_t<Function>&>> result_type;
+
+            auto state = std::make_shared<FutureState<result_type>>(this);
+            AddTask([state, function = std::forward<Function>(function)]() mutable
+            {
+                state->Run(function);
+            }, nullptr, lane);
+
+            return Future<result_type>(state);
+        }
+
+        // Add a task without a future, if a counter is provided it will be decremented once the task completes
+        template <typename Function>
+        void AddTask(Function&& function, TaskCounter* counter, Task_Lane lane = Task_Lane::Normal)
+        {
+            if (counter)
+            {
+                counter->Increment();
+            }
+
+            if ((lane == Task_Lane::Io ? m_thread_count_io : m_thread_count).load(std::memory_order_relaxed) == 0)
             {
                 LOG_WARNING("No available threads, function will execute in the same thread");
                 function();
+                if (counter)
+                {
+                    counter->Decrement();
+                }
                 return;
             }
 
-            // Lock tasks mutex
-            std::unique_lock<std::mutex> lock(m_mutex_tasks);
+            Schedule(CreateTask(std::forward<Function>(function), counter, lane));
+        }
 
-            // Save the task
-            m_tasks.push_back(std::make_shared<Task>(std::bind(std::forward<Function>(function))));
+        // Splits [begin, end) into chunks of (at least) grain iterations and executes them in parallel as function(chunk_begin, chunk_end).
+        // Chunks are handed out dynamically, so uneven work balances itself, and the calling thread works on them too.
+        // A grain of 0 picks one which gives every thread a few chunks. The helpers run in the lane of the calling task.
+        template <typename Function>
+        void ParallelFor(const uint32_t begin, const uint32_t end, uint32_t grain, Function&& function)
+        {
+            if (begin >= end)
+                return;
 
-            // Unlock the mutex
-            lock.unlock();
+            const uint32_t range = end - begin;
+            if (grain == 0)
+            {
+                grain = range / ((GetThreadCount() + 1) * 4);
+                grain = grain != 0 ? grain : 1;
+            }
 
-            // Wake up a thread
-            m_condition_var.notify_one();
+            // Everything lives on this stack frame, that's safe since we don't return before all helpers are done
+            std::atomic<uint64_t> cursor = begin; // 64-bit so that overshooting end can't wrap around
+            auto process_chunks = [&cursor, &function, end, grain]()
+            {
+                while (true)
+                {
+                    const uint64_t chunk_begin = cursor.fetch_add(grain, std::memory_order_relaxed);
+                    if (chunk_begin >= end)
+                        return;
+
+                    const uint64_t chunk_end = chunk_begin + grain;
+                    function(static_cast<uint32_t>(chunk_begin), chunk_end < end ? static_cast<uint32_t>(chunk_end) : end);
+                }
+            };
+
+            // One helper per chunk (minus the one the calling thread takes), up to the number of workers
+            const uint32_t chunk_count  = (range + grain - 1) / grain;
+            const uint32_t helper_count = (std::min)(chunk_count - 1, GetThreadCount());
+            const Task_Lane lane        = GetLaneCurrent() == Task_Lane::Io ? Task_Lane::Normal : GetLaneCurrent();
+            TaskCounter counter;
+            for (uint32_t i = 0; i < helper_count; i++)
+            {
+                AddTask(process_chunks, &counter, lane);
+            }
+
+            // Work on chunks in this thread as well
+            process_chunks();
+
+            // Helpers which haven't started yet will find no chunks left, so this returns as soon as the last chunk is done
+            Wait(counter);
         }
 
         // Adds a task which is a loop and executes chunks of it in parallel
         template <typename Function>
         void AddTaskLoop(Function&& function, uint32_t range)
         {
-            uint32_t available_threads    = GetThreadsAvailable();
-            std::vector<bool> tasks_done  = std::vector<bool>(available_threads, false);
-            const uint32_t task_count     = available_threads + 1; // plus one for the current thread
+            ParallelFor(0, range, 0, std::forward<Function>(function));
+        }
 
-            uint32_t start  = 0;
-            uint32_t end    = 0;
-            for (uint32_t i = 0; i < available_threads; i++)
+        // Returns a future which completes once all of the given futures have completed
+        template <typename T>
+        Future<void> WhenAll(const std::vector<Future<T>>& futures)
+        {
+            std::vector<FutureStateBase*> states;
+            states.reserve(futures.size());
+            for (const Future<T>& future : futures)
             {
-                start  = (range / task_count) * i;
-                end    = start + (range / task_count);
-
-                // Kick off task
-                AddTask([&function, &tasks_done, i, start, end] { function(start, end); tasks_done[i] = true; });
+                states.emplace_back(future.m_state.get());
             }
 
-            // Do last task in the current thread
-            function(end, range);
-
-            // Wait till the threads are done
-            uint32_t tasks = 0;
-            while (tasks != tasks_done.size())
-            {
-                tasks = 0;
-                for (const bool job_done : tasks_done)
-                {
-                    tasks += job_done ? 1 : 0;
-                }
+            return WhenAll(states);
+        }
 
-                std::this_thread::sleep_for(std::chrono::milliseconds(16));
-            }
+        template <typename... T>
+        Future<void> WhenAll(const Future<T>&... futures)
+        {
+            return WhenAll(std::vector<FutureStateBase*>{ futures.m_state.get()... });
         }
 
-        // Get the number of threads used
-        uint32_t GetThreadCount()           const { return m_thread_count; }
+        // Returns a future which completes once is_signaled returns true, e.g. for a GPU fence: [fence]() { return fence->IsSignaled(); }.
+        // The condition is polled once per tick on the main thread, so nothing blocks while waiting for it. Threads which block
+        // in Wait() poll it as well, so waiting on a future which depends on it completes even if the main thread is the one waiting.
+        Future<void> WhenSignaled(std::function<bool()>&& is_signaled);
+
+        // Blocks until the counter reaches zero, the calling thread executes queued tasks while waiting and sleeps when there are none
+        void Wait(const TaskCounter& counter);
+
+        // Decrements a counter which isn't tied to a task and wakes up the threads waiting on it once it reaches zero
+        void Signal(TaskCounter& counter);
+
+        // Recreates the workers, count excludes the main thread. Tasks which are queued are kept, call from the main thread.
+        void SetThreadCount(uint32_t count, uint32_t count_io);
+        // Limits how many workers can run Background tasks at the same time
+        void SetThreadCountBackground(const uint32_t count) { m_thread_count_background = count; }
+        // Limits how many tasks can be queued in a lane, threads adding to a full lane help out (or yield) until there is room
+        void SetQueueDepthMax(const Task_Lane lane, const uint32_t depth) { m_queue_depth_max[static_cast<uint32_t>(lane)] = depth; }
+        // Pins each worker to a core (Linux only)
+        void SetThreadAffinity(bool enabled);
+
+        // Get the number of worker threads used
+        uint32_t GetThreadCount()           const { return m_thread_count.load(std::memory_order_relaxed); }
+        // Get the number of I/O threads used
+        uint32_t GetThreadCountIo()         const { return m_thread_count_io.load(std::memory_order_relaxed); }
+        // Get how many workers can run Background tasks at the same time
+        uint32_t GetThreadCountBackground() const { return m_thread_count_background; }
+        uint32_t GetQueueDepthMax(const Task_Lane lane) const { return m_queue_depth_max[static_cast<uint32_t>(lane)]; }
+        bool GetThreadAffinity()            const { return m_thread_affinity; }
+        // Get the lane of the task the calling thread is executing (Normal if it's not executing one)
+        static Task_Lane GetLaneCurrent();
         // Get the maximum number of threads the hardware supports
         uint32_t GetThreadCountSupport()    const { return m_thread_count_support; }
+        // Get the name of a thread, e.g. "main" or "worker_3"
+        const std::string& GetThreadName(std::thread::id id = std::this_thread::get_id()) const;
         // Get the number of threads which are not doing any work
         uint32_t GetThreadsAvailable()      const;
+        // Get the number of tasks which are queued but not yet executing
+        uint32_t GetTasksQueued()           const;
+        uint32_t GetTasksQueued(const Task_Lane lane) const { return m_tasks_queued[static_cast<uint32_t>(lane)].load(std::memory_order_relaxed); }
         // Returns true if at least one task is running
         bool AreTasksRunning()              const { return GetThreadsAvailable() != GetThreadCount(); }
         // Waits for all executing (and queued if requested) tasks to finish
         void Flush(bool remove_queued = false);
+        // Get the number of tasks which didn't fit in the task pool or in a task's inline storage and had to be heap allocated
+        uint64_t GetTasksSpilled()          const { return m_tasks_spilled.load(std::memory_order_relaxed); }
+
+        //= STATS ========================================================================================================
+        // Timing tasks and queues costs a few clock reads per task, so it's off unless someone is looking (e.g. the profiler)
+        void SetStatsEnabled(const bool enabled)    { m_stats_enabled.store(enabled, std::memory_order_relaxed); }
+        bool GetStatsEnabled()                const { return m_stats_enabled.load(std::memory_order_relaxed); }
+        // Get the stats of the workers, then the I/O threads, then the threads outside of the pool which helped out (combined)
+        void GetThreadStats(std::vector<ThreadStats>& stats) const;
+        // Get the queue latency of the tasks of a lane, across all threads
+        QueueLatencyHistogram GetQueueLatency(Task_Lane lane) const;
+        // Get the largest number of tasks which were queued in a lane at once, reset starts tracking again from zero
+        uint32_t GetQueueDepthPeak(Task_Lane lane, bool reset);
+        //================================================================================================================
 
     private:
-        // This function is invoked by the threads
-        void ThreadLoop();
+        static constexpr uint32_t lane_count        = static_cast<uint32_t>(Task_Lane::Count);
+        static constexpr uint32_t lane_count_cpu    = static_cast<uint32_t>(Task_Lane::Io); // lanes served by the workers
+
+        // The queues a worker owns, one per CPU lane
+        struct WorkerQueues
+        {
+            WorkStealingQueue<Task*> lanes[lane_count_cpu];
+        };
 
-        uint32_t m_thread_count         = 0;
-        uint32_t m_thread_count_support = 0;
+        // Constructs a task in the task pool, or on the heap if the pool is exhausted
+        template <typename Function>
+        Task* CreateTask(Function&& function, TaskCounter* counter, const Task_Lane lane)
+        {
+            void* memory = m_task_pool.Allocate();
+            if (!memory)
+            {
+                memory = ::operator new(sizeof(Task), std::align_val_t(alignof(Task)));
+            }
+
+            Task* task = new (memory) Task(std::forward<Function>(function), counter, lane);
+
+            if (task->IsSpilled() || !m_task_pool.Owns(task))
+            {
+                m_tasks_spilled.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            return task;
+        }
+        // Destructs a task and returns its memory to wherever it came from
+        void ReleaseTask(Task* task);
+        Future<void> WhenAll(const std::vector<FutureStateBase*>& states);
+        // Creates the worker and I/O threads
+        void StartThreads(uint32_t count, uint32_t count_io);
+        // Stops all threads once they finish what they are executing, tasks left in the workers' queues are moved to the shared queues
+        void StopThreads();
+        void ApplyThreadAffinity();
+        // Pushes a task to the queue of the calling thread (or the shared queue if it's not a worker)
+        void Schedule(Task* task);
+        // Finds a CPU task, highest priority lane first
+        Task* AcquireTask();
+        // Finds a task of a CPU lane from the own queue, the shared queue or by stealing from other workers
+        Task* AcquireTask(Task_Lane lane);
+        // Returns true if any of the queued tasks can be executed by the calling thread
+        bool HasTasksToHelpWith() const;
+        // Executes a task and releases it
+        void ExecuteTask(Task* task);
+        // Wakes up a sleeping thread which serves the lane (if there is any)
+        void WakeUp(Task_Lane lane);
+        // Wakes up threads blocked in Wait()
+        void WakeUpWaiting();
+        // Completes the futures of the conditions which are signaled, returns true if any are still pending
+        bool PollSignals();
+        // These functions are invoked by the threads
+        void ThreadLoop(uint32_t index);
+        void ThreadLoopIo(uint32_t index);
+
+        // Counters of a single thread, only that thread writes to them (except for the one shared by non-pool threads)
+        struct alignas(64) ThreadCounters
+        {
+            std::atomic<uint64_t> time_busy_ns      = 0;
+            std::atomic<uint64_t> time_asleep_ns    = 0;
+            std::atomic<uint64_t> time_asleep_since = 0; // start of the current sleep, if timed
+            std::atomic<uint64_t> tasks_executed    = 0;
+            std::atomic<uint64_t> tasks_stolen      = 0;
+            std::atomic<uint64_t> sleeps            = 0;
+            std::atomic<uint64_t> queue_latency[lane_count][queue_latency_bucket_count] = {};
+        };
+        ThreadCounters& GetThreadCounters();
+        // Bracket the blocking waits of a thread, for the sleep stats
+        void SleepBegin(ThreadCounters& counters);
+        void SleepEnd(ThreadCounters& counters);
+
+        std::atomic<uint32_t> m_thread_count    = 0;
+        std::atomic<uint32_t> m_thread_count_io = 0;
+        uint32_t m_thread_count_support         = 0;
+        uint32_t m_thread_count_background      = 0;
+        uint32_t m_queue_depth_max[lane_count]  = { 4096, 4096, 1024, 256 };
+        bool m_thread_affinity                  = false;
         std::vector<std::thread> m_threads;
-        std::deque<std::shared_ptr<Task>> m_tasks;
-        std::mutex m_mutex_tasks;
+        std::vector<std::thread> m_threads_io;
+        std::vector<std::unique_ptr<WorkerQueues>> m_queues;    // one per worker
+        ConcurrentQueue<Task*> m_queue_shared[lane_count];      // for submissions from non-worker threads, and all I/O tasks
+        FixedPool<Task, 4096> m_task_pool;                      // task storage, avoids an allocation per task
+        std::atomic<uint64_t> m_tasks_spilled                   = 0;
+        std::atomic<uint32_t> m_tasks_queued[lane_count]        = {};
+        std::atomic<uint32_t> m_threads_busy                    = 0;
+        std::atomic<uint32_t> m_threads_background              = 0; // workers executing a Background task
+        std::atomic<uint32_t> m_threads_sleeping                = 0;
+        std::atomic<uint32_t> m_threads_sleeping_io             = 0;
+        std::atomic<uint32_t> m_threads_waiting                 = 0;
+        std::atomic<bool> m_stats_enabled                       = false;
+        std::atomic<uint32_t> m_queue_depth_peak[lane_count]    = {};
+        std::vector<std::unique_ptr<ThreadCounters>> m_thread_counters; // workers, I/O threads, then one for all other threads
+        std::mutex m_mutex_sleep;
         std::condition_variable m_condition_var;
+        std::mutex m_mutex_sleep_io;
+        std::condition_variable m_condition_var_io;
+        std::mutex m_mutex_wait;
+        std::condition_variable m_condition_var_wait;
+        mutable std::mutex m_mutex_thread_names;
         std::unordered_map<std::thread::id, std::string> m_thread_names;
-        bool m_stopping;
+        std::mutex m_mutex_signals;
+        std::vector<std::pair<std::function<bool()>, Promise<void>>> m_signals; // polled by Tick() and Wait()
+        std::atomic<bool> m_stopping;
     };
+
+    inline void FutureStateBase::Complete()
+    {
+        std::vector<std::function<void()>> continuations;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_completed = true;
+            continuations.swap(m_continuations);
+        }
+
+        m_threading->Signal(m_counter);
+
+        for (std::function<void()>& continuation : continuations)
+        {
+            continuation();
+        }
+    }
+
+    template <typename T>
+    void Future<T>::Wait() const
+    {
+        if (m_state)
+        {
+            m_state->GetThreading()->Wait(m_state->GetCounter());
+        }
+    }
+
+    template <typename T>
+    template <typename Function>
+    typename continuation_future<T, std::decay_t<Function>>::type Future<T>::Then(Function&& function, const Task_Lane lane /*= Task_Lane::Normal*/) const
+    {
+        typedef typename continuation_result<T, std::decay_t<Function>>::type result_type;
+        typedef typename future_value<result_type>::type value_type;
+
+        // The continuation keeps this state alive until it runs, the state drops it once it completes
+        SP_ASSERT(m_state != nullptr && "Then() was called on an invalid future");
+        std::shared_ptr<FutureState<T>> state = m_state;
+        auto state_next = std::make_shared<FutureState<value_type>>(state->GetThreading());
+        state->AddContinuation([state, state_next, function = std::forward<Function>(function), lane]() mutable
+        {
+            state->GetThreading()->AddTask([state, state_next, function]() mutable
+            {
+                if constexpr (std::is_same_v<result_type, Future<value_type>>)
+                {
+                    // Forward the value of the returned future once it's ready
+                    Future<value_type> future;
+                    if constexpr (std::is_void_v<T>)
+                    {
+                        future = function();
+                    }
+                    else
+                    {
+                        future = function(state->GetValue());
+                    }
+
+                    // Nothing to wait for (e.g. a step which had nothing to do), so there is no value to forward either
+                    std::shared_ptr<FutureState<value_type>> state_inner = future.m_state;
+                    if (!state_inner)
+                    {
+                        if constexpr (std::is_void_v<value_type> || std::is_default_constructible_v<value_type>)
+                        {
+                            state_next->SetValue();
+                        }
+                        else
+                        {
+                            LOG_ERROR("The continuation returned an invalid future and its value can't be default constructed, the future won't complete");
+                            SP_ASSERT(false && "The continuation returned an invalid future");
+                        }
+                        return;
+                    }
+
+                    state_inner->AddContinuation([state_inner, state_next]()
+                    {
+                        if constexpr (std::is_void_v<value_type>)
+                        {
+                            state_next->SetValue();
+                        }
+                        else
+                        {
+                            state_next->SetValue(state_inner->GetValue());
+                        }
+                    });
+                }
+                else if constexpr (std::is_void_v<T>)
+                {
+                    state_next->Run(function);
+                }
+                else
+                {
+                    const T& value = state->GetValue();
+                    state_next->Run(function, value);
+                }
+            }, nullptr, lane);
+        });
+
+        return typename continuation_future<T, std::decay_t<Function>>::type(state_next);
+    }
 }
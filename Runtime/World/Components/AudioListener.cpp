@@ -29,6 +29,7 @@ namespace Genome
 {
     AudioListener::AudioListener(Context* context, Entity* entity, uint32_t id /*= 0*/) : IComponent(context, entity, id)
     {
+        m_tickable = true;
         m_audio = nullptr;
     }
 
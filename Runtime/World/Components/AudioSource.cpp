@@ -36,6 +36,8 @@ namespace Genome
 {
     AudioSource::AudioSource(Context* context, Entity* entity, uint32_t id /*= 0*/) : IComponent(context, entity, id)
     {
+        m_tickable = true;
+
         m_mute                = false;
         m_play_on_start        = true;
         m_loop                = false;
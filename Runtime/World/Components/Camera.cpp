@@ -39,6 +39,7 @@ namespace Genome
 {
     Camera::Camera(Context* context, Entity* entity, uint32_t id /*= 0*/) : IComponent(context, entity, id)
     {   
+        m_tickable = true;
         m_renderer  = m_context->GetSubsystem<Renderer>();
         m_input     = m_context->GetSubsystem<Input>();
     }
@@ -0,0 +1,124 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =============
+#include "Spartan.h"
+#include "ComponentPool.h"
+#include "IComponent.h"
+//========================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Genome
+{
+    ComponentPool::~ComponentPool()
+    {
+        for (void* chunk : m_chunks)
+        {
+            ::operator delete(chunk);
+        }
+    }
+
+    void* ComponentPool::Allocate(const size_t size)
+    {
+        lock_guard<mutex> lock(m_mutex);
+
+        // Every allocation is a component of the same type along with its control block, so the size is always the same
+        if (m_element_size == 0)
+        {
+            const size_t alignment  = alignof(max_align_t);
+            m_element_size          = (size + alignment - 1) / alignment * alignment;
+        }
+        SP_ASSERT(size <= m_element_size);
+
+        if (m_free.empty())
+        {
+            uint8_t* chunk = static_cast<uint8_t*>(::operator new(m_element_size * chunk_element_count));
+            m_chunks.emplace_back(chunk);
+
+            // Back to front, so that the chunk is handed out front to back
+            for (uint32_t i = chunk_element_count; i > 0; i--)
+            {
+                m_free.emplace_back(chunk + (i - 1) * m_element_size);
+            }
+        }
+
+        void* memory = m_free.back();
+        m_free.pop_back();
+        return memory;
+    }
+
+    void ComponentPool::Free(void* memory)
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_free.emplace_back(memory);
+    }
+
+    void ComponentPool::Add(IComponent* component)
+    {
+        component->m_pool       = this;
+        component->m_pool_index = static_cast<uint32_t>(m_components.size());
+        m_components.emplace_back(component);
+
+        if (component->IsTickable() && component->IsAwake())
+        {
+            TickAdd(component);
+        }
+    }
+
+    void ComponentPool::Remove(IComponent* component)
+    {
+        component->m_removed = true;
+
+        ComponentPool* pool = component->m_pool;
+        if (!pool)
+            return;
+
+        if (component->IsTickable() && component->IsAwake())
+        {
+            pool->TickRemove(component);
+        }
+
+        // Swap with the last one, the order doesn't matter
+        IComponent* last                        = pool->m_components.back();
+        last->m_pool_index                      = component->m_pool_index;
+        pool->m_components[last->m_pool_index]  = last;
+        pool->m_components.pop_back();
+
+        component->m_pool = nullptr;
+    }
+
+    void ComponentPool::TickAdd(IComponent* component)
+    {
+        component->m_tick_index = static_cast<uint32_t>(m_components_ticking.size());
+        m_components_ticking.emplace_back(component);
+    }
+
+    void ComponentPool::TickRemove(IComponent* component)
+    {
+        IComponent* last                            = m_components_ticking.back();
+        last->m_tick_index                          = component->m_tick_index;
+        m_components_ticking[last->m_tick_index]    = last;
+        m_components_ticking.pop_back();
+    }
+}
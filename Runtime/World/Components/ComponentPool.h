@@ -0,0 +1,106 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==============================
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "../../Core/Spartan_Definitions.h"
+//=========================================
+
+namespace Genome
+{
+    class IComponent;
+
+    // The components of one type. Their memory (along with the shared_ptr control block) comes from chunks, so components of a type
+    // sit next to each other instead of wherever the heap puts them, and the pool lists the live ones, so that a system can visit
+    // every component of a type without going through the entities.
+    class GENOME_CLASS ComponentPool
+    {
+    public:
+        ComponentPool() = default;
+        ~ComponentPool();
+        ComponentPool(const ComponentPool&) = delete;
+        ComponentPool& operator=(const ComponentPool&) = delete;
+
+        // Memory for one component, a pool only ever hands out one size. Can be called from any thread.
+        void* Allocate(size_t size);
+        void Free(void* memory);
+
+        // The components which belong to an entity, in no particular order. Removing goes through the pool the component was added to.
+        void Add(IComponent* component);
+        static void Remove(IComponent* component);
+        const std::vector<IComponent*>& GetComponents() const { return m_components; }
+
+        // The ones which are tickable and awake
+        const std::vector<IComponent*>& GetComponentsTicking() const { return m_components_ticking; }
+
+    private:
+        friend class IComponent;
+
+        void TickAdd(IComponent* component);
+        void TickRemove(IComponent* component);
+
+        static const uint32_t chunk_element_count = 256;
+
+        std::vector<void*> m_chunks;
+        std::vector<void*> m_free;
+        size_t m_element_size = 0;
+        std::mutex m_mutex;
+
+        std::vector<IComponent*> m_components;
+        std::vector<IComponent*> m_components_ticking;
+    };
+
+    // Lets std::allocate_shared place a component in a pool, the control block holds on to the pool so it outlives the component
+    template <typename T>
+    class ComponentAllocator
+    {
+    public:
+        typedef T value_type;
+
+        ComponentAllocator(const std::shared_ptr<ComponentPool>& pool) : m_pool(pool) {}
+
+        template <typename U>
+        ComponentAllocator(const ComponentAllocator<U>& other) : m_pool(other.GetPool()) {}
+
+        T* allocate(const size_t count)
+        {
+            SP_ASSERT(count == 1);
+            return static_cast<T*>(m_pool->Allocate(sizeof(T) * count));
+        }
+
+        void deallocate(T* memory, size_t) { m_pool->Free(memory); }
+
+        const std::shared_ptr<ComponentPool>& GetPool() const { return m_pool; }
+
+        template <typename U>
+        bool operator==(const ComponentAllocator<U>& other) const { return m_pool == other.GetPool(); }
+
+        template <typename U>
+        bool operator!=(const ComponentAllocator<U>& other) const { return m_pool != other.GetPool(); }
+
+    private:
+        std::shared_ptr<ComponentPool> m_pool;
+    };
+}
@@ -46,6 +46,11 @@ namespace Genome
         m_constraintForceMixing    = 0.0f;
         m_constraintType           = ConstraintType_Point;
         m_physics                  = GetContext()->GetSubsystem<Physics>();
+        m_deferredConstruction     = false;
+        m_tickable                 = true;
+
+        // Only ticks while its construction is deferred
+        Sleep();
 
         REGISTER_ATTRIBUTE_VALUE_VALUE(m_errorReduction, float);
         REGISTER_ATTRIBUTE_VALUE_VALUE(m_constraintForceMixing, float);
@@ -89,6 +94,11 @@ namespace Genome
         {
             Construct();
         }
+
+        if (!m_deferredConstruction)
+        {
+            Sleep();
+        }
     }
 
     void Constraint::Serialize(FileStream* stream)
@@ -279,6 +289,7 @@ namespace Genome
         {
             LOG_INFO("A RigidBody component is still initializing, deferring construction...");
             m_deferredConstruction = true;
+            Wake();
             return;
         }
         else if (m_deferredConstruction)
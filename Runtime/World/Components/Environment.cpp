@@ -38,6 +38,11 @@ namespace Genome
 {
     Environment::Environment(Context* context, Entity* entity, uint32_t id /*= 0*/) : IComponent(context, entity, id)
     {
+        m_tickable = true;
+
+        // Only ticks while there is a texture to load
+        Sleep();
+
         m_environment_type = Environment_Sphere;
 
         // Default texture paths
@@ -68,9 +73,10 @@ namespace Genome
         m_context->GetSubsystem<Threading>()->AddTask([this]
         {
             SetFromTextureSphere(m_file_paths.front());
-        });
+        }, Task_Lane::Io);
 
         m_is_dirty = false;
+        Sleep();
     }
 
     void Environment::Serialize(FileStream* stream)
@@ -96,12 +102,13 @@ namespace Genome
                 
                 SetFromTextureSphere(m_file_paths.front());
             }
-        });
+        }, Task_Lane::Io);
     }
 
     void Environment::LoadDefault()
     {
         m_is_dirty = true;
+        Wake();
     }
 
     const std::shared_ptr<RHI_Texture>& Environment::GetTexture() const
@@ -36,6 +36,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Transform.h"
 #include "Terrain.h"
 #include "WaterComponent.h"
+#include "ComponentPool.h"
 #include "../Entity.h"
 //========================
 
@@ -49,6 +50,30 @@ namespace Genome
         m_enabled   = true;
     }
 
+    void IComponent::Wake()
+    {
+        if (m_awake)
+            return;
+
+        m_awake = true;
+        if (m_tickable && m_pool)
+        {
+            m_pool->TickAdd(this);
+        }
+    }
+
+    void IComponent::Sleep()
+    {
+        if (!m_awake)
+            return;
+
+        m_awake = false;
+        if (m_tickable && m_pool)
+        {
+            m_pool->TickRemove(this);
+        }
+    }
+
     std::string IComponent::GetEntityName() const
     {
         if (!m_entity)
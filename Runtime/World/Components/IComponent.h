@@ -36,6 +36,7 @@ namespace Genome
     class Transform;
     class Context;
     class FileStream;
+    class ComponentPool;
 
     enum class ComponentType : uint32_t
     {
@@ -80,7 +81,7 @@ namespace Genome
         // Runs when the component is removed
         virtual void OnRemove() {}
 
-        // Runs every frame
+        // Runs every frame, for components which are tickable and awake
         virtual void OnTick(float delta_time) {}
 
         // Runs when the entity is being saved
@@ -94,6 +95,18 @@ namespace Genome
         static constexpr ComponentType TypeToEnum();
         //==========================================
 
+        //= TICKING ==========================================================================================================
+        // The world only ticks the components which are tickable (they say so in their constructor) and only while they are awake.
+        // A component can sleep while it has nothing to do and wake up when that changes.
+        bool IsTickable()                   const { return m_tickable; }
+        bool IsAwake()                      const { return m_awake; }
+        void Wake();
+        void Sleep();
+
+        // Removed from its entity, the world keeps a component which is removed while it ticks alive until it's done ticking
+        bool IsRemoved()                    const { return m_removed; }
+        //====================================================================================================================
+
         //= PROPERTIES ===============================================================================
         Transform* GetTransform()           const { return m_transform; }
         Context* GetContext()               const { return m_context; }
@@ -147,9 +160,20 @@ namespace Genome
         Entity* m_entity        = nullptr;
         // The transform of the component (always exists)
         Transform* m_transform  = nullptr;
+        // Whether the component has anything to do in OnTick(), set by the constructor
+        bool m_tickable         = false;
 
     private:
+        friend class ComponentPool;
+
         // The attributes of the component
         std::vector<Attribute> m_attributes;
+
+        // The pool which lists the component (while its entity has it) and where in the lists it is
+        ComponentPool* m_pool   = nullptr;
+        uint32_t m_pool_index   = 0;
+        uint32_t m_tick_index   = 0;
+        bool m_awake            = true;
+        bool m_removed          = false;
     };
 }
@@ -40,6 +40,8 @@ namespace Genome
 {
     Light::Light(Context* context, Entity* entity, uint32_t id /*= 0*/) : IComponent(context, entity, id)
     {
+        m_tickable = true;
+
         REGISTER_ATTRIBUTE_VALUE_VALUE(m_shadows_enabled, bool);
         REGISTER_ATTRIBUTE_VALUE_VALUE(m_shadows_screen_space_enabled, bool);
         REGISTER_ATTRIBUTE_VALUE_VALUE(m_shadows_transparent_enabled, bool);
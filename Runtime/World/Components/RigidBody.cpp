@@ -74,6 +74,7 @@ namespace Genome
 
     RigidBody::RigidBody(Context* context, Entity* entity, uint32_t id /*= 0*/) : IComponent(context, entity, id)
     {
+        m_tickable          = true;
         m_physics           = GetContext()->GetSubsystem<Physics>();
         m_in_world          = false;
         m_mass              = DEFAULT_MASS;
@@ -31,6 +31,7 @@ namespace Genome
 {
     Script::Script(Context* context, Entity* entity, uint32_t id /*= 0*/) : IComponent(context, entity, id)
     {
+        m_tickable = true;
         m_scripting = context->GetSubsystem<Scripting>();
     }
 
@@ -35,6 +35,7 @@ namespace Genome
 {
     SoftBody::SoftBody(Context* context, Entity* entity, uint32_t id /*= 0*/) : IComponent(context, entity, id)
     {
+        m_tickable = true;
         m_physics = m_context->GetSubsystem<Physics>();
     }
 
@@ -78,7 +78,7 @@ namespace Genome
 
     void Terrain::GenerateAsync()
     {
-        if (m_is_generating)
+        if (IsGenerating())
         {
             LOG_WARNING("Terrain is already being generated, please wait...");
             return;
@@ -98,10 +98,8 @@ namespace Genome
             return;
         }
 
-        m_context->GetSubsystem<Threading>()->AddTask([this]()
+        m_generation = m_context->GetSubsystem<Threading>()->AddTask([this]()
         {
-            m_is_generating = true;
-
             // Get height map data
             const std::vector<std::byte> height_map_data = m_height_map->GetOrLoadMip(0);
             if (height_map_data.empty())
@@ -147,9 +145,7 @@ namespace Genome
             m_progress_jobs_done = 0;
             m_progress_job_count = 1;
             m_progress_desc.clear();
-
-            m_is_generating = false;
-        });
+        }, Task_Lane::Background);
     }
 
     bool Terrain::GeneratePositions(std::vector<Vector3>& positions, const std::vector<std::byte>& height_map)
@@ -374,7 +370,9 @@ namespace Genome
             }
         };
 
-        m_context->GetSubsystem<Threading>()->AddTaskLoop(compute_vertex_normals_tangents, vertex_count);
+        // Every vertex visits every face, so even small chunks carry plenty of work
+        const uint32_t grain = 64;
+        m_context->GetSubsystem<Threading>()->ParallelFor(0, vertex_count, grain, compute_vertex_normals_tangents);
 
         return true;
     }
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "IComponent.h"
 #include <atomic>
 #include "../../RHI/RHI_Definition.h"
+#include "../../Threading/Threading.h"
 //===================================
 
 namespace Genome
@@ -40,7 +41,7 @@ namespace Genome
     {
     public:
         Terrain(Context* context, Entity* entity, uint32_t id = 0);
-        ~Terrain() = default;
+        ~Terrain() { m_generation.Wait(); } // the generation task references this component
 
         //= IComponent ===============================
         void OnInitialize() override;
@@ -61,6 +62,7 @@ namespace Genome
         const auto& GetProgressDescription()  const { return m_progress_desc; }
 
         void GenerateAsync();
+        bool IsGenerating() const { return m_generation.IsValid() && !m_generation.IsReady(); }
 
     private:
         bool GeneratePositions(std::vector<Math::Vector3>& positions, const std::vector<std::byte>& height_map);
@@ -74,7 +76,7 @@ namespace Genome
         float m_min_y                               = 0.0f;
         float m_max_y                               = 30.0f;
         float m_vertex_density                      = 1.0f;
-        std::atomic<bool> m_is_generating           = false;
+        Future<void> m_generation;
         uint64_t m_vertex_count                     = 0;
         uint64_t m_face_count                       = 0;
         std::atomic<uint64_t> m_progress_jobs_done  = 0;
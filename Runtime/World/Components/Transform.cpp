@@ -35,20 +35,20 @@ namespace Genome
 {
     Transform::Transform(Context* context, Entity* entity, uint32_t id /*= 0*/) : IComponent(context, entity, id, this)
     {
-        m_positionLocal    = Vector3::Zero;
-        m_rotationLocal    = Quaternion(0, 0, 0, 1);
-        m_scaleLocal       = Vector3::One;
-        m_matrix           = Matrix::Identity;
-        m_matrixLocal      = Matrix::Identity;
+        m_store            = context->GetSubsystem<World>()->GetTransformStore();
+        m_index            = m_store->Allocate();
         m_matrix_previous  = Matrix::Identity;
         m_parent           = nullptr;
 
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_positionLocal, Vector3);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_rotationLocal, Quaternion);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_scaleLocal,    Vector3);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_matrix,        Matrix);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_matrixLocal,   Matrix);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_lookAt,        Vector3);
+        REGISTER_ATTRIBUTE_GET_SET(GetPositionLocal, SetPositionLocal, Vector3);
+        REGISTER_ATTRIBUTE_GET_SET(GetRotationLocal, SetRotationLocal, Quaternion);
+        REGISTER_ATTRIBUTE_GET_SET(GetScaleLocal,    SetScaleLocal,    Vector3);
+        REGISTER_ATTRIBUTE_VALUE_VALUE(m_lookAt,     Vector3);
+    }
+
+    Transform::~Transform()
+    {
+        m_store->Free(m_index);
     }
 
     void Transform::OnInitialize()
@@ -58,19 +58,25 @@ namespace Genome
 
     void Transform::Serialize(FileStream* stream)
     {
-        stream->Write(m_positionLocal);
-        stream->Write(m_rotationLocal);
-        stream->Write(m_scaleLocal);
+        stream->Write(GetPositionLocal());
+        stream->Write(GetRotationLocal());
+        stream->Write(GetScaleLocal());
         stream->Write(m_lookAt);
         stream->Write(m_parent ? m_parent->GetEntity()->GetId() : 0);
     }
 
     void Transform::Deserialize(FileStream* stream)
     {
-        stream->Read(&m_positionLocal);
-        stream->Read(&m_rotationLocal);
-        stream->Read(&m_scaleLocal);
+        Vector3 position;
+        Quaternion rotation;
+        Vector3 scale;
+        stream->Read(&position);
+        stream->Read(&rotation);
+        stream->Read(&scale);
         stream->Read(&m_lookAt);
+        m_store->SetPositionLocal(m_index, position);
+        m_store->SetRotationLocal(m_index, rotation);
+        m_store->SetScaleLocal(m_index, scale);
         uint32_t parententity_id = 0;
         stream->Read(&parententity_id);
 
@@ -87,24 +93,37 @@ namespace Genome
 
     void Transform::UpdateTransform()
     {
-        // Compute local transform
-        m_matrixLocal = Matrix(m_positionLocal, m_rotationLocal, m_scaleLocal);
+        // A dirty transform has a dirty subtree already, so moving it again costs nothing
+        if (m_store->IsDirty(m_index))
+            return;
 
-        // Compute world transform
-        if (!HasParent())
-        {
-            m_matrix = m_matrixLocal;
-        }
-        else
+        MarkDirty();
+    }
+
+    void Transform::MarkDirty()
+    {
+        m_store->MarkDirty(m_index);
+
+        // Dirty children have dirty descendants, so there is no need to go any further
+        for (Transform* child : m_children)
         {
-            m_matrix = m_matrixLocal * GetParentTransformMatrix();
+            if (!m_store->IsDirty(child->m_index))
+            {
+                child->MarkDirty();
+            }
         }
-        
-        // Update children
-        for (const auto& child : m_children)
+    }
+
+    void Transform::OnParentChanged()
+    {
+        // The store sorts by depth, which the descendants inherit
+        m_store->SetParent(m_index, m_parent ? m_parent->m_index : TransformStore::invalid);
+        for (Transform* child : m_children)
         {
-            child->UpdateTransform();
+            child->OnParentChanged();
         }
+
+        UpdateTransform();
     }
 
     void Transform::SetPosition(const Vector3& position)
@@ -117,10 +136,10 @@ namespace Genome
 
     void Transform::SetPositionLocal(const Vector3& position)
     {
-        if (m_positionLocal == position)
+        if (GetPositionLocal() == position)
             return;
 
-        m_positionLocal = position;
+        m_store->SetPositionLocal(m_index, position);
         UpdateTransform();
     }
 
@@ -134,10 +153,10 @@ namespace Genome
 
     void Transform::SetRotationLocal(const Quaternion& rotation)
     {
-        if (m_rotationLocal == rotation)
+        if (GetRotationLocal() == rotation)
             return;
 
-        m_rotationLocal = rotation;
+        m_store->SetRotationLocal(m_index, rotation);
         UpdateTransform();
     }
 
@@ -151,16 +170,16 @@ namespace Genome
 
     void Transform::SetScaleLocal(const Vector3& scale)
     {
-        if (m_scaleLocal == scale)
+        if (GetScaleLocal() == scale)
             return;
 
-        m_scaleLocal = scale;
-
         // A scale of 0 will cause a division by zero when decomposing the world transform matrix.
-        m_scaleLocal.x = (m_scaleLocal.x == 0.0f) ? EPSILON : m_scaleLocal.x;
-        m_scaleLocal.y = (m_scaleLocal.y == 0.0f) ? EPSILON : m_scaleLocal.y;
-        m_scaleLocal.z = (m_scaleLocal.z == 0.0f) ? EPSILON : m_scaleLocal.z;
+        Vector3 scale_local = scale;
+        scale_local.x = (scale_local.x == 0.0f) ? EPSILON : scale_local.x;
+        scale_local.y = (scale_local.y == 0.0f) ? EPSILON : scale_local.y;
+        scale_local.z = (scale_local.z == 0.0f) ? EPSILON : scale_local.z;
 
+        m_store->SetScaleLocal(m_index, scale_local);
         UpdateTransform();
     }
 
@@ -168,11 +187,11 @@ namespace Genome
     {
         if (!HasParent())
         {
-            SetPositionLocal(m_positionLocal + delta);
+            SetPositionLocal(GetPositionLocal() + delta);
         }
         else
         {
-            SetPositionLocal(m_positionLocal + GetParent()->GetMatrix().Inverted() * delta);
+            SetPositionLocal(GetPositionLocal() + GetParent()->GetMatrix().Inverted() * delta);
         }
     }
 
@@ -180,11 +199,11 @@ namespace Genome
     {
         if (!HasParent())
         {
-            SetRotationLocal((m_rotationLocal * delta).Normalized());
+            SetRotationLocal((GetRotationLocal() * delta).Normalized());
         }
         else
         {
-            SetRotationLocal(m_rotationLocal * GetRotation().Inverse() * delta * GetRotation());
+            SetRotationLocal(GetRotationLocal() * GetRotation().Inverse() * delta * GetRotation());
         }    
     }
 
@@ -222,11 +241,14 @@ namespace Genome
         // if the new parent is a descendant of this transform
         if (new_parent->IsDescendantOf(this))
         {
+            // the children remove themselves from m_children as they switch, so iterate over a copy
+            const std::vector<Transform*> children = m_children;
+
             // if this transform already has a parent
             if (this->HasParent())
             {
                 // assign the parent of this transform to the children
-                for (const auto& child : m_children)
+                for (const auto& child : children)
                 {
                     child->SetParent(GetParent());
                 }
@@ -234,25 +256,29 @@ namespace Genome
             else // if this transform doesn't have a parent
             {
                 // make the children orphans
-                for (const auto& child : m_children)
+                for (const auto& child : children)
                 {
                     child->BecomeOrphan();
                 }
             }
         }
 
-        // Switch parent but keep a pointer to the old one
-        auto parent_old = m_parent;
+        // Switch parent, the old one forgets about this child and the new one learns about it
+        const bool was_root = !m_parent;
+        if (m_parent)
+        {
+            m_parent->RemoveChild(this);
+        }
         m_parent = new_parent;
-        if (parent_old) parent_old->AcquireChildren(); // update the old parent (so it removes this child)
+        m_parent->m_children.emplace_back(this);
 
-        // make the new parent "aware" of this transform/child
-        if (m_parent)
+        // The world keeps track of the roots
+        if (was_root)
         {
-            m_parent->AcquireChildren();
+            GetContext()->GetSubsystem<World>()->OnEntityParentChanged(GetEntity());
         }
 
-        UpdateTransform();
+        OnParentChanged();
     }
 
     void Transform::AddChild(Transform* child)
@@ -296,50 +322,22 @@ namespace Genome
         return nullptr;
     }
 
-    // Searches the entire hierarchy, finds any children and saves them in m_children.
-    // This is a recursive function, the children will also find their own children and so on...
-    void Transform::AcquireChildren()
+    void Transform::RemoveChild(const Transform* child)
     {
-        m_children.clear();
-        m_children.shrink_to_fit();
-
-        auto entities = GetContext()->GetSubsystem<World>()->EntityGetAll();
-        for (const auto& entity : entities)
+        const auto it = std::find(m_children.begin(), m_children.end(), child);
+        if (it != m_children.end())
         {
-            if (!entity)
-                continue;
-
-            // get the possible child
-            auto possible_child = entity->GetTransform();
-
-            // if it doesn't have a parent, forget about it.
-            if (!possible_child->HasParent())
-                continue;
-
-            // if it's parent matches this transform
-            if (possible_child->GetParent()->GetId() == GetId())
-            {
-                // welcome home son
-                m_children.emplace_back(possible_child);
-
-                // make the child do the same thing all over, essentially resolving the entire hierarchy.
-                possible_child->AcquireChildren();
-            }
+            m_children.erase(it);
         }
     }
 
     bool Transform::IsDescendantOf(const Transform* transform) const
     {
-        for (const Transform* child : transform->GetChildren())
+        // Walk up the parents, that is as deep as the hierarchy rather than as big as the subtree
+        for (const Transform* parent = m_parent; parent; parent = parent->m_parent)
         {
-            if (GetId() == child->GetId())
+            if (parent == transform)
                 return true;
-
-            if (child->HasChildren())
-            {
-                if (IsDescendantOf(child))
-                    return true;
-            }
         }
 
         return false;
@@ -370,21 +368,14 @@ namespace Genome
         if (!m_parent)
             return;
 
-        // create a temporary reference to the parent
-        auto temp_ref = m_parent;
-
-        // delete the original reference
+        // make the parent forget about this child
+        m_parent->RemoveChild(this);
         m_parent = nullptr;
 
         // Update the transform without the parent now
-        UpdateTransform();
+        OnParentChanged();
 
-        // make the parent search for children,
-        // that's indirect way of making the parent "forget"
-        // about this child, since it won't be able to find it
-        if (temp_ref)
-        {
-            temp_ref->AcquireChildren();
-        }
+        // The world keeps track of the roots
+        GetContext()->GetSubsystem<World>()->OnEntityParentChanged(GetEntity());
     }
 }
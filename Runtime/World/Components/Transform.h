@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Math/Vector3.h"
 #include "../../Math/Quaternion.h"
 #include "../../Math/Matrix.h"
+#include "../TransformStore.h"
 //================================
 
 using namespace Genome::Math;
@@ -40,7 +41,7 @@ namespace Genome
     {
     public:
         Transform(Context* context, Entity* entity, uint32_t id = 0);
-        ~Transform() = default;
+        ~Transform();
 
         //= ICOMPONENT ===============================
         void OnInitialize()                  override;
@@ -48,25 +49,27 @@ namespace Genome
         void Deserialize(FileStream* stream) override;
         //============================================
 
+        // Marks this transform and its descendants as changed, their matrices are resolved when they are read, or by World::TransformsResolve()
+        // (before the audio and the renderer tick, and after the world does). Reading them from several threads at once while they are dirty is a race.
         void UpdateTransform();
 
         //= POSITION ==============================================================
-        Vector3 GetPosition()             const { return m_matrix.GetTranslation(); }
-        const auto& GetPositionLocal()    const { return m_positionLocal; }
+        Vector3 GetPosition()             const { return GetMatrix().GetTranslation(); }
+        const auto& GetPositionLocal()    const { return m_store->GetPositionLocal(m_index); }
         void SetPosition(const Vector3& position);
         void SetPositionLocal(const Vector3& position);
         //=========================================================================
 
         //= ROTATION ===========================================================
-        Quaternion GetRotation()          const { return m_matrix.GetRotation(); }
-        const auto& GetRotationLocal()    const { return m_rotationLocal; }
+        Quaternion GetRotation()          const { return GetMatrix().GetRotation(); }
+        const auto& GetRotationLocal()    const { return m_store->GetRotationLocal(m_index); }
         void SetRotation(const Quaternion& rotation);
         void SetRotationLocal(const Quaternion& rotation);
         //======================================================================
 
         //= SCALE =======================================================
-        auto GetScale()                   const { return m_matrix.GetScale(); }
-        const auto& GetScaleLocal()       const { return m_scaleLocal; }
+        auto GetScale()                   const { return GetMatrix().GetScale(); }
+        const auto& GetScaleLocal()       const { return m_store->GetScaleLocal(m_index); }
         void SetScale(const Vector3& scale);
         void SetScaleLocal(const Vector3& scale);
         //===============================================================
@@ -99,27 +102,25 @@ namespace Genome
         Transform* GetChildByName(const std::string& name);
         const std::vector<Transform*>& GetChildren()    const { return m_children; }
     
-        void AcquireChildren();
         bool IsDescendantOf(const Transform* transform) const;
         void GetDescendants(std::vector<Transform*>* descendants);
         //======================================================================================
 
         void LookAt(const Vector3& v)                       { m_lookAt = v; }
-        const Matrix& GetMatrix()                     const { return m_matrix; }
-        const Matrix& GetLocalMatrix()                const { return m_matrixLocal; }
+        const Matrix& GetMatrix()                     const { return m_store->GetMatrix(m_index); }
+        const Matrix& GetLocalMatrix()                const { return m_store->GetMatrixLocal(m_index); }
         const Matrix& GetMatrixPrevious()             const { return m_matrix_previous; }
         void SetWvpLastFrame(const Matrix& matrix)          { m_matrix_previous = matrix;}
 
     private:
         Matrix GetParentTransformMatrix() const;
+        void RemoveChild(const Transform* child);
+        void MarkDirty();
+        void OnParentChanged();
 
-        // local
-        Vector3 m_positionLocal;
-        Quaternion m_rotationLocal;
-        Vector3 m_scaleLocal;
-
-        Matrix m_matrix;
-        Matrix m_matrixLocal;
+        // The local values and the matrices live in the store of the world, a dirty transform has dirty descendants
+        std::shared_ptr<TransformStore> m_store;
+        uint32_t m_index = TransformStore::invalid;
         Vector3 m_lookAt;
 
         Transform* m_parent; // the parent of this transform
@@ -53,7 +53,7 @@ namespace Genome
 
     void WaterComponent::GenerateAsync()
     {
-        if (m_is_generating)
+        if (IsGenerating())
         {
             LOG_WARNING("WaterComponent is already being generated, please wait...");
             return;
@@ -73,10 +73,8 @@ namespace Genome
             return;
         }
 
-        m_context->GetSubsystem<Threading>()->AddTask([this]()
+        m_generation = m_context->GetSubsystem<Threading>()->AddTask([this]()
             {
-                m_is_generating = true;
-
                 // Get height map data
                 const std::vector<std::byte> height_map_data = m_height_map->GetOrLoadMip(0);
                 if (height_map_data.empty())
@@ -122,9 +120,7 @@ namespace Genome
                 m_progress_jobs_done = 0;
                 m_progress_job_count = 1;
                 m_progress_desc.clear();
-
-                m_is_generating = false;
-            });
+            }, Task_Lane::Background);
     }
 
     bool WaterComponent::GeneratePositions(std::vector<Vector3>& positions, const std::vector<std::byte>& height_map)
@@ -349,7 +345,9 @@ namespace Genome
             }
         };
 
-        m_context->GetSubsystem<Threading>()->AddTaskLoop(compute_vertex_normals_tangents, vertex_count);
+        // Every vertex visits every face, so even small chunks carry plenty of work
+        const uint32_t grain = 64;
+        m_context->GetSubsystem<Threading>()->ParallelFor(0, vertex_count, grain, compute_vertex_normals_tangents);
 
         return true;
     }
@@ -2,6 +2,7 @@
 #include "IComponent.h"
 #include "..\..\RHI\RHI_Sampler.h"
 #include "..\..\Math\Vector2.h"
+#include "..\..\Threading\Threading.h"
 #include <atomic>
 #include <d3d11.h>
 using namespace Genome::Math;
@@ -38,7 +39,7 @@ namespace Genome
     {
     public:
         WaterComponent(Context* context, Entity* entity, uint32_t id = 0);
-        ~WaterComponent() = default;
+        ~WaterComponent() { m_generation.Wait(); } // the generation task references this component
 
         //= IComponent ===============================
         void OnInitialize() override;
@@ -59,6 +60,7 @@ namespace Genome
         const auto& GetProgressDescription()  const { return m_progress_desc; }
 
         void GenerateAsync();
+        bool IsGenerating() const { return m_generation.IsValid() && !m_generation.IsReady(); }
 
     private:
         bool GeneratePositions(std::vector<Math::Vector3>& positions, const std::vector<std::byte>& height_map);
@@ -72,7 +74,7 @@ namespace Genome
         float m_min_y = 0.0f;
         float m_max_y = 30.0f;
         float m_vertex_density = 1.0f;
-        std::atomic<bool> m_is_generating = false;
+        Future<void> m_generation;
         uint64_t m_vertex_count = 0;
         uint64_t m_face_count = 0;
         std::atomic<uint64_t> m_progress_jobs_done = 0;
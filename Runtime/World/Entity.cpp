@@ -60,15 +60,37 @@ namespace Genome
         m_context               = nullptr;
         m_name.clear();
         m_component_mask = 0;
+        m_components_by_type.fill(nullptr);
         for (auto it = m_components.begin(); it != m_components.end();)
         {
             (*it)->OnRemove();
+            ComponentPool::Remove((*it).get());
             (*it).reset();
             it = m_components.erase(it);
         }
         m_components.clear();
     }
 
+    void Entity::SetName(const std::string& name)
+    {
+        if (m_name == name)
+            return;
+
+        const std::string name_old = m_name;
+        m_name = name;
+        m_context->GetSubsystem<World>()->OnEntityNameChanged(this, name_old);
+    }
+
+    void Entity::SetId(const uint32_t id)
+    {
+        if (m_id == id)
+            return;
+
+        const uint32_t id_old = m_id;
+        m_id = id;
+        m_context->GetSubsystem<World>()->OnEntityIdChanged(this, id_old);
+    }
+
     void Entity::Clone()
     {
         auto scene = m_context->GetSubsystem<World>();
@@ -144,7 +166,10 @@ namespace Genome
         // call component Update()
         for (const auto& component : m_components)
         {
-            component->OnTick(delta_time);
+            if (component->IsTickable() && component->IsAwake())
+            {
+                component->OnTick(delta_time);
+            }
         }
     }
 
@@ -208,8 +233,8 @@ namespace Genome
         {
             stream->Read(&m_is_active);
             stream->Read(&m_hierarchy_visibility);
-            stream->Read(&m_id);
-            stream->Read(&m_name);
+            SetId(stream->ReadAs<uint32_t>());
+            SetName(stream->ReadAs<std::string>());
         }
 
         // COMPONENTS
@@ -261,11 +286,6 @@ namespace Genome
             {
                 child.lock()->Deserialize(stream, GetTransform());
             }
-
-            if (m_transform)
-            {
-                m_transform->AcquireChildren();
-            }
         }
 
         // Make the scene resolve
@@ -299,6 +319,20 @@ namespace Genome
         return nullptr;
     }
 
+    const std::shared_ptr<ComponentPool>& Entity::GetComponentPool(const ComponentType type) const
+    {
+        return m_context->GetSubsystem<World>()->GetComponentPool(type);
+    }
+
+    void Entity::ComponentRemove(const std::shared_ptr<IComponent>& component)
+    {
+        component->OnRemove();
+        ComponentPool::Remove(component.get());
+
+        // The world might be ticking it, or about to
+        m_context->GetSubsystem<World>()->OnComponentRemoved(component);
+    }
+
     void Entity::RemoveComponentById(const uint32_t id)
     {
         ComponentType component_type = ComponentType::Unknown;
@@ -309,7 +343,7 @@ namespace Genome
             if (id == component->GetId())
             {
                 component_type = component->GetType();
-                component->OnRemove();
+                ComponentRemove(component);
                 it = m_components.erase(it);    
                 break;
             }
@@ -321,15 +355,19 @@ namespace Genome
 
         // The script component can have multiple instance, so only remove
         // it's flag if there are no more components of that type left
-        bool others_of_same_type_exist = false;
-        for (auto it = m_components.begin(); it != m_components.end(); ++it)
+        if (component_type != ComponentType::Unknown)
         {
-            others_of_same_type_exist = ((*it)->GetType() == component_type) ? true : others_of_same_type_exist;
-        }
+            IComponent* other_of_same_type = nullptr;
+            for (auto it = m_components.begin(); it != m_components.end() && !other_of_same_type; ++it)
+            {
+                other_of_same_type = ((*it)->GetType() == component_type) ? (*it).get() : nullptr;
+            }
 
-        if (!others_of_same_type_exist)
-        {
-            m_component_mask &= ~GetComponentMask(component_type);
+            m_components_by_type[static_cast<uint32_t>(component_type)] = other_of_same_type;
+            if (!other_of_same_type)
+            {
+                m_component_mask &= ~GetComponentMask(component_type);
+            }
         }
 
         // Make the scene resolve
@@ -22,9 +22,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES =====================
+#include <array>
 #include <vector>
 #include "../Core/EventSystem.h"
 #include "Components/IComponent.h"
+#include "Components/ComponentPool.h"
 //================================
 
 namespace Genome
@@ -48,7 +50,10 @@ namespace Genome
 
         //= PROPERTIES ===================================================================================================
         const std::string& GetName() const                              { return m_name; }
-        void SetName(const std::string& name)                           { m_name = name; }
+        void SetName(const std::string& name);
+
+        // Hides SpartanObject::SetId(), the world looks entities up by id
+        void SetId(uint32_t id);
 
         bool IsActive() const                                           { return m_is_active; }
         void SetActive(const bool active)                               { m_is_active = active; }
@@ -67,12 +72,18 @@ namespace Genome
             if (HasComponent(type) && type != ComponentType::Script)
                 return GetComponent<T>();
 
-            // Create a new component
-            std::shared_ptr<T> component = std::make_shared<T>(m_context, this, id);
+            // Create a new component, in the pool of its type
+            const std::shared_ptr<ComponentPool>& pool = GetComponentPool(type);
+            std::shared_ptr<T> component = std::allocate_shared<T>(ComponentAllocator<T>(pool), m_context, this, id);
 
             // Save new component
             m_components.emplace_back(std::static_pointer_cast<IComponent>(component));
             m_component_mask |= GetComponentMask(type);
+            if (!m_components_by_type[static_cast<uint32_t>(type)])
+            {
+                m_components_by_type[static_cast<uint32_t>(type)] = component.get();
+            }
+            pool->Add(component.get());
 
             // Caching of rendering performance critical components
             if constexpr (std::is_same<T, Transform>::value)    { m_transform   = static_cast<Transform*>(component.get()); }
@@ -100,13 +111,8 @@ namespace Genome
             if (!HasComponent(type))
                 return nullptr;
 
-            for (const auto& component : m_components)
-            {
-                if (component->GetType() == type)
-                    return static_cast<T*>(component.get());
-            }
-
-            return nullptr;
+            // The first component of each type is kept by type, so there is nothing to search for
+            return static_cast<T*>(m_components_by_type[static_cast<uint32_t>(type)]);
         }
 
         // Returns any components of type T (if they exist)
@@ -148,9 +154,10 @@ namespace Genome
                 auto component = *it;
                 if (component->GetType() == type)
                 {
-                    component->OnRemove();
+                    ComponentRemove(component);
                     it = m_components.erase(it);
                     m_component_mask &= ~GetComponentMask(type);
+                    m_components_by_type[static_cast<uint32_t>(type)] = nullptr;
                 }
                 else
                 {
@@ -174,7 +181,11 @@ namespace Genome
         std::shared_ptr<Entity> GetPtrShared()  { return shared_from_this(); }
 
     private:
+        friend class World;
+
         constexpr uint32_t GetComponentMask(ComponentType type) { return static_cast<uint32_t>(1) << static_cast<uint32_t>(type); }
+        const std::shared_ptr<ComponentPool>& GetComponentPool(ComponentType type) const;
+        void ComponentRemove(const std::shared_ptr<IComponent>& component);
 
         std::string m_name          = "Entity";
         bool m_is_active            = true;
@@ -182,9 +193,11 @@ namespace Genome
         Transform* m_transform      = nullptr;
         Renderable* m_renderable    = nullptr;
         bool m_destruction_pending  = false;
+        bool m_is_listed_root       = false; // in the roots of the world, the entry can be stale (see World::EntityRootsCompact)
         
         // Components
         std::vector<std::shared_ptr<IComponent>> m_components;
+        std::array<IComponent*, static_cast<uint32_t>(ComponentType::Unknown)> m_components_by_type = {}; // the first of each type
         uint32_t m_component_mask = 0;
     };
 }
@@ -0,0 +1,55 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==================
+#include "Spartan.h"
+#include "TransformResolver.h"
+#include "World.h"
+//=============================
+
+namespace Genome
+{
+    TransformResolver::TransformResolver(Context* context) : ISubsystem(context)
+    {
+
+    }
+
+    void TransformResolver::Tick(float delta_time)
+    {
+        // The world is registered after this step, so it's only looked up once everything is
+        if (!m_world)
+        {
+            m_world = m_context->GetSubsystem<World>();
+        }
+
+        m_world->TransformsResolve();
+    }
+
+    TickDependencies TransformResolver::GetTickDependencies() const
+    {
+        // Waits for whatever writes the world (physics), subsystems which read transforms wait for it by reading Tick_Resource_Transforms
+        TickDependencies dependencies;
+        dependencies.reads          = Tick_Resource_World;
+        dependencies.writes         = Tick_Resource_Transforms;
+        dependencies.main_thread    = false;
+        return dependencies;
+    }
+}
@@ -0,0 +1,50 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include "../Core/ISubsystem.h"
+//=============================
+
+namespace Genome
+{
+    class World;
+
+    // Resolves the transforms which changed before the subsystems which read them concurrently tick (the audio on a worker thread,
+    // the renderer on the main thread). Reading a dirty transform resolves it, which is a write, so without this step they would race.
+    // Transforms are written by physics before this step and by the world (which resolves them itself) after it.
+    class TransformResolver : public ISubsystem
+    {
+    public:
+        TransformResolver(Context* context);
+        ~TransformResolver() = default;
+
+        //= Subsystem =================================================================
+        void Tick(float delta_time) override;
+        TickDependencies GetTickDependencies() const override;
+        InitDependencies GetInitDependencies() const override { return InitAfter<>(); }
+        //=============================================================================
+
+    private:
+        World* m_world = nullptr;
+    };
+}
@@ -0,0 +1,213 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ======================
+#include "Spartan.h"
+#include "TransformStore.h"
+#include "../Threading/Threading.h"
+#include <xmmintrin.h>
+//=================================
+
+//= NAMESPACES ==============
+using namespace std;
+using namespace Genome::Math;
+//===========================
+
+namespace Genome
+{
+    // Depths with fewer slots than this are resolved by the calling thread, splitting them costs more than it saves
+    static const uint32_t resolve_parallel_min   = 8192;
+    static const uint32_t resolve_parallel_grain = 1024;
+
+    // result = local * parent. Matrices are stored a column at a time, so each column of the result
+    // is the columns of local weighted by the elements of the same column of parent.
+    static void matrix_multiply(const Matrix& local, const Matrix& parent, Matrix* result)
+    {
+        const float* l  = local.Data();
+        const float* p  = parent.Data();
+        float* r        = &result->m00;
+
+        const __m128 l0 = _mm_loadu_ps(l + 0);
+        const __m128 l1 = _mm_loadu_ps(l + 4);
+        const __m128 l2 = _mm_loadu_ps(l + 8);
+        const __m128 l3 = _mm_loadu_ps(l + 12);
+
+        for (uint32_t column = 0; column < 4; column++)
+        {
+            const float* p_column = p + column * 4;
+            __m128 value = _mm_mul_ps(l0, _mm_set1_ps(p_column[0]));
+            value        = _mm_add_ps(value, _mm_mul_ps(l1, _mm_set1_ps(p_column[1])));
+            value        = _mm_add_ps(value, _mm_mul_ps(l2, _mm_set1_ps(p_column[2])));
+            value        = _mm_add_ps(value, _mm_mul_ps(l3, _mm_set1_ps(p_column[3])));
+            _mm_storeu_ps(r + column * 4, value);
+        }
+    }
+
+    uint32_t TransformStore::Allocate()
+    {
+        uint32_t index = invalid;
+        if (!m_free.empty())
+        {
+            index = m_free.back();
+            m_free.pop_back();
+        }
+        else
+        {
+            SP_ASSERT(m_count < block_size * block_count_max);
+
+            index = m_count++;
+            if (!m_blocks[index / block_size])
+            {
+                m_blocks[index / block_size] = make_unique<Block>();
+            }
+        }
+
+        Block& block                = GetBlock(index);
+        const uint32_t slot         = GetSlot(index);
+        block.position_local[slot]  = Vector3::Zero;
+        block.rotation_local[slot]  = Quaternion::Identity;
+        block.scale_local[slot]     = Vector3::One;
+        block.matrix_local[slot]    = Matrix::Identity;
+        block.matrix[slot]          = Matrix::Identity;
+        block.parent[slot]          = invalid;
+        block.depth[slot]           = 0;
+        block.dirty[slot]           = 0;
+        m_order_dirty               = true;
+
+        return index;
+    }
+
+    void TransformStore::Free(const uint32_t index)
+    {
+        Block& block        = GetBlock(index);
+        const uint32_t slot = GetSlot(index);
+        block.parent[slot]  = invalid;
+        block.depth[slot]   = invalid;
+        block.dirty[slot]   = 0;
+        m_free.emplace_back(index);
+        m_order_dirty       = true;
+    }
+
+    void TransformStore::SetParent(const uint32_t index, const uint32_t index_parent)
+    {
+        Block& block        = GetBlock(index);
+        const uint32_t slot = GetSlot(index);
+        block.parent[slot]  = index_parent;
+        block.depth[slot]   = index_parent != invalid ? GetBlock(index_parent).depth[GetSlot(index_parent)] + 1 : 0;
+        m_order_dirty       = true;
+    }
+
+    void TransformStore::ResolveSlot(const uint32_t index)
+    {
+        Block& block                = GetBlock(index);
+        const uint32_t slot         = GetSlot(index);
+        const uint32_t index_parent = block.parent[slot];
+
+        block.matrix_local[slot] = Matrix(block.position_local[slot], block.rotation_local[slot], block.scale_local[slot]);
+        if (index_parent != invalid)
+        {
+            matrix_multiply(block.matrix_local[slot], GetMatrix(index_parent), &block.matrix[slot]);
+        }
+        else
+        {
+            block.matrix[slot] = block.matrix_local[slot];
+        }
+
+        block.dirty[slot] = 0;
+    }
+
+    void TransformStore::Resolve(Threading* threading)
+    {
+        if (!m_has_dirty)
+            return;
+
+        if (m_order_dirty)
+        {
+            SortByDepth();
+        }
+
+        // Every parent is one depth above its children, so by the time a depth is resolved, all of its parents are
+        const auto resolve_range = [this](const uint32_t begin, const uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const uint32_t index = m_order[i];
+                if (IsDirty(index))
+                {
+                    ResolveSlot(index);
+                }
+            }
+        };
+
+        for (size_t depth = 0; depth + 1 < m_depth_offsets.size(); depth++)
+        {
+            const uint32_t begin    = m_depth_offsets[depth];
+            const uint32_t end      = m_depth_offsets[depth + 1];
+
+            if (threading && end - begin >= resolve_parallel_min)
+            {
+                threading->ParallelFor(begin, end, resolve_parallel_grain, resolve_range);
+            }
+            else
+            {
+                resolve_range(begin, end);
+            }
+        }
+
+        m_has_dirty = false;
+    }
+
+    void TransformStore::SortByDepth()
+    {
+        // A counting sort, one pass counts the slots at each depth and another places them
+        m_depth_offsets.clear();
+        for (uint32_t index = 0; index < m_count; index++)
+        {
+            const uint32_t depth = GetBlock(index).depth[GetSlot(index)];
+            if (depth == invalid)
+                continue;
+
+            if (depth + 2 > m_depth_offsets.size())
+            {
+                m_depth_offsets.resize(depth + 2, 0);
+            }
+            m_depth_offsets[depth + 1]++;
+        }
+
+        for (size_t depth = 1; depth < m_depth_offsets.size(); depth++)
+        {
+            m_depth_offsets[depth] += m_depth_offsets[depth - 1];
+        }
+
+        m_order.resize(!m_depth_offsets.empty() ? m_depth_offsets.back() : 0);
+        vector<uint32_t> cursors = m_depth_offsets;
+        for (uint32_t index = 0; index < m_count; index++)
+        {
+            const uint32_t depth = GetBlock(index).depth[GetSlot(index)];
+            if (depth != invalid)
+            {
+                m_order[cursors[depth]++] = index;
+            }
+        }
+
+        m_order_dirty = false;
+    }
+}
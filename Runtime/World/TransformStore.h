@@ -0,0 +1,109 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ===========================
+#include <array>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "../Core/Spartan_Definitions.h"
+#include "../Math/Vector3.h"
+#include "../Math/Quaternion.h"
+#include "../Math/Matrix.h"
+//======================================
+
+namespace Genome
+{
+    class Threading;
+
+    // The values of every transform in the world, as a structure of arrays. Transform components are handles (indices) into it.
+    // Slots live in fixed size blocks which never move, so references to them stay valid while transforms are being created.
+    // The world matrices are resolved in one pass over the slots sorted by depth, parents before children, a depth at a time.
+    class GENOME_CLASS TransformStore
+    {
+    public:
+        static constexpr uint32_t invalid = (std::numeric_limits<uint32_t>::max)();
+
+        TransformStore() = default;
+        ~TransformStore() = default;
+        TransformStore(const TransformStore&) = delete;
+        TransformStore& operator=(const TransformStore&) = delete;
+
+        uint32_t Allocate();
+        void Free(uint32_t index);
+
+        //= LOCAL ==================================================================================================================================
+        const Math::Vector3& GetPositionLocal(const uint32_t index)    const { return GetBlock(index).position_local[GetSlot(index)]; }
+        const Math::Quaternion& GetRotationLocal(const uint32_t index) const { return GetBlock(index).rotation_local[GetSlot(index)]; }
+        const Math::Vector3& GetScaleLocal(const uint32_t index)       const { return GetBlock(index).scale_local[GetSlot(index)]; }
+        void SetPositionLocal(const uint32_t index, const Math::Vector3& position)    { GetBlock(index).position_local[GetSlot(index)] = position; }
+        void SetRotationLocal(const uint32_t index, const Math::Quaternion& rotation) { GetBlock(index).rotation_local[GetSlot(index)] = rotation; }
+        void SetScaleLocal(const uint32_t index, const Math::Vector3& scale)          { GetBlock(index).scale_local[GetSlot(index)] = scale; }
+        //==========================================================================================================================================
+
+        // The parent of a root is invalid, the depth is derived from the parent, so a parent has to be set before its children
+        void SetParent(uint32_t index, uint32_t index_parent);
+
+        //= MATRICES ========================================================================================================================================
+        bool IsDirty(const uint32_t index) const { return GetBlock(index).dirty[GetSlot(index)] != 0; }
+        void MarkDirty(const uint32_t index)     { GetBlock(index).dirty[GetSlot(index)] = 1; m_has_dirty = true; }
+        bool HasDirty()                    const { return m_has_dirty; }
+
+        // Resolve on read, along with any dirty parents. That's a write, so slots which are read by several threads at once have to be resolved first.
+        const Math::Matrix& GetMatrix(const uint32_t index)      { if (IsDirty(index)) ResolveSlot(index); return GetBlock(index).matrix[GetSlot(index)]; }
+        const Math::Matrix& GetMatrixLocal(const uint32_t index) { if (IsDirty(index)) ResolveSlot(index); return GetBlock(index).matrix_local[GetSlot(index)]; }
+
+        // Resolves every dirty slot, depths which are wide enough are split across the worker threads
+        void Resolve(Threading* threading);
+        //===================================================================================================================================================
+
+    private:
+        static constexpr uint32_t block_size      = 4096;
+        static constexpr uint32_t block_count_max = 1024;
+
+        struct Block
+        {
+            Math::Vector3 position_local[block_size];
+            Math::Quaternion rotation_local[block_size];
+            Math::Vector3 scale_local[block_size];
+            Math::Matrix matrix_local[block_size];
+            Math::Matrix matrix[block_size];
+            uint32_t parent[block_size];
+            uint32_t depth[block_size]; // invalid for free slots
+            uint8_t dirty[block_size];
+        };
+
+        Block& GetBlock(const uint32_t index)             const { return *m_blocks[index / block_size]; }
+        static uint32_t GetSlot(const uint32_t index)           { return index % block_size; }
+        void ResolveSlot(uint32_t index);
+        void SortByDepth();
+
+        std::array<std::unique_ptr<Block>, block_count_max> m_blocks;
+        uint32_t m_count = 0;                   // slots ever handed out, free ones included
+        std::vector<uint32_t> m_free;
+        std::vector<uint32_t> m_order;          // the slots in use, sorted by depth
+        std::vector<uint32_t> m_depth_offsets;  // where each depth starts in m_order, followed by the end
+        bool m_order_dirty  = false;
+        bool m_has_dirty    = false;
+    };
+}
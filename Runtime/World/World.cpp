@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Spartan.h"
 #include "World.h"
 #include "Entity.h"
+#include "TransformStore.h"
 #include "Components/Transform.h"
 #include "Components/Camera.h"
 #include "Components/Light.h"
@@ -34,6 +35,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Profiling/Profiler.h"
 #include "../Rendering/Renderer.h"
 #include "../Input/Input.h"
+#include "../Threading/Threading.h"
 #include "../RHI/RHI_Device.h"
 //=====================================
 
@@ -43,10 +45,34 @@ using namespace Genome::Math;
 
 namespace Genome
 {
+    // Removes an entity from a lookup, other entities can share the key
+    template <typename Key>
+    static std::shared_ptr<Entity> entity_lookup_erase(std::unordered_multimap<Key, std::shared_ptr<Entity>>& lookup, const Key& key, const Entity* entity)
+    {
+        const auto range = lookup.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second.get() == entity)
+            {
+                std::shared_ptr<Entity> entity_shared = std::move(it->second);
+                lookup.erase(it);
+                return entity_shared;
+            }
+        }
+
+        return nullptr;
+    }
+
     World::World(Context* context) : ISubsystem(context)
     {
+        m_transform_store = std::make_shared<TransformStore>();
+        for (uint32_t i = 0; i < static_cast<uint32_t>(ComponentType::Unknown); i++)
+        {
+            m_component_pools.emplace_back(std::make_shared<ComponentPool>());
+        }
+
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(EventType::WorldResolve, [this](Variant) { m_resolve = true; });
+        SUBSCRIBE_TO_EVENT(EventType::WorldResolve, EVENT_HANDLER_EXPRESSION(m_resolve = true;));
     }
 
     World::~World()
@@ -60,6 +86,8 @@ namespace Genome
         m_input     = m_context->GetSubsystem<Input>();
         m_profiler  = m_context->GetSubsystem<Profiler>();
 
+        m_metric_components_ticked = m_profiler->RegisterGauge("world/components_ticked");
+
         CreateCamera();
         CreateEnvironment();
         CreateDirectionalLight();
@@ -102,13 +130,31 @@ namespace Genome
                 }
             }
 
-            // Tick
-            for (std::shared_ptr<Entity>& entity : m_entities)
+            // Tick, only the components which need it, a type at a time
+            uint32_t ticked_count   = 0;
+            m_is_ticking_components = true;
+            for (const std::shared_ptr<ComponentPool>& pool : m_component_pools)
             {
-                entity->Tick(delta_time);
+                // A tick can wake, sleep, add or remove components, so go over a copy (which keeps its capacity, so this doesn't allocate).
+                // Components which are removed are kept alive until the loop is done, so the copy can tell that they were removed.
+                m_components_tick.assign(pool->GetComponentsTicking().begin(), pool->GetComponentsTicking().end());
+                for (IComponent* component : m_components_tick)
+                {
+                    if (!component->IsRemoved() && component->IsAwake() && component->GetEntity()->IsActive())
+                    {
+                        component->OnTick(delta_time);
+                        ticked_count++;
+                    }
+                }
             }
+            m_is_ticking_components = false;
+            m_components_removed.clear();
+            m_profiler->GaugeSet(m_metric_components_ticked, static_cast<double>(ticked_count));
         }
 
+        // Whatever moved, the renderer (and anything after the world) reads resolved matrices
+        TransformsResolve();
+
         if (m_resolve)
         {
             // Update dirty entities
@@ -165,7 +211,7 @@ namespace Genome
         }
 
         // Only save root entities as they will also save their descendants
-        auto root_actors = EntityGetRoots();
+        const auto& root_actors = EntityGetRoots();
         const auto root_entity_count = static_cast<uint32_t>(root_actors.size());
 
         progress_tracker.SetJobCount(ProgressType::World, root_entity_count);
@@ -198,16 +244,25 @@ namespace Genome
 
     bool World::LoadFromFile(const std::string& file_path)
     {
+        return LoadFromFileAsync(file_path).Get();
+    }
+
+    Future<bool> World::LoadFromFileAsync(const std::string& file_path)
+    {
+        Threading* threading = m_context->GetSubsystem<Threading>();
+        Promise<bool> failed(threading);
+        failed.SetValue(false);
+
         if (!FileSystem::Exists(file_path))
         {
             LOG_ERROR("%s was not found.", file_path.c_str());
-            return false;
+            return failed.GetFuture();
         }
 
         // Open file
-        auto file = std::make_unique<FileStream>(file_path, FileStream_Read);
+        auto file = std::make_shared<FileStream>(file_path, FileStream_Read);
         if (!file->IsOpen())
-            return false;
+            return failed.GetFuture();
 
         // Start progress report and timing
         auto progress_tracker = ProgressTracker::Get();
@@ -231,31 +286,37 @@ namespace Genome
         // Notify subsystems that need to load data
         FIRE_EVENT(EventType::WorldLoad);
 
-        // Load root entity count
-        const uint32_t root_entity_count = file->ReadAs<uint32_t>();
+        // The entities refer to the resources, so they are deserialized once the resources are loaded
+        return m_context->GetSubsystem<ResourceCache>()->LoadResourcesFromFiles().Then([this, file, timer]()
+        {
+            auto progress_tracker = ProgressTracker::Get();
 
-        progress_tracker.SetJobCount(ProgressType::World, root_entity_count);
+            // Load root entity count
+            const uint32_t root_entity_count = file->ReadAs<uint32_t>();
 
-        // Load root entity IDs
-        for (uint32_t i = 0; i < root_entity_count; i++)
-        {
-            std::shared_ptr<Entity> entity = EntityCreate();
-            entity->SetId(file->ReadAs<uint32_t>());
-        }
+            progress_tracker.SetJobCount(ProgressType::World, root_entity_count);
 
-        // Serialize root entities
-        for (uint32_t i = 0; i < root_entity_count; i++)
-        {
-            m_entities[i]->Deserialize(file.get(), nullptr);
-            progress_tracker.IncrementJobsDone(ProgressType::World);
-        }
+            // Load root entity IDs
+            for (uint32_t i = 0; i < root_entity_count; i++)
+            {
+                std::shared_ptr<Entity> entity = EntityCreate();
+                entity->SetId(file->ReadAs<uint32_t>());
+            }
 
-        progress_tracker.SetIsLoading(ProgressType::World, false);
-        LOG_INFO("Loading took %.2f ms", timer.GetElapsedTimeMs());
+            // Serialize root entities
+            for (uint32_t i = 0; i < root_entity_count; i++)
+            {
+                m_entities[i]->Deserialize(file.get(), nullptr);
+                progress_tracker.IncrementJobsDone(ProgressType::World);
+            }
 
-        FIRE_EVENT(EventType::WorldLoaded);
+            progress_tracker.SetIsLoading(ProgressType::World, false);
+            LOG_INFO("Loading took %.2f ms", timer.GetElapsedTimeMs());
 
-        return true;
+            FIRE_EVENT(EventType::WorldLoaded);
+
+            return true;
+        });
     }
 
     bool World::IsLoading()
@@ -272,6 +333,10 @@ namespace Genome
     {
         std::shared_ptr<Entity> entity = m_entities.emplace_back(std::make_shared<Entity>(m_context));
         entity->SetActive(is_active);
+        m_entities_by_id.emplace(entity->GetId(), entity);
+        m_entities_by_name.emplace(entity->GetName(), entity);
+        m_entities_roots.emplace_back(entity);
+        entity->m_is_listed_root = true;
         return entity;
     }
 
@@ -294,89 +359,184 @@ namespace Genome
         m_resolve = true;
     }
 
-    std::vector<std::shared_ptr<Entity>> World::EntityGetRoots()
+    const std::shared_ptr<Entity>& World::EntityGetByName(const std::string& name)
+    {
+        const auto it = m_entities_by_name.find(name);
+        if (it != m_entities_by_name.end())
+            return it->second;
+
+        static std::shared_ptr<Entity> empty;
+        return empty;
+    }
+
+    const std::shared_ptr<Entity>& World::EntityGetById(const uint32_t id)
     {
-        std::vector<std::shared_ptr<Entity>> root_entities;
-        for (const auto& entity : m_entities)
+        const auto it = m_entities_by_id.find(id);
+        if (it != m_entities_by_id.end())
+            return it->second;
+
+        static std::shared_ptr<Entity> empty;
+        return empty;
+    }
+
+    void World::OnEntityIdChanged(Entity* entity, const uint32_t id_old)
+    {
+        // Entities which are not part of the world (yet) are not looked up
+        if (std::shared_ptr<Entity> entity_shared = entity_lookup_erase(m_entities_by_id, id_old, entity))
         {
-            if (entity->GetTransform()->IsRoot())
-            {
-                root_entities.emplace_back(entity);
-            }
+            m_entities_by_id.emplace(entity->GetId(), std::move(entity_shared));
         }
-
-        return root_entities;
     }
 
-    const std::shared_ptr<Entity>& World::EntityGetByName(const std::string& name)
+    const std::vector<IComponent*>& World::ComponentGetAll(const ComponentType type) const
     {
-        for (const auto& entity : m_entities)
+        if (type >= ComponentType::Unknown)
         {
-            if (entity->GetName() == name)
-                return entity;
+            static const std::vector<IComponent*> empty;
+            return empty;
         }
 
-        static std::shared_ptr<Entity> empty;
-        return empty;
+        return m_component_pools[static_cast<uint32_t>(type)]->GetComponents();
     }
 
-    const std::shared_ptr<Entity>& World::EntityGetById(const uint32_t id)
+    const std::shared_ptr<ComponentPool>& World::GetComponentPool(const ComponentType type) const
+    {
+        SP_ASSERT(type < ComponentType::Unknown);
+        return m_component_pools[static_cast<uint32_t>(type)];
+    }
+
+    const std::vector<std::shared_ptr<Entity>>& World::EntityGetRoots()
     {
-        for (const auto& entity : m_entities)
+        EntityRootsCompact();
+        return m_entities_roots;
+    }
+
+    void World::OnEntityParentChanged(Entity* entity)
+    {
+        if (entity->GetTransform()->IsRoot())
+        {
+            // The entity might still be listed from when it was a root before (the entry went stale but wasn't dropped yet),
+            // in which case the entry is valid again
+            if (entity->m_is_listed_root)
+                return;
+
+            // Entities which are not part of the world (yet) are not roots of it
+            const auto range = m_entities_by_id.equal_range(entity->GetId());
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second.get() == entity)
+                {
+                    m_entities_roots.emplace_back(it->second);
+                    entity->m_is_listed_root = true;
+                    break;
+                }
+            }
+        }
+        else
         {
-            if (entity->GetId() == id)
-                return entity;
+            m_entities_roots_dirty = true;
         }
+    }
 
-        static std::shared_ptr<Entity> empty;
-        return empty;
+    void World::OnEntityNameChanged(Entity* entity, const std::string& name_old)
+    {
+        if (std::shared_ptr<Entity> entity_shared = entity_lookup_erase(m_entities_by_name, name_old, entity))
+        {
+            m_entities_by_name.emplace(entity->GetName(), std::move(entity_shared));
+        }
     }
 
     void World::Clear()
     {
+        // Entities are only destroyed outside of the tick loop (EntityRemove() defers it), the loop doesn't keep them alive
+        SP_ASSERT(!m_is_ticking_components);
+
         // Notify any systems that the entities are about to be cleared
         FIRE_EVENT(EventType::WorldClear);
         m_context->GetSubsystem<Renderer>()->Clear();
         m_context->GetSubsystem<ResourceCache>()->Clear();
 
         // Clear the entities
+        m_entities_by_id.clear();
+        m_entities_by_name.clear();
+        m_entities_roots.clear();
+        m_entities_roots_dirty = false;
         m_entities.clear();
 
         m_resolve = true;
     }
 
-    // Removes an entity and all of it's children
+    // Removes an entity and all of it's descendants
     void World::_EntityRemove(const std::shared_ptr<Entity>& entity)
     {
-        // Remove any descendants
-        auto children = entity->GetTransform()->GetChildren();
-        for (const auto& child : children)
+        Transform* transform = entity->GetTransform();
+
+        // Remove any descendants, each one detaches itself from this transform
+        while (transform->HasChildren())
         {
-            EntityRemove(child->GetEntity()->GetPtrShared());
+            _EntityRemove(transform->GetChildren().back()->GetEntity()->GetPtrShared());
         }
 
-        // Keep a reference to it's parent (in case it has one)
-        auto parent = entity->GetTransform()->GetParent();
+        // Remove this entity from the lookups first, so that detaching it from its parent doesn't make it a root
+        entity_lookup_erase(m_entities_by_id, entity->GetId(), entity.get());
+        entity_lookup_erase(m_entities_by_name, entity->GetName(), entity.get());
+        transform->BecomeOrphan();
+
+        // It can be listed even if it wasn't a root, the entry goes stale when a root gets a parent
+        if (entity->m_is_listed_root)
+        {
+            const auto it_root = std::find(m_entities_roots.begin(), m_entities_roots.end(), entity);
+            if (it_root != m_entities_roots.end())
+            {
+                m_entities_roots.erase(it_root);
+            }
+            entity->m_is_listed_root = false;
+        }
 
-        // Remove this entity
         for (auto it = m_entities.begin(); it < m_entities.end();)
         {
-            const auto temp = *it;
-            if (temp->GetId() == entity->GetId())
+            if (*it == entity)
             {
                 it = m_entities.erase(it);
                 break;
             }
             ++it;
         }
+    }
+
+    void World::EntityRootsCompact()
+    {
+        if (!m_entities_roots_dirty)
+            return;
+
+        const auto is_child = [](const std::shared_ptr<Entity>& entity)
+        {
+            const bool child = !entity->GetTransform()->IsRoot();
+            entity->m_is_listed_root = !child;
+            return child;
+        };
+        m_entities_roots.erase(std::remove_if(m_entities_roots.begin(), m_entities_roots.end(), is_child), m_entities_roots.end());
+        m_entities_roots_dirty = false;
+    }
 
-        // If there was a parent, update it
-        if (parent)
+    void World::OnComponentRemoved(const std::shared_ptr<IComponent>& component)
+    {
+        if (m_is_ticking_components)
         {
-            parent->AcquireChildren();
+            m_components_removed.emplace_back(component);
         }
     }
 
+    void World::TransformsResolve()
+    {
+        // Entities are being added by the loading thread
+        if (!m_transform_store->HasDirty() || IsLoading())
+            return;
+
+        SCOPED_TIME_BLOCK(m_profiler);
+        m_transform_store->Resolve(m_context->GetSubsystem<Threading>());
+    }
+
     std::shared_ptr<Entity> World::CreateEnvironment()
     {
         std::shared_ptr<Entity> environment = EntityCreate();
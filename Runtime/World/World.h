@@ -25,16 +25,27 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include "../Core/ISubsystem.h"
 #include "../Core/Spartan_Definitions.h"
+#include "../Profiling/Metrics.h"
 //======================================
 
 namespace Genome
 {
     class Entity;
+    class TransformStore;
+    class IComponent;
+    class ComponentPool;
+    enum class ComponentType : uint32_t;
     class Light;
     class Input;
+    class ResourceCache;
+    class Physics;
+    class Audio;
     class Profiler;
+    template <typename T>
+    class Future;
 
     class GENOME_CLASS World : public ISubsystem
     {
@@ -42,14 +53,17 @@ namespace Genome
         World(Context* context);
         ~World();
 
-        //= ISubsystem ======================
+        //= ISubsystem ========================================================================================================
         bool Initialize() override;
         void Tick(float delta_time) override;
-        //===================================
+        InitDependencies GetInitDependencies() const override { return InitAfter<ResourceCache, Physics, Audio, Input>(true); }
+        //=====================================================================================================================
         
         void New();
         bool SaveToFile(const std::string& filePath);
         bool LoadFromFile(const std::string& file_path);
+        // Loads without blocking, the future holds false if loading failed
+        Future<bool> LoadFromFileAsync(const std::string& file_path);
         const auto& GetName()                       const { return m_name; }
         void Resolve() { m_resolve = true; }
         bool IsLoading();
@@ -58,15 +72,42 @@ namespace Genome
         std::shared_ptr<Entity> EntityCreate(bool is_active = true);
         bool EntityExists(const std::shared_ptr<Entity>& entity);
         void EntityRemove(const std::shared_ptr<Entity>& entity);
-        std::vector<std::shared_ptr<Entity>> EntityGetRoots();
-        const std::shared_ptr<Entity>& EntityGetByName(const std::string& name);
+        const std::vector<std::shared_ptr<Entity>>& EntityGetRoots();
+        const std::shared_ptr<Entity>& EntityGetByName(const std::string& name); // if more than one entity has the name, any of them
         const std::shared_ptr<Entity>& EntityGetById(uint32_t id);
         const auto& EntityGetAll()                  const { return m_entities; }
         //======================================================================
 
+        // Every component of a type, of every entity, in no particular order
+        const std::vector<IComponent*>& ComponentGetAll(ComponentType type) const;
+
+        // Resolves the transforms which changed, so that they can be read from several threads at once.
+        // The world does it after ticking, the TransformResolver before the subsystems which read transforms tick.
+        void TransformsResolve();
+
     private:
+        friend class Entity;
+        friend class Transform;
+
         void Clear();
         void _EntityRemove(const std::shared_ptr<Entity>& entity);
+        void EntityRootsCompact();
+
+        // Called by an entity when its id or name changes, so that the lookups stay up to date
+        void OnEntityIdChanged(Entity* entity, uint32_t id_old);
+        void OnEntityNameChanged(Entity* entity, const std::string& name_old);
+
+        // Called by a transform when it gets its first parent or loses it, so that the roots stay up to date
+        void OnEntityParentChanged(Entity* entity);
+
+        // Called by an entity when it removes a component, which is kept alive if the components are being ticked
+        void OnComponentRemoved(const std::shared_ptr<IComponent>& component);
+
+        // Where the components of each type are allocated and listed
+        const std::shared_ptr<ComponentPool>& GetComponentPool(ComponentType type) const;
+
+        // The values of every transform
+        const std::shared_ptr<TransformStore>& GetTransformStore() const { return m_transform_store; }
 
         //= COMMON ENTITY CREATION ======================
         std::shared_ptr<Entity> CreateEnvironment();
@@ -81,5 +122,22 @@ namespace Genome
         Profiler* m_profiler       = nullptr;
 
         std::vector<std::shared_ptr<Entity>> m_entities;
+
+        // Roots, in the order they became roots. Entities which get a parent are dropped lazily, loading gives most entities a parent
+        // right after creating them (which makes them roots) and searching for each of them would make it quadratic.
+        std::vector<std::shared_ptr<Entity>> m_entities_roots;
+        bool m_entities_roots_dirty = false;
+
+        // Lookups, kept up to date as entities are created, removed, renamed and given new ids
+        std::unordered_multimap<uint32_t, std::shared_ptr<Entity>> m_entities_by_id;
+        std::unordered_multimap<std::string, std::shared_ptr<Entity>> m_entities_by_name;
+
+        // Shared with the transforms and the components, entities can outlive the world
+        std::shared_ptr<TransformStore> m_transform_store;
+        std::vector<std::shared_ptr<ComponentPool>> m_component_pools; // one per component type
+        std::vector<IComponent*> m_components_tick;
+        std::vector<std::shared_ptr<IComponent>> m_components_removed; // while ticking, freed once the tick loop is done
+        bool m_is_ticking_components = false;
+        MetricId m_metric_components_ticked = MetricRegistry::capacity;
     };
 }
@@ -19,10 +19,12 @@
 
 SOLUTION_NAME				= "GenomeGameSDK"
 EDITOR_NAME					= "Editor"
+BENCHMARK_NAME				= "Benchmark"
 RUNTIME_NAME				= "Runtime"
 TARGET_NAME					= "GenomeGameSDK" -- Name of executable
 DEBUG_FORMAT				= "c7"
 EDITOR_DIR					= "../" .. EDITOR_NAME
+BENCHMARK_DIR				= "../" .. BENCHMARK_NAME
 RUNTIME_DIR					= "../" .. RUNTIME_NAME
 IGNORE_FILES				= {}
 ADDITIONAL_INCLUDES			= {}
@@ -205,6 +207,45 @@ project (EDITOR_NAME)
 	-- Libraries
 	libdirs (LIBRARY_DIR)
 
+	-- "Debug"
+	filter "configurations:Debug"
+		targetdir (TARGET_DIR_DEBUG)
+		debugdir (TARGET_DIR_DEBUG)
+		defines { "SP_TRACK_ALLOCATIONS=1" }
+
+	-- "Release"
+	filter "configurations:Release"
+		targetdir (TARGET_DIR_RELEASE)
+		debugdir (TARGET_DIR_RELEASE)
+
+-- Benchmark -----------------------------------------------------------------------------------------------
+project (BENCHMARK_NAME)
+	location (BENCHMARK_DIR)
+	links { RUNTIME_NAME }
+	dependson { RUNTIME_NAME }
+	targetname ( TARGET_NAME .. "_benchmark" )
+	objdir (OBJ_DIR)
+	kind "ConsoleApp"
+	staticruntime "On"
+    if os.target() == "windows" then
+	    conformancemode "On"
+    end
+	defines{ "SPARTAN_BENCHMARK", API_GRAPHICS, "SP_TRACK_ALLOCATIONS=1" }
+
+	-- Files
+	files
+	{
+		BENCHMARK_DIR .. "/**.h",
+		BENCHMARK_DIR .. "/**.cpp"
+	}
+
+	-- Includes
+	includedirs { "../" .. RUNTIME_NAME }
+	includedirs { EDITOR_DIR } -- Window.h
+
+	-- Libraries
+	libdirs (LIBRARY_DIR)
+
 	-- "Debug"
 	filter "configurations:Debug"
 		targetdir (TARGET_DIR_DEBUG)